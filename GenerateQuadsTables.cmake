@@ -0,0 +1,35 @@
+# Generates the C++ source which embeds the quads counting decision tables
+# (resource/pomar/dt-*.dat, 6561 leaves of 9 bytes each) as constant arrays.
+#
+# Usage: cmake -DRESOURCE_DIR=<dir with the .dat files> -DOUTPUT=<generated .cpp> -P GenerateQuadsTables.cmake
+
+set(TABLES
+  "dt-max-tree-4c.dat" "QUADS_DT_MAX_TREE_4C"
+  "dt-max-tree-8c.dat" "QUADS_DT_MAX_TREE_8C"
+  "dt-min-tree-4c.dat" "QUADS_DT_MIN_TREE_4C"
+  "dt-min-tree-8c.dat" "QUADS_DT_MIN_TREE_8C")
+
+set(CONTENT "// Generated by GenerateQuadsTables.cmake from resource/pomar/dt-*.dat. Do not edit.\n")
+set(CONTENT "${CONTENT}#include <pomar/Attribute/QuadsDecisionTables.hpp>\n\nnamespace pomar\n{\n")
+
+list(LENGTH TABLES NUM_ITEMS)
+math(EXPR LAST "${NUM_ITEMS} - 1")
+foreach(I RANGE 0 ${LAST} 2)
+  math(EXPR J "${I} + 1")
+  list(GET TABLES ${I} FILE_NAME)
+  list(GET TABLES ${J} TABLE_NAME)
+
+  file(READ "${RESOURCE_DIR}/${FILE_NAME}" HEX HEX)
+  string(LENGTH "${HEX}" HEX_LENGTH)
+  if(NOT HEX_LENGTH EQUAL 118098)
+    message(FATAL_ERROR "${RESOURCE_DIR}/${FILE_NAME} should have 6561 leaves of 9 bytes.")
+  endif()
+
+  set(BYTE "([0-9a-f][0-9a-f])")
+  string(REGEX REPLACE "${BYTE}${BYTE}${BYTE}${BYTE}${BYTE}${BYTE}${BYTE}${BYTE}${BYTE}"
+    "    {0x\\1,0x\\2,0x\\3,0x\\4,0x\\5,0x\\6,0x\\7,0x\\8,0x\\9},\n" ROWS "${HEX}")
+  set(CONTENT "${CONTENT}  const unsigned char ${TABLE_NAME}[QUADS_DT_LEAVES][QUADS_DT_LEAF_SIZE] = {\n${ROWS}  };\n\n")
+endforeach()
+
+set(CONTENT "${CONTENT}}\n")
+file(WRITE "${OUTPUT}" "${CONTENT}")
@@ -0,0 +1,62 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/Attribute/AttributeComputerQuads.hpp>
+#include <pomar/Attribute/AttributePipeline.hpp>
+
+using namespace pomar;
+
+/* Attributes (area alone, and area with the quads attributes) of the max-tree of
+   a 16-bit noise image (millions of nodes) computed by IncrementalAttributeComputerCollection and 
+   by AttributePipeline (sequentially and with nthreads threads), and the memory taken by the attribute values.
+   Usage: benchPipeline [width] [height] [nthreads (default: hardware threads)] */
+
+int main(int argc, char **argv)
+{
+  using T = unsigned short;
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  const int nthreads = argc > 3 ? std::atoi(argv[3]) : hardwareThreads();
+  auto f = bench::noiseImage<T>(size, 65535);
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder;
+  auto ct = builder.build(meta, f, GridAdjacency8(size.width, size.height), CTBuilder::TreeType::MaxTree);
+  std::cout << "attribute pipeline " << size.width << "x" << size.height << " (" << ct.numberOfNodes() 
+            << " nodes)" << std::endl;
+
+  std::vector<std::shared_ptr<AttributeFromQuadsComputer>> qattrs = {std::make_shared<QArea>(), 
+    std::make_shared<QCArea>(), std::make_shared<QPerimeter>(), std::make_shared<QCPerimeter>(), 
+    std::make_shared<QEulerNumber>()};
+  AreaAttributeComputer<T> area;
+  AttributeComputerQuads<T> quads{QTreeType::MaxTree, QConnectivity::Eight, qattrs};
+
+  auto areaMs = bench::measure([&]() { 
+    IncrementalAttributeComputerCollection<T> collection;
+    collection.push(area.toIncrementalAttributeComputer());
+    collection.compute(ct);
+  });
+  bench::report("area collection", areaMs, size.npixels());
+  auto areaPipeline = makeAttributePipeline(area);
+  bench::report("area pipeline", bench::measure([&]() { areaPipeline.compute(ct); }), size.npixels(), areaMs);
+
+  auto ms = bench::measure([&]() { 
+    IncrementalAttributeComputerCollection<T> collection;
+    collection.push(area.toIncrementalAttributeComputer());
+    collection.push(quads.toIncrementalAttributeComputer());
+    collection.compute(ct);
+  });
+  bench::report("area + quads collection", ms, size.npixels());
+  auto quadsPipeline = makeAttributePipeline(area, quads);
+  bench::report("area + quads pipeline", bench::measure([&]() { quadsPipeline.compute(ct); }), size.npixels(), ms);
+
+  bench::report("area pipeline " + std::to_string(nthreads) + " threads", 
+    bench::measure([&]() { areaPipeline.compute(ct, nthreads); }), size.npixels(), areaMs);
+  bench::report("area + quads pipeline " + std::to_string(nthreads) + " threads", 
+    bench::measure([&]() { quadsPipeline.compute(ct, nthreads); }), size.npixels(), ms);
+
+  auto attrs = quadsPipeline.compute(ct);
+  std::cout << "attribute memory (" << attrs.numberOfAttributes() << " attributes): " << std::fixed 
+            << std::setprecision(1) << (static_cast<double>(attrs.memoryUsage()) / ct.numberOfNodes()) 
+            << " bytes/node (" << 8.0 * attrs.numberOfAttributes() << " as doubles)" << std::endl;
+  return 0;
+}
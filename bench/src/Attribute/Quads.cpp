@@ -0,0 +1,37 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/Attribute/AttributeComputerQuads.hpp>
+
+using namespace pomar;
+
+/* Quads counting (area, perimeter and Euler number) of the max-tree (8-connectivity) and
+   min-tree (4-connectivity) of noise and natural-like images.
+   Usage: benchQuads [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder;
+  auto maxTree = builder.build(meta, f, GridAdjacency8(size.width, size.height), CTBuilder::TreeType::MaxTree);
+  auto minTree = builder.build(meta, f, GridAdjacency4(size.width, size.height), CTBuilder::TreeType::MinTree);
+  std::vector<std::shared_ptr<AttributeFromQuadsComputer>> qattrs = {std::make_shared<QArea>(), 
+    std::make_shared<QPerimeter>(), std::make_shared<QEulerNumber>()};
+
+  AttributeComputerQuads<T> maxQuads{QTreeType::MaxTree, QConnectivity::Eight, qattrs};
+  AttributeComputerQuads<T> minQuads{QTreeType::MinTree, QConnectivity::Four, qattrs};
+  bench::report(name + " max-tree 8-connectivity", bench::measure([&]() { maxQuads.compute(maxTree); }), 
+    size.npixels());
+  bench::report(name + " min-tree 4-connectivity", bench::measure([&]() { minQuads.compute(minTree); }), 
+    size.npixels());
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 1024, 1024);
+  std::cout << "quads counting " << size.width << "x" << size.height << std::endl;
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("uint8 noise", size, bench::noiseImage<unsigned char>(size, 255));
+  return 0;
+}
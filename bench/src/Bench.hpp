@@ -0,0 +1,136 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+
+#ifndef POMAR_BENCH_HPP_INCLUDED
+#define POMAR_BENCH_HPP_INCLUDED
+
+/** @file */
+
+/* Keeps the compiler from inlining the allocation functions replaced by a benchmark to count 
+   allocations: GCC reports the header arithmetic of the inlined operator delete as a 
+   mismatched new/free. */
+#if defined(__GNUC__)
+#define POMAR_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define POMAR_BENCH_NOINLINE
+#endif
+
+namespace pomar
+{
+  namespace bench
+  {
+    /** Image size used by a benchmark, read from the command line ("bench [width] [height]"). */
+    struct ImageSize
+    {
+      int width;
+      int height;
+      inline long npixels() const { return static_cast<long>(width) * height; }
+    };
+
+    /** Parse the image size from the command line arguments. */
+    inline ImageSize imageSize(int argc, char **argv, int defaultWidth, int defaultHeight)
+    {
+      ImageSize size{defaultWidth, defaultHeight};
+      if (argc > 1) size.width = std::atoi(argv[1]);
+      if (argc > 2) size.height = std::atoi(argv[2]);
+      return size;
+    }
+
+    /** Run 'f' 'repeats' times and return the median running time in milliseconds. */
+    template<typename F>
+    double measure(F f, int repeats = 5)
+    {
+      std::vector<double> times;
+      for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+      }
+      std::sort(times.begin(), times.end());
+      return times[times.size() / 2];
+    }
+
+    /** Print a result line: case name, running time and time per pixel. */
+    inline void report(const std::string &name, double ms, long npixels)
+    {
+      std::cout << std::left << std::setw(48) << name
+                << std::right << std::setw(12) << std::fixed << std::setprecision(2) << ms << " ms"
+                << std::setw(12) << std::setprecision(2) << (ms * 1e6 / npixels) << " ns/px"
+                << std::endl;
+    }
+
+    /** Print a result line with the speed-up relative to a reference time. */
+    inline void report(const std::string &name, double ms, long npixels, double referenceMs)
+    {
+      std::cout << std::left << std::setw(48) << name
+                << std::right << std::setw(12) << std::fixed << std::setprecision(2) << ms << " ms"
+                << std::setw(12) << std::setprecision(2) << (ms * 1e6 / npixels) << " ns/px"
+                << std::setw(10) << std::setprecision(2) << (referenceMs / ms) << "x"
+                << std::endl;
+    }
+
+    /** Image of uniform random values in [0, maxValue]. */
+    template<typename T>
+    std::vector<T> noiseImage(const ImageSize &size, double maxValue, unsigned seed = 42)
+    {
+      std::mt19937 gen(seed);
+      std::uniform_real_distribution<double> dist(0.0, maxValue);
+      std::vector<T> f(size.npixels());
+      for (auto &v : f)
+        v = static_cast<T>(dist(gen));
+      return f;
+    }
+
+    /** Image whose values increase along the rows (staircase when quantised). */
+    template<typename T>
+    std::vector<T> rampImage(const ImageSize &size, double maxValue)
+    {
+      std::vector<T> f(size.npixels());
+      for (int y = 0; y < size.height; ++y)
+        for (int x = 0; x < size.width; ++x)
+          f[static_cast<long>(y) * size.width + x] = static_cast<T>(
+            maxValue * (static_cast<double>(y) * size.width + x) / size.npixels());
+      return f;
+    }
+
+    /**
+     * Natural-like image: a smooth random surface (bilinear interpolation of a coarse
+     * random grid) plus a small amount of noise. */
+    template<typename T>
+    std::vector<T> naturalImage(const ImageSize &size, double maxValue, unsigned seed = 42)
+    {
+      const int cell = 32;
+      const int gw = size.width / cell + 2, gh = size.height / cell + 2;
+      std::mt19937 gen(seed);
+      std::uniform_real_distribution<double> coarse(0.0, 0.9 * maxValue);
+      std::normal_distribution<double> noise(0.0, 0.02 * maxValue);
+
+      std::vector<double> grid(static_cast<long>(gw) * gh);
+      for (auto &g : grid)
+        g = coarse(gen);
+
+      std::vector<T> f(size.npixels());
+      for (int y = 0; y < size.height; ++y) {
+        for (int x = 0; x < size.width; ++x) {
+          int gx = x / cell, gy = y / cell;
+          double ax = static_cast<double>(x % cell) / cell, ay = static_cast<double>(y % cell) / cell;
+          double v = (1 - ax) * (1 - ay) * grid[gy * gw + gx] + ax * (1 - ay) * grid[gy * gw + gx + 1]
+            + (1 - ax) * ay * grid[(gy + 1) * gw + gx] + ax * ay * grid[(gy + 1) * gw + gx + 1];
+          v = std::min(maxValue, std::max(0.0, v + noise(gen)));
+          f[static_cast<long>(y) * size.width + x] = static_cast<T>(v);
+        }
+      }
+      return f;
+    }
+  }
+}
+
+#endif
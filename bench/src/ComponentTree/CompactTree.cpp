@@ -0,0 +1,117 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+
+#include <new>
+#include <cstdlib>
+
+using namespace pomar;
+
+/* Max-tree build, area computation and memory of CTree (vector of nodes) and CompactCTree
+   (flat arrays) of noise and natural-like images, and the cost of 64 and 16-bit indices.
+   Usage: benchCompactTree [width] [height] */
+
+/* The allocations are tracked (with a header which stores their size) to measure the memory 
+   kept by each tree and the peak memory used to build it. */
+static const size_t HeaderSize = 16;
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+static size_t allocations = 0;
+
+POMAR_BENCH_NOINLINE void* operator new(size_t size)
+{
+  auto p = static_cast<char*>(std::malloc(size + HeaderSize));
+  if (!p)
+    throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(p) = size;
+  liveBytes += size;
+  peakBytes = std::max(peakBytes, liveBytes);
+  allocations++;
+  return p + HeaderSize;
+}
+
+POMAR_BENCH_NOINLINE void operator delete(void *p) noexcept
+{
+  if (!p)
+    return;
+  auto h = static_cast<char*>(p) - HeaderSize;
+  liveBytes -= *reinterpret_cast<size_t*>(h);
+  std::free(h);
+}
+
+template<typename F>
+void reportMemory(const std::string &name, F build, long npixels)
+{
+  auto bytes = liveBytes;
+  auto count = allocations;
+  peakBytes = liveBytes;
+  auto tree = build();
+  std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(8) << (static_cast<double>(liveBytes - bytes) / npixels) << " bytes/px (tree)"
+            << std::setw(8) << (static_cast<double>(peakBytes - bytes) / npixels) << " bytes/px (peak)"
+            << std::setw(10) << (allocations - count) << " allocations" << std::endl;
+}
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder(CTBuilder::Algorithm::UnionByRank);
+  GridAdjacency8 adj(size.width, size.height);
+
+  auto buildTree = [&]() { return builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree); };
+  auto buildCompact = [&]() { return builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree); };
+
+  auto buildCompact64 = [&]() { return builder.buildCompact<long long>(meta, f, adj, CTBuilder::TreeType::MaxTree); };
+
+  auto ms = bench::measure([&]() { buildTree(); });
+  bench::report(name + " CTree build", ms, size.npixels());
+  bench::report(name + " CompactCTree build", bench::measure([&]() { buildCompact(); }), size.npixels(), ms);
+  bench::report(name + " CompactCTree<long long> build", bench::measure([&]() { buildCompact64(); }), 
+    size.npixels(), ms);
+
+  auto tree = buildTree();
+  auto ctree = buildCompact();
+  AreaAttributeComputer<T> area;
+  AreaAttributeComputer<T, CompactCTree<T>> carea;
+  ms = bench::measure([&]() { area.compute(tree); });
+  bench::report(name + " CTree area", ms, size.npixels());
+  bench::report(name + " CompactCTree area", bench::measure([&]() { carea.compute(ctree); }), size.npixels(), ms);
+
+  reportMemory(name + " CTree memory", buildTree, size.npixels());
+  reportMemory(name + " CompactCTree memory", buildCompact, size.npixels());
+  reportMemory(name + " CompactCTree<long long> memory", buildCompact64, size.npixels());
+}
+
+/* Memory of the trees of a small tile (up to 2^15 pixels) with int and short indices. */
+void runTile()
+{
+  bench::ImageSize size{181, 181};
+  auto f = bench::naturalImage<unsigned char>(size, 255);
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder;
+  GridAdjacency8 adj(size.width, size.height);
+  
+  reportMemory("tile 181x181 CTree memory", [&]() { 
+    return builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree); }, size.npixels());
+  reportMemory("tile 181x181 CTree<short> memory", [&]() { 
+    return builder.build<short>(meta, f, adj, CTBuilder::TreeType::MaxTree); }, size.npixels());
+  reportMemory("tile 181x181 CompactCTree memory", [&]() { 
+    return builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree); }, size.npixels());
+  reportMemory("tile 181x181 CompactCTree<short> memory", [&]() { 
+    return builder.buildCompact<short>(meta, f, adj, CTBuilder::TreeType::MaxTree); }, size.npixels());
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  std::cout << "compact max-tree " << size.width << "x" << size.height << std::endl;
+
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("uint8 noise", size, bench::noiseImage<unsigned char>(size, 255));
+  run("uint16 noise", size, bench::noiseImage<unsigned short>(size, 65535));
+  runTile();
+  return 0;
+}
@@ -0,0 +1,37 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+using namespace pomar;
+
+/* Max-tree and min-tree builds of the same image with two separate builds and with buildDual 
+   (a single sort). Usage: benchDualBuild [width] [height] [nthreads] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f, int nthreads)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder(CTBuilder::Algorithm::UnionByRank, nthreads);
+  GridAdjacency8 adj(size.width, size.height);
+
+  auto ms = bench::measure([&]() { 
+    builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree);
+    builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MinTree);
+  });
+  bench::report(name + " max-tree + min-tree", ms, size.npixels());
+  bench::report(name + " buildCompactDual", bench::measure([&]() { 
+    builder.buildCompactDual(meta, f, adj); }), size.npixels(), ms);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  int nthreads = argc > 3 ? std::atoi(argv[3]) : 1;
+  std::cout << "dual tree build " << size.width << "x" << size.height << " (" << nthreads 
+            << " threads)" << std::endl;
+
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255), nthreads);
+  run("float natural", size, bench::naturalImage<float>(size, 1.0), nthreads);
+  run("float noise", size, bench::noiseImage<float>(size, 1.0), nthreads);
+  return 0;
+}
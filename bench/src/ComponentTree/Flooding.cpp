@@ -0,0 +1,37 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+
+using namespace pomar;
+
+/* Compare the hierarchical queue (flooding) builder with the union-find builders on 8-bit
+   and 12-bit frames. Usage: benchFlooding [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  auto buildWith = [&](CTBuilder::Algorithm algorithm) {
+    CTBuilder builder(algorithm);
+    auto ct = builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(size.width, size.height),
+      CTBuilder::TreeType::MaxTree);
+    return ct.numberOfNodes();
+  };
+
+  auto unionFind = bench::measure([&]() { buildWith(CTBuilder::Algorithm::UnionFind); });
+  bench::report(name + " union-find", unionFind, size.npixels(), unionFind);
+  bench::report(name + " union by rank", bench::measure([&]() { buildWith(CTBuilder::Algorithm::UnionByRank); }),
+    size.npixels(), unionFind);
+  bench::report(name + " hierarchical queue", 
+    bench::measure([&]() { buildWith(CTBuilder::Algorithm::HierarchicalQueue); }), size.npixels(), unionFind);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 1920, 1080);
+  std::cout << "max-tree build (8-connectivity) " << size.width << "x" << size.height << std::endl;
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("uint8 noise", size, bench::noiseImage<unsigned char>(size, 255));
+  run("uint12 natural", size, bench::naturalImage<unsigned short>(size, 4095));
+  return 0;
+}
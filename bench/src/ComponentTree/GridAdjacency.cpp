@@ -0,0 +1,47 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+using namespace pomar;
+
+/* Compare the max-tree builder using AdjacencyByTranslating2D (virtual neighbours, or by value
+   with inlined interior/border neighbours) and GridAdjacency2D (neighbours known at compile
+   time) with each algorithm.
+   Usage: benchGridAdjacency [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  const std::vector<std::pair<std::string, CTBuilder::Algorithm>> algorithms = {
+    {"union-find", CTBuilder::Algorithm::UnionFind}, 
+    {"union by rank", CTBuilder::Algorithm::UnionByRank},
+    {"hierarchical queue", CTBuilder::Algorithm::HierarchicalQueue}};
+
+  for (const auto &algorithm : algorithms) {
+    CTBuilder builder(algorithm.second);
+    auto dynamic = bench::measure([&]() {
+      builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(size.width, size.height), 
+        CTBuilder::TreeType::MaxTree);
+    }, 3);
+    bench::report(name + " " + algorithm.first + " Adjacency", dynamic, size.npixels(), dynamic);
+    bench::report(name + " " + algorithm.first + " by value", bench::measure([&]() {
+      std::vector<IPoint2D> square{{-1,-1}, {0,-1}, {1,-1}, {1,0}, {1,1}, {0,1}, {-1,1}, {-1,0}};
+      builder.build(meta, f, AdjacencyByTranslating2D(size.width, size.height, square), 
+        CTBuilder::TreeType::MaxTree);
+    }, 3), size.npixels(), dynamic);
+    bench::report(name + " " + algorithm.first + " GridAdjacency8", bench::measure([&]() {
+      builder.build(meta, f, GridAdjacency8(size.width, size.height), CTBuilder::TreeType::MaxTree);
+    }, 3), size.npixels(), dynamic);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  std::cout << "max-tree build (8-connectivity) " << size.width << "x" << size.height << std::endl;
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("uint16 natural", size, bench::naturalImage<unsigned short>(size, 65535));
+  return 0;
+}
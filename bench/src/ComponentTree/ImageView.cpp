@@ -0,0 +1,48 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/Core/ImageView.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+using namespace pomar;
+
+/* Compact max-tree builds of an image with padded rows (e.g. a camera buffer): copy into a 
+   tight vector and build, build from a view of the padded rows and build from a view of a tight
+   image. Usage: benchImageView [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  const int rowStride = size.width + 64;
+  std::vector<T> buffer(static_cast<size_t>(rowStride) * size.height);
+  for (int y = 0; y < size.height; y++)
+    std::copy(f.begin() + static_cast<size_t>(y) * size.width, f.begin() + static_cast<size_t>(y + 1) * size.width, 
+      buffer.begin() + static_cast<size_t>(y) * rowStride);
+
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder(CTBuilder::Algorithm::UnionByRank);
+  GridAdjacency8 adj(size.width, size.height);
+  ImageView2D<T> padded(buffer.data(), size.width, size.height, rowStride);
+  ImageView2D<T> tight(f.data(), size.width, size.height);
+
+  auto ms = bench::measure([&]() {
+    std::vector<T> copy(padded.size());
+    for (int y = 0; y < size.height; y++)
+      std::copy(padded.row(y), padded.row(y) + size.width, copy.begin() + static_cast<size_t>(y) * size.width);
+    builder.buildCompact(meta, copy, adj, CTBuilder::TreeType::MaxTree);
+  });
+  bench::report(name + " copy + buildCompact", ms, size.npixels());
+  bench::report(name + " buildCompact (padded view)", bench::measure([&]() { 
+    builder.buildCompact(meta, padded, adj, CTBuilder::TreeType::MaxTree); }), size.npixels(), ms);
+  bench::report(name + " buildCompact (tight view)", bench::measure([&]() { 
+    builder.buildCompact(meta, tight, adj, CTBuilder::TreeType::MaxTree); }), size.npixels(), ms);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  std::cout << "image view builds " << size.width << "x" << size.height << std::endl;
+
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("float natural", size, bench::naturalImage<float>(size, 1.0));
+  return 0;
+}
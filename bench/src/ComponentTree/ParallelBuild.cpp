@@ -0,0 +1,40 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+
+#include <sstream>
+
+using namespace pomar;
+
+/* Compare the sequential max-tree builder with the strip-parallel one. 
+   Usage: benchParallelBuild [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  auto buildWith = [&](int nthreads) {
+    CTBuilder builder(nthreads);
+    auto ct = builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(size.width, size.height),
+      CTBuilder::TreeType::MaxTree);
+    return ct.numberOfNodes();
+  };
+
+  auto sequential = bench::measure([&]() { buildWith(1); }, 3);
+  bench::report(name + " sequential", sequential, size.npixels(), sequential);
+  for (int t = 2; t <= std::max(4, hardwareThreads()); t *= 2) {
+    std::ostringstream ss;
+    ss << name << " " << t << " threads";
+    bench::report(ss.str(), bench::measure([&]() { buildWith(t); }, 3), size.npixels(), sequential);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 4096, 4096);
+  std::cout << "max-tree build (8-connectivity) " << size.width << "x" << size.height << std::endl;
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("uint16 natural", size, bench::naturalImage<unsigned short>(size, 65535));
+  run("uint16 noise", size, bench::noiseImage<unsigned short>(size, 65535));
+  return 0;
+}
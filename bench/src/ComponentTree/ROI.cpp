@@ -0,0 +1,64 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CTBuilderWorkspace.hpp>
+#include <pomar/Core/ImageView.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+using namespace pomar;
+
+/* Compact max-tree builds of the 64x64 windows (with a step of 32 pixels) of an image: crop 
+   each window into a vector and build, build from the ROI of the image view and build from the
+   ROI view with a reused workspace. Usage: benchROI [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  const int window = 64, step = 32;
+  ImageView2D<T> image(f.data(), size.width, size.height);
+  CTBuilder builder(CTBuilder::Algorithm::UnionByRank);
+  size_t npixels = 0;
+  for (int y = 0; y + window <= size.height; y += step)
+    for (int x = 0; x + window <= size.width; x += step)
+      npixels += window * window;
+
+  auto ms = bench::measure([&]() {
+    for (int y = 0; y + window <= size.height; y += step) {
+      for (int x = 0; x + window <= size.width; x += step) {
+        std::vector<T> crop;
+        crop.reserve(window * window);
+        for (int j = y; j < y + window; j++)
+          crop.insert(crop.end(), image.row(j) + x, image.row(j) + x + window);
+        auto meta = std::make_shared<CTMetaImage2D>(window, window, 1);
+        builder.buildCompact(meta, crop, GridAdjacency8(window, window), CTBuilder::TreeType::MaxTree);
+      }
+    }
+  });
+  bench::report(name + " crop + buildCompact", ms, npixels);
+
+  bench::report(name + " buildCompactROI", bench::measure([&]() {
+    for (int y = 0; y + window <= size.height; y += step)
+      for (int x = 0; x + window <= size.width; x += step)
+        builder.buildCompactROI<GridAdjacency8>(image, x, y, window, window, CTBuilder::TreeType::MaxTree);
+  }), npixels, ms);
+
+  CTBuilderWorkspace<T> workspace;
+  CompactCTree<T> tree;
+  auto meta = std::make_shared<CTMetaImage2D>(window, window, 1);
+  GridAdjacency8 adj(window, window);
+  bench::report(name + " buildCompact (ROI view + workspace)", bench::measure([&]() {
+    for (int y = 0; y + window <= size.height; y += step)
+      for (int x = 0; x + window <= size.width; x += step)
+        builder.buildCompact(meta, image.roi(x, y, window, window), adj, CTBuilder::TreeType::MaxTree, 
+          workspace, tree);
+  }), npixels, ms);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 1024, 1024);
+  std::cout << "region of interest builds " << size.width << "x" << size.height << std::endl;
+
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  run("float natural", size, bench::naturalImage<float>(size, 1.0));
+  return 0;
+}
@@ -0,0 +1,37 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+
+using namespace pomar;
+
+/* Compare the union-find variants of the max-tree builder on ramp, noise and natural images.
+   Usage: benchUnionByRank [width] [height] */
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  auto buildWith = [&](CTBuilder::Algorithm algorithm) {
+    CTBuilder builder(algorithm);
+    auto ct = builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency4(size.width, size.height),
+      CTBuilder::TreeType::MaxTree);
+    return ct.numberOfNodes();
+  };
+
+  auto unionFind = bench::measure([&]() { buildWith(CTBuilder::Algorithm::UnionFind); }, 3);
+  bench::report(name + " union-find", unionFind, size.npixels(), unionFind);
+  bench::report(name + " union by rank", bench::measure([&]() { buildWith(CTBuilder::Algorithm::UnionByRank); }, 3),
+    size.npixels(), unionFind);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  std::cout << "max-tree build (4-connectivity) " << size.width << "x" << size.height << std::endl;
+  run("uint16 ramp", size, bench::rampImage<unsigned short>(size, 65535));
+  run("uint8 ramp", size, bench::rampImage<unsigned char>(size, 255));
+  run("uint8 noise", size, bench::noiseImage<unsigned char>(size, 255));
+  run("uint16 noise", size, bench::noiseImage<unsigned short>(size, 65535));
+  run("uint8 natural", size, bench::naturalImage<unsigned char>(size, 255));
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+using namespace pomar;
+
+/* Max-tree of a volume (a natural-like image of width x height slices) with 6 and 26-connectivity
+   and the peak memory used per voxel.
+   Usage: benchVolume [width] [height] [depth] */
+
+long peakMemoryKB()
+{
+#ifdef __unix__
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#else
+  return 0;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 256, 256);
+  const int depth = argc > 3 ? std::atoi(argv[3]) : 256;
+  bench::ImageSize volume{size.width, size.height * depth};
+  auto f = bench::naturalImage<unsigned char>(volume, 255);
+  auto meta = std::make_shared<CTMetaImage3D>(size.width, size.height, depth, 1);
+  std::cout << "volume max-tree build " << size.width << "x" << size.height << "x" << depth << std::endl;
+
+  for (auto algorithm : {CTBuilder::Algorithm::UnionByRank, CTBuilder::Algorithm::HierarchicalQueue}) {
+    CTBuilder builder(algorithm);
+    const std::string name = algorithm == CTBuilder::Algorithm::UnionByRank ? "union by rank" : "hierarchical queue";
+    bench::report("uint8 " + name + " 6-connectivity", bench::measure([&]() {
+      builder.build(meta, f, GridAdjacency6(size.width, size.height, depth), CTBuilder::TreeType::MaxTree);
+    }, 3), volume.npixels());
+    bench::report("uint8 " + name + " 26-connectivity", bench::measure([&]() {
+      builder.build(meta, f, GridAdjacency26(size.width, size.height, depth), CTBuilder::TreeType::MaxTree);
+    }, 3), volume.npixels());
+  }
+
+  std::cout << "peak memory: " << std::fixed << std::setprecision(1) 
+            << (peakMemoryKB() * 1024.0 / volume.npixels()) << " bytes/voxel" << std::endl;
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+#include <new>
+#include <cstdlib>
+
+using namespace pomar;
+
+/* Compact max-tree builds of a sequence of frames (e.g. video) with a new tree per frame and 
+   with a reused CTBuilderWorkspace and output tree, and the allocations made per frame, using 
+   union by rank and flooding.
+   Usage: benchWorkspace [width] [height] */
+
+/* The allocations are counted with a header in front of each block (as in benchCompactTree). */
+static const size_t HeaderSize = 16;
+static size_t allocations = 0;
+
+POMAR_BENCH_NOINLINE void* operator new(size_t size)
+{
+  auto p = static_cast<char*>(std::malloc(size + HeaderSize));
+  if (!p)
+    throw std::bad_alloc();
+  allocations++;
+  return p + HeaderSize;
+}
+
+POMAR_BENCH_NOINLINE void operator delete(void *p) noexcept
+{
+  if (p)
+    std::free(static_cast<char*>(p) - HeaderSize);
+}
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<std::vector<T>> &frames,
+  CTBuilder::Algorithm algorithm = CTBuilder::Algorithm::UnionByRank)
+{
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder(algorithm);
+  GridAdjacency8 adj(size.width, size.height);
+  const long npixels = size.npixels() * static_cast<long>(frames.size());
+
+  auto ms = bench::measure([&]() { 
+    for (const auto &f : frames) 
+      builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree); 
+  });
+  bench::report(name + " buildCompact", ms, npixels);
+
+  CTBuilderWorkspace<T> ws;
+  CompactCTree<T> tree;
+  bench::report(name + " buildCompact (workspace)", bench::measure([&]() { 
+    for (const auto &f : frames) 
+      builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree, ws, tree); 
+  }), npixels, ms);
+
+  auto count = allocations;
+  for (const auto &f : frames)
+    builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree);
+  std::cout << std::left << std::setw(40) << (name + " buildCompact") << std::right 
+            << std::setw(10) << (allocations - count) / frames.size() << " allocations/frame" << std::endl;
+
+  count = allocations;
+  for (const auto &f : frames)
+    builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree, ws, tree);
+  std::cout << std::left << std::setw(40) << (name + " buildCompact (workspace)") << std::right 
+            << std::setw(10) << (allocations - count) / frames.size() << " allocations/frame" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 320, 240);
+  const int nframes = 30;
+  std::cout << "compact max-tree of " << nframes << " frames " << size.width << "x" << size.height << std::endl;
+
+  std::vector<std::vector<unsigned char>> frames8;
+  std::vector<std::vector<unsigned short>> frames16;
+  for (int i = 0; i < nframes; i++) {
+    frames8.push_back(bench::naturalImage<unsigned char>(size, 255, 42 + i));
+    frames16.push_back(bench::noiseImage<unsigned short>(size, 65535, 42 + i));
+  }
+
+  run("uint8 natural", size, frames8);
+  run("uint16 noise", size, frames16);
+  run("uint8 flooding", size, frames8, CTBuilder::Algorithm::HierarchicalQueue);
+  return 0;
+}
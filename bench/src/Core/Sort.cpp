@@ -0,0 +1,49 @@
+#include "../Bench.hpp"
+#include <pomar/Core/Sort.hpp>
+
+using namespace pomar;
+
+/* Compare the comparison (STL) sort, the counting sort and the radix sort of pixel indices,
+   sequential and using all hardware threads.
+   Usage: benchSort [width] [height] */
+
+template<typename T>
+void runCounting(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f, double stl,
+  std::true_type)
+{
+  const int nthreads = hardwareThreads();
+  bench::report(name + " counting sort", bench::measure([&]() { incresingCountingSortIndex(f); }, 3),
+    size.npixels(), stl);
+  bench::report(name + " counting sort (" + std::to_string(nthreads) + " threads)", 
+    bench::measure([&]() { incresingCountingSortIndex(f, nthreads); }, 3), size.npixels(), stl);
+}
+
+template<typename T>
+void runCounting(const std::string &, const bench::ImageSize &, const std::vector<T> &, double, std::false_type)
+{}
+
+template<typename T>
+void run(const std::string &name, const bench::ImageSize &size, const std::vector<T> &f)
+{
+  auto stl = bench::measure([&]() { STLsortIndex<T>(f, [](const T& v1, const T& v2) { return v1 < v2; }); }, 3);
+  bench::report(name + " STL sort", stl, size.npixels(), stl);
+  const int nthreads = hardwareThreads();
+  const std::string threads = " (" + std::to_string(nthreads) + " threads)";
+  runCounting(name, size, f, stl, std::is_same<typename SortStrategy<T>::type, CountingSortTag>());
+  bench::report(name + " radix sort", bench::measure([&]() { increasingRadixSortIndex(f); }, 3),
+    size.npixels(), stl);
+  bench::report(name + " radix sort" + threads, 
+    bench::measure([&]() { increasingRadixSortIndex(f, nthreads); }, 3), size.npixels(), stl);
+}
+
+int main(int argc, char **argv)
+{
+  auto size = bench::imageSize(argc, argv, 2048, 2048);
+  std::cout << "increasing index sort " << size.width << "x" << size.height << std::endl;
+  run("uint16 noise", size, bench::noiseImage<unsigned short>(size, 65535));
+  run("uint16 natural", size, bench::naturalImage<unsigned short>(size, 65535));
+  run("int32 natural", size, bench::naturalImage<int>(size, 1e8));
+  run("float natural", size, bench::naturalImage<float>(size, 1000.0));
+  run("double natural", size, bench::naturalImage<double>(size, 1000.0));
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include "../Bench.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/Filter/AttributeFilter.hpp>
+
+using namespace pomar;
+
+/* Area opening of an 8-bit natural-like image: max-tree build (compact tree), area computation and
+   the filter itself with each decision rule, which writes the filtered image from the tree, and the
+   reconstruction of the image into a preallocated buffer (sequentially and with nthreads threads).
+   Usage: benchAreaOpening [width] [height] [area threshold (default: 100)] [nthreads] */
+
+int main(int argc, char **argv)
+{
+  using T = unsigned char;
+  auto size = bench::imageSize(argc, argv, 4096, 4096);
+  const double threshold = argc > 3 ? std::atof(argv[3]) : 100;
+  const int nthreads = argc > 4 ? std::atoi(argv[4]) : hardwareThreads();
+  auto f = bench::naturalImage<T>(size, 255);
+  auto meta = std::make_shared<CTMetaImage2D>(size.width, size.height, 1);
+  CTBuilder builder;
+
+  CompactCTree<T> ct;
+  bench::report("max-tree build", bench::measure([&]() { 
+    ct = builder.buildCompact(meta, f, GridAdjacency8(size.width, size.height), CTBuilder::TreeType::MaxTree); 
+  }, 3), size.npixels());
+  std::cout << "area opening " << size.width << "x" << size.height << " (" << ct.numberOfNodes() 
+            << " nodes), area >= " << threshold << std::endl;
+
+  AreaAttributeComputer<T, CompactCTree<T>> area;
+  AttributeCollection attrs;
+  bench::report("area", bench::measure([&]() { attrs = area.compute(ct); }), size.npixels());
+  auto values = attrs[attrs.attrIndex(AttrType::AREA)];
+
+  const char *names[] = {"filter direct", "filter min", "filter max", "filter subtractive"};
+  const FilterRule rules[] = {FilterRule::Direct, FilterRule::Min, FilterRule::Max, FilterRule::Subtractive};
+  for (int i = 0; i < 4; ++i) {
+    AttributeFilter<T, CompactCTree<T>> filter(rules[i]);
+    bench::report(names[i], bench::measure([&]() { filter.filter(ct, values, threshold); }), size.npixels());
+  }
+
+  std::vector<T> out(size.npixels());
+  AttributeFilter<T, CompactCTree<T>> filter;
+  auto ms = bench::measure([&]() { filter.filter(ct, values, threshold, out.data()); });
+  bench::report("filter direct into buffer", ms, size.npixels());
+  bench::report("filter direct into buffer " + std::to_string(nthreads) + " threads", 
+    bench::measure([&]() { filter.filter(ct, values, threshold, out.data(), nthreads); }), size.npixels(), ms);
+  bench::report("convertToVector", bench::measure([&]() { ct.convertToVector(); }), size.npixels());
+  ms = bench::measure([&]() { ct.convertTo(out.data()); });
+  bench::report("convertTo buffer", ms, size.npixels());
+  bench::report("convertTo buffer " + std::to_string(nthreads) + " threads", 
+    bench::measure([&]() { ct.convertTo(out.data(), nthreads); }), size.npixels(), ms);
+  return 0;
+}
@@ -1,6 +1,8 @@
 #include <vector>
 #include <limits>
 #include <cstddef>
+#include <memory>
+#include <stdexcept>
 
 #ifndef ADJACENCY_RELATION_H_INCLUDED
 #define ADJACENCY_RELATION_H_INCLUDED
@@ -29,12 +31,59 @@ namespace pomar
     */
     virtual const std::vector<int>& neighbours(int id) = 0;
 
+    /**
+    * It returns a copy of this adjacency relation. Since neighbours() may reuse
+    * an internal buffer, each thread of a parallel algorithm works on its own copy.
+    * The default implementation returns a null pointer: an adjacency relation which does 
+    * not override it can only be used by single-threaded algorithms.
+    */
+    virtual std::unique_ptr<Adjacency> clone() const { return nullptr; }
 
     /**
     * Virtual destructor for the pure virtual class Adjacency
     **/
     virtual ~Adjacency() {}
   };
+
+  /**
+  * Wrapper which visits the neighbours of an Adjacency by forEachNeighbour, the interface 
+  * of the adjacency relations known at compile time (see GridAdjacency2D). It lets the 
+  * algorithms written for them run over any Adjacency. A copy of the wrapper owns a clone
+  * of the adjacency relation, so copies can be used by different threads. Copying a wrapper
+  * of an adjacency relation which does not implement clone() throws std::logic_error.
+  */
+  class DynamicAdjacency
+  {
+  public:
+    /** Construct a wrapper of 'adj', which is not owned by the wrapper. */
+    explicit DynamicAdjacency(Adjacency *adj)
+      :_adj{adj}
+    {}
+
+    /** Construct a wrapper of a clone of the adjacency relation of 'other'. */
+    DynamicAdjacency(const DynamicAdjacency &other)
+      :_owned{other._adj->clone()}, _adj{_owned.get()}
+    {
+      if (!_adj)
+        throw std::logic_error("the adjacency relation must implement clone() to be used by several threads");
+    }
+
+    DynamicAdjacency& operator=(const DynamicAdjacency &other) = delete;
+
+    /** Call f(q) for each neighbour q of the vertex p. */
+    template<typename F>
+    inline void forEachNeighbour(int p, F f)
+    {
+      for (auto q: _adj->neighbours(p)) {
+        if (q != Adjacency::NoAdjacentIndex)
+          f(q);
+      }
+    }
+
+  private:
+    std::unique_ptr<Adjacency> _owned;
+    Adjacency *_adj;
+  };
 }
 
 #endif
@@ -1,4 +1,5 @@
 #include <pomar/AdjacencyRelation/Adjacency.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
 #include <pomar/Math/Point.hpp>
 #include <memory>
 
@@ -13,6 +14,14 @@ namespace pomar
   *  Class which implements an adjacency relation over a grid of size  \f$ width \times height \f$
   *  such that a vertex neighbourhood can be found by this vertex translation
   *  over the grid (this kind of adjacency is very common to 2D images).
+  *
+  *  The translations are converted to linear offsets once, and the grid is split into
+  *  an interior region, whose pixels have all their neighbours on the grid, and the 
+  *  border frame around it (as wide as the largest translation). The neighbours of the 
+  *  interior pixels are computed by adding the offsets without any bounds check, and only
+  *  the border pixels take the checked path. forEachNeighbour visits the neighbours in the
+  *  same way without filling a vector, and it is used by CTBuilder::build when this
+  *  adjacency is given by value.
   */
   class AdjacencyByTranslating2D: public virtual Adjacency
   {
@@ -29,8 +38,41 @@ namespace pomar
     * the translation points in t.
     */
     AdjacencyByTranslating2D(int width, int height, std::initializer_list<IPoint2D>& t);
+
+    /** 
+    * It returns the neighbourhood of the vertex identified by id (see Adjacency::neighbours).
+    */
     const std::vector<int>& neighbours(int id);
 
+    /** Call f(q) for each neighbour q of the vertex id (in the order of the translations). */
+    template<typename IndexT, typename F>
+    inline void forEachNeighbour(IndexT id, F f) const;
+
+    /** Return true if all the neighbours of the vertex id are on the grid. */
+    inline bool isInterior(int id) const
+    {
+      const int y = id / _width;
+      return isInterior(id - y * _width, y);
+    }
+
+    /** Return true if all the neighbours of the point (x, y) are on the grid. */
+    inline bool isInterior(int x, int y) const
+    {
+      return x >= _xbegin && x < _xend && y >= _ybegin && y < _yend;
+    }
+
+    /** Return the linear offset (dy * width + dx) of the i-th translation. */
+    inline int offset(size_t i) const { return _offsets[i]; }
+
+    /** Return the number of translations. */
+    inline size_t size() const { return _t.size(); }
+
+    /** Return the i-th translation. */
+    inline const IPoint2D& translation(size_t i) const { return _t[i]; }
+
+    /** Return a copy of this adjacency relation. */
+    std::unique_ptr<Adjacency> clone() const;
+
     /**
     *  Create a 4-connected adjacency defined by the cross set
     (Cr = {(-1,0), (0,-1), (1, 0), (0,1)}) for a grid of size width x height.
@@ -48,12 +90,128 @@ namespace pomar
     */
     ~AdjacencyByTranslating2D();
 
+  private:
+    void computeOffsets();
+
   private:
     int _width;
     int _height;
     std::vector<IPoint2D> _t;
+    std::vector<int> _offsets;
+    int _xbegin, _xend, _ybegin, _yend;
+    std::vector<int> _neighbours;
+  };
+
+  template<>
+  struct isStaticAdjacency<AdjacencyByTranslating2D> : std::true_type {};
+
+  /**
+  *  Class which implements an adjacency relation over a grid of size 
+  *  \f$ width \times height \times depth \f$ (a volume whose voxel (x, y, z) has index
+  *  (z * height + y) * width + x) such that a vertex neighbourhood can be found by this
+  *  vertex translation over the grid. As AdjacencyByTranslating2D, the neighbours of the 
+  *  interior voxels are computed from linear offsets without bounds checks.
+  */
+  class AdjacencyByTranslating3D: public virtual Adjacency
+  {
+  public:
+    /**
+    * Construct an adjacency from a grid of size width x height x depth defined by
+    * the translation points in t.
+    */
+    AdjacencyByTranslating3D(int width, int height, int depth, const std::vector<IPoint3D>& t);
+
+    /** 
+    * It returns the neighbourhood of the vertex identified by id (see Adjacency::neighbours).
+    */
+    const std::vector<int>& neighbours(int id);
+
+    /** Call f(q) for each neighbour q of the vertex id (in the order of the translations). */
+    template<typename IndexT, typename F>
+    inline void forEachNeighbour(IndexT id, F f) const;
+
+    /** Return true if all the neighbours of the point (x, y, z) are on the grid. */
+    inline bool isInterior(int x, int y, int z) const
+    {
+      return x >= _xbegin && x < _xend && y >= _ybegin && y < _yend && z >= _zbegin && z < _zend;
+    }
+
+    /** Return the linear offset ((dz * height + dy) * width + dx) of the i-th translation. */
+    inline int offset(size_t i) const { return _offsets[i]; }
+
+    /** Return a copy of this adjacency relation. */
+    std::unique_ptr<Adjacency> clone() const;
+
+    /** Create a 6-connected adjacency (faces) for a grid of size width x height x depth. */
+    static std::unique_ptr<Adjacency> createAdjacency6(int width, int height, int depth);
+
+    /** Create a 18-connected adjacency (faces and edges) for a grid of size width x height x depth. */
+    static std::unique_ptr<Adjacency> createAdjacency18(int width, int height, int depth);
+
+    /** Create a 26-connected adjacency (faces, edges and corners) for a grid of size width x height x depth. */
+    static std::unique_ptr<Adjacency> createAdjacency26(int width, int height, int depth);
+
+    /** 
+    * Translations of the 6, 18 or 26-connected adjacency ordered by z, y and x (the 
+    * same order as GridAdjacency3D). */
+    static std::vector<IPoint3D> translations(int connectivity);
+
+  private:
+    int _width;
+    int _height;
+    int _depth;
+    std::vector<IPoint3D> _t;
+    std::vector<int> _offsets;
+    int _xbegin, _xend, _ybegin, _yend, _zbegin, _zend;
     std::vector<int> _neighbours;
   };
+
+  template<>
+  struct isStaticAdjacency<AdjacencyByTranslating3D> : std::true_type {};
+
+  /* ====================================[ IMPLEMENTATION ]========================================= */
+  template<typename IndexT, typename F>
+  inline void AdjacencyByTranslating2D::forEachNeighbour(IndexT id, F f) const
+  {
+    const int y = static_cast<int>(id / _width);
+    const int x = static_cast<int>(id - static_cast<IndexT>(y) * _width);
+    const size_t n = _t.size();
+
+    if (isInterior(x, y)) {
+      for (size_t i = 0; i < n; ++i)
+        f(static_cast<IndexT>(id + _offsets[i]));
+    }
+    else {
+      for (size_t i = 0; i < n; ++i) {
+        const int qx = x + _t[i].x(), qy = y + _t[i].y();
+        if (qx >= 0 && qx < _width && qy >= 0 && qy < _height)
+          f(static_cast<IndexT>(id + _offsets[i]));
+      }
+    }
+  }
+
+  template<typename IndexT, typename F>
+  inline void AdjacencyByTranslating3D::forEachNeighbour(IndexT id, F f) const
+  {
+    const IndexT plane = static_cast<IndexT>(_width) * _height;
+    const int z = static_cast<int>(id / plane);
+    const IndexT r = id - z * plane;
+    const int y = static_cast<int>(r / _width);
+    const int x = static_cast<int>(r - static_cast<IndexT>(y) * _width);
+    const size_t n = _t.size();
+
+    if (isInterior(x, y, z)) {
+      for (size_t i = 0; i < n; ++i)
+        f(static_cast<IndexT>(id + _offsets[i]));
+    }
+    else {
+      for (size_t i = 0; i < n; ++i) {
+        const int qx = x + _t[i].x(), qy = y + _t[i].y(), qz = z + _t[i].z();
+        if (qx >= 0 && qx < _width && qy >= 0 && qy < _height && qz >= 0 && qz < _depth)
+          f(static_cast<IndexT>(id + _offsets[i]));
+      }
+    }
+  }
 }
 
 #endif
@@ -0,0 +1,281 @@
+#include <pomar/AdjacencyRelation/Adjacency.hpp>
+#include <array>
+#include <vector>
+#include <memory>
+#include <type_traits>
+
+#ifndef GRID_ADJACENCY_HPP_INCLUDED
+#define GRID_ADJACENCY_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+  * Translations (dx, dy) of the 4- and 8-connected neighbourhoods of a 2D grid, in the 
+  * same order as AdjacencyByTranslating2D::createAdjacency4 and createAdjacency8. */
+  template<int Connectivity>
+  struct GridOffsets2D;
+
+  template<>
+  struct GridOffsets2D<4>
+  {
+    static constexpr int dx[4] = {-1, 0, 1, 0};
+    static constexpr int dy[4] = { 0,-1, 0, 1};
+  };
+
+  template<>
+  struct GridOffsets2D<8>
+  {
+    static constexpr int dx[8] = {-1, 0, 1, 1, 1, 0,-1,-1};
+    static constexpr int dy[8] = {-1,-1,-1, 0, 1, 1, 1, 0};
+  };
+
+  /**
+  * Translations (dx, dy, dz) of the 6-, 18- and 26-connected neighbourhoods of a 3D grid,
+  * ordered by z, y and x (as AdjacencyByTranslating3D::createAdjacency6, 18 and 26). */
+  template<int Connectivity>
+  struct GridOffsets3D;
+
+  template<>
+  struct GridOffsets3D<6>
+  {
+    static constexpr int dx[6] = { 0, 0,-1, 1, 0, 0};
+    static constexpr int dy[6] = { 0,-1, 0, 0, 1, 0};
+    static constexpr int dz[6] = {-1, 0, 0, 0, 0, 1};
+  };
+
+  template<>
+  struct GridOffsets3D<18>
+  {
+    static constexpr int dx[18] = { 0,-1, 0, 1, 0,-1, 0, 1,-1, 1,-1, 0, 1, 0,-1, 0, 1, 0};
+    static constexpr int dy[18] = {-1, 0, 0, 0, 1,-1,-1,-1, 0, 0, 1, 1, 1,-1, 0, 0, 0, 1};
+    static constexpr int dz[18] = {-1,-1,-1,-1,-1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1};
+  };
+
+  template<>
+  struct GridOffsets3D<26>
+  {
+    static constexpr int dx[26] = {-1, 0, 1,-1, 0, 1,-1, 0, 1,-1, 0, 1,-1, 1,-1, 0, 1,-1, 0, 1,-1, 0, 1,-1, 0, 1};
+    static constexpr int dy[26] = {-1,-1,-1, 0, 0, 0, 1, 1, 1,-1,-1,-1, 0, 0, 1, 1, 1,-1,-1,-1, 0, 0, 0, 1, 1, 1};
+    static constexpr int dz[26] = {-1,-1,-1,-1,-1,-1,-1,-1,-1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  };
+
+  /**
+  * 4- or 8-connected adjacency relation over a grid of size \f$ width \times height \f$ whose
+  * neighbourhood is known at compile time. Its neighbours are visited by forEachNeighbour, 
+  * which is not virtual and does not fill any vector: the pixels which are not on the 
+  * grid border (all but a few of them) are visited by a fixed-size loop over the linear
+  * offsets of the neighbours. The component tree builder is instantiated with this class
+  * when it is given to CTBuilder::build by value.
+  *
+  * It also implements the Adjacency interface, so it can be used wherever an Adjacency is 
+  * expected.
+  */
+  template<int Connectivity>
+  class GridAdjacency2D final: public virtual Adjacency
+  {
+    static_assert(Connectivity == 4 || Connectivity == 8, "GridAdjacency2D supports 4 and 8 connectivity only.");
+
+  public:
+    /** Number of neighbours of a pixel which is not on the grid border. */
+    static constexpr int NumberOfNeighbours = Connectivity;
+
+    /** Construct the adjacency relation for a grid of size width x height. */
+    GridAdjacency2D(int width, int height);
+
+    /** Grid width. */
+    inline int width() const { return _width; }
+    /** Grid height. */
+    inline int height() const { return _height; }
+
+    /** 
+    * Call f(q) for each neighbour q of the pixel p in the grid. The indices have the type 
+    * of p (e.g. int or long long). */
+    template<typename IndexT, typename F>
+    inline void forEachNeighbour(IndexT p, F f) const;
+
+    /** Neighbourhood of the pixel id (see Adjacency::neighbours). */
+    const std::vector<int>& neighbours(int id);
+
+    /** Return a copy of this adjacency relation. */
+    std::unique_ptr<Adjacency> clone() const;
+
+  private:
+    int _width;
+    int _height;
+    std::array<int, Connectivity> _offsets;
+    std::vector<int> _neighbours;
+  };
+
+  /** 4-connected grid adjacency relation. */
+  using GridAdjacency4 = GridAdjacency2D<4>;
+  /** 8-connected grid adjacency relation. */
+  using GridAdjacency8 = GridAdjacency2D<8>;
+
+  /** 
+  * Trait which is true for the adjacency relations whose neighbours are visited by a
+  * non-virtual forEachNeighbour, which CTBuilder::build accepts by value. */
+  template<typename Adj>
+  struct isStaticAdjacency : std::false_type {};
+
+  template<int Connectivity>
+  struct isStaticAdjacency<GridAdjacency2D<Connectivity>> : std::true_type {};
+
+  /**
+  * 6-, 18- or 26-connected adjacency relation over a grid of size \f$ width \times height
+  * \times depth \f$ (a volume whose voxel (x, y, z) has index (z * height + y) * width + x)
+  * whose neighbourhood is known at compile time. As GridAdjacency2D, the voxels which
+  * are not on the grid border are visited by a fixed-size loop over linear offsets.
+  */
+  template<int Connectivity>
+  class GridAdjacency3D final: public virtual Adjacency
+  {
+    static_assert(Connectivity == 6 || Connectivity == 18 || Connectivity == 26, 
+      "GridAdjacency3D supports 6, 18 and 26 connectivity only.");
+
+  public:
+    /** Number of neighbours of a voxel which is not on the grid border. */
+    static constexpr int NumberOfNeighbours = Connectivity;
+
+    /** Construct the adjacency relation for a grid of size width x height x depth. */
+    GridAdjacency3D(int width, int height, int depth);
+
+    /** Grid width. */
+    inline int width() const { return _width; }
+    /** Grid height. */
+    inline int height() const { return _height; }
+    /** Grid depth. */
+    inline int depth() const { return _depth; }
+
+    /** Call f(q) for each neighbour q of the voxel p in the grid. */
+    template<typename IndexT, typename F>
+    inline void forEachNeighbour(IndexT p, F f) const;
+
+    /** Neighbourhood of the voxel id (see Adjacency::neighbours). */
+    const std::vector<int>& neighbours(int id);
+
+    /** Return a copy of this adjacency relation. */
+    std::unique_ptr<Adjacency> clone() const;
+
+  private:
+    int _width;
+    int _height;
+    int _depth;
+    std::array<int, Connectivity> _offsets;
+    std::vector<int> _neighbours;
+  };
+
+  /** 6-connected grid adjacency relation. */
+  using GridAdjacency6 = GridAdjacency3D<6>;
+  /** 18-connected grid adjacency relation. */
+  using GridAdjacency18 = GridAdjacency3D<18>;
+  /** 26-connected grid adjacency relation. */
+  using GridAdjacency26 = GridAdjacency3D<26>;
+
+  template<int Connectivity>
+  struct isStaticAdjacency<GridAdjacency3D<Connectivity>> : std::true_type {};
+
+  /* ====================================[ IMPLEMENTATION ]========================================= */
+  template<int Connectivity>
+  constexpr int GridAdjacency2D<Connectivity>::NumberOfNeighbours;
+
+  template<int Connectivity>
+  GridAdjacency2D<Connectivity>::GridAdjacency2D(int width, int height)
+    :_width{width}, _height{height}, _neighbours(Connectivity)
+  {
+    for (int i = 0; i < Connectivity; ++i)
+      _offsets[i] = GridOffsets2D<Connectivity>::dy[i] * width + GridOffsets2D<Connectivity>::dx[i];
+  }
+
+  template<int Connectivity>
+  template<typename IndexT, typename F>
+  inline void GridAdjacency2D<Connectivity>::forEachNeighbour(IndexT p, F f) const
+  {
+    const int y = static_cast<int>(p / _width);
+    const int x = static_cast<int>(p - static_cast<IndexT>(y) * _width);
+
+    if (x > 0 && x < _width - 1 && y > 0 && y < _height - 1) {
+      for (int i = 0; i < Connectivity; ++i)
+        f(static_cast<IndexT>(p + _offsets[i]));
+    }
+    else {
+      for (int i = 0; i < Connectivity; ++i) {
+        const int qx = x + GridOffsets2D<Connectivity>::dx[i];
+        const int qy = y + GridOffsets2D<Connectivity>::dy[i];
+        if (qx >= 0 && qx < _width && qy >= 0 && qy < _height)
+          f(static_cast<IndexT>(p + _offsets[i]));
+      }
+    }
+  }
+
+  template<int Connectivity>
+  const std::vector<int>& GridAdjacency2D<Connectivity>::neighbours(int id)
+  {
+    int j = 0;
+    forEachNeighbour(id, [this, &j](int q) { _neighbours[j++] = q; });
+    for (; j < Connectivity; ++j)
+      _neighbours[j] = Adjacency::NoAdjacentIndex;
+    return _neighbours;
+  }
+
+  template<int Connectivity>
+  std::unique_ptr<Adjacency> GridAdjacency2D<Connectivity>::clone() const
+  {
+    return std::unique_ptr<Adjacency>(new GridAdjacency2D<Connectivity>(_width, _height));
+  }
+
+  template<int Connectivity>
+  constexpr int GridAdjacency3D<Connectivity>::NumberOfNeighbours;
+
+  template<int Connectivity>
+  GridAdjacency3D<Connectivity>::GridAdjacency3D(int width, int height, int depth)
+    :_width{width}, _height{height}, _depth{depth}, _neighbours(Connectivity)
+  {
+    using O = GridOffsets3D<Connectivity>;
+    for (int i = 0; i < Connectivity; ++i)
+      _offsets[i] = (O::dz[i] * height + O::dy[i]) * width + O::dx[i];
+  }
+
+  template<int Connectivity>
+  template<typename IndexT, typename F>
+  inline void GridAdjacency3D<Connectivity>::forEachNeighbour(IndexT p, F f) const
+  {
+    using O = GridOffsets3D<Connectivity>;
+    const IndexT plane = static_cast<IndexT>(_width) * _height;
+    const int z = static_cast<int>(p / plane);
+    const IndexT r = p - z * plane;
+    const int y = static_cast<int>(r / _width);
+    const int x = static_cast<int>(r - static_cast<IndexT>(y) * _width);
+
+    if (x > 0 && x < _width - 1 && y > 0 && y < _height - 1 && z > 0 && z < _depth - 1) {
+      for (int i = 0; i < Connectivity; ++i)
+        f(static_cast<IndexT>(p + _offsets[i]));
+    }
+    else {
+      for (int i = 0; i < Connectivity; ++i) {
+        const int qx = x + O::dx[i], qy = y + O::dy[i], qz = z + O::dz[i];
+        if (qx >= 0 && qx < _width && qy >= 0 && qy < _height && qz >= 0 && qz < _depth)
+          f(static_cast<IndexT>(p + _offsets[i]));
+      }
+    }
+  }
+
+  template<int Connectivity>
+  const std::vector<int>& GridAdjacency3D<Connectivity>::neighbours(int id)
+  {
+    int j = 0;
+    forEachNeighbour(id, [this, &j](int q) { _neighbours[j++] = q; });
+    for (; j < Connectivity; ++j)
+      _neighbours[j] = Adjacency::NoAdjacentIndex;
+    return _neighbours;
+  }
+
+  template<int Connectivity>
+  std::unique_ptr<Adjacency> GridAdjacency3D<Connectivity>::clone() const
+  {
+    return std::unique_ptr<Adjacency>(new GridAdjacency3D<Connectivity>(_width, _height, _depth));
+  }
+}
+
+#endif
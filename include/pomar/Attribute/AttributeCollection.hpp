@@ -1,63 +1,252 @@
 #include <vector>
-#include <map>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
 
 #ifndef ATTRIBUTE_COLLECTION_HPP_INCLUDED
 #define ATTRIBUTE_COLLECTION_HPP_INCLUDED
 
 /** @file */
 
-namespace pomar 
+namespace pomar
 {
   /** Enum used to denote the different attributes. */
-  enum class AttrType 
+  enum class AttrType
   {
     TEST_ATTRIBUTE,
     AREA, PERIMETER,
     QUADS_Q1, QUADS_Q2, QUADS_Q3, QUADS_QD, QUADS_Q4, QUADS_Q1DASH,
     QUADS_AREA, QUADS_PERIMETER, QUADS_EULER_NUMBER,
     QUADS_CONTINUOUS_AREA, QUADS_CONTINUOUS_PERIMETER,
+    BOUNDING_BOX_MIN_X, BOUNDING_BOX_MIN_Y, BOUNDING_BOX_MAX_X, BOUNDING_BOX_MAX_Y,
+    CENTROID_X, CENTROID_Y, CENTRAL_MOMENT_20, CENTRAL_MOMENT_02, CENTRAL_MOMENT_11,
+    ECCENTRICITY, ORIENTATION,
+    HU_MOMENT_1, HU_MOMENT_2, HU_MOMENT_3, HU_MOMENT_4, HU_MOMENT_5, HU_MOMENT_6, HU_MOMENT_7,
+    MIN_LEVEL, MAX_LEVEL, HEIGHT, VOLUME, MEAN_LEVEL, LEVEL_VARIANCE,
   };
 
+  /** Enum used to denote the type of the values of an attribute. */
+  enum class AttrValueType { Int32, Int64, Float, Double };
+
+  /** Traits which gives the AttrValueType of the C++ type V (int32_t, int64_t, float or double). */
+  template<typename V> struct AttrValueTypeOf;
+  template<> struct AttrValueTypeOf<std::int32_t> { static const AttrValueType value = AttrValueType::Int32; };
+  template<> struct AttrValueTypeOf<std::int64_t> { static const AttrValueType value = AttrValueType::Int64; };
+  template<> struct AttrValueTypeOf<float> { static const AttrValueType value = AttrValueType::Float; };
+  template<> struct AttrValueTypeOf<double> { static const AttrValueType value = AttrValueType::Double; };
+
+  /** Size in bytes of a value of type 'type'. */
+  std::size_t attrValueSize(AttrValueType type);
+
+  /**
+   * Span-like view of the values of an attribute whose values have type V (one value per node).
+   * It is meant for tight loops: the values are accessed directly with no type conversion. */
+  template<typename V>
+  class AttributeColumn
+  {
+  public:
+    /** Construct an empty view. */
+    AttributeColumn(): _data{nullptr}, _size{0} {}
+    /** Construct a view of the 'size' values starting at 'data'. */
+    AttributeColumn(V *data, std::size_t size): _data{data}, _size{size} {}
+
+    /** Get the value of the node 'nodeId'. */
+    inline V& operator[](std::size_t nodeId) const { return _data[nodeId]; }
+    /** Get the number of values (nodes). */
+    inline std::size_t size() const { return _size; }
+    /** Get a pointer to the first value. */
+    inline V* data() const { return _data; }
+    inline V* begin() const { return _data; }
+    inline V* end() const { return _data + _size; }
+
+  private:
+    V *_data;
+    std::size_t _size;
+  };
+
+  /** Reference to an attribute value of any value type which is read and written as double. */
+  class AttributeValueRef
+  {
+  public:
+    /** Construct a reference to the value of type 'type' stored at 'p'. */
+    AttributeValueRef(AttrValueType type, void *p): _type{type}, _p{p} {}
+
+    /** Read the value as double. */
+    inline operator double() const;
+    /** Write the value 'v' converted to the value type. */
+    inline AttributeValueRef& operator=(double v);
+    inline AttributeValueRef& operator=(const AttributeValueRef &other) { return *this = static_cast<double>(other); }
+    inline AttributeValueRef& operator+=(double v) { return *this = static_cast<double>(*this) + v; }
+    inline AttributeValueRef& operator-=(double v) { return *this = static_cast<double>(*this) - v; }
+
+  private:
+    AttrValueType _type;
+    void *_p;
+  };
+
+  /**
+   * View of the values of an attribute of any value type, which are read and written as double.
+   * It supports code which does not know the value type of the attribute; tight loops should use
+   * the typed view AttributeColumn (AttributeCollection::column). */
+  class AttributeValues
+  {
+  public:
+    /** Construct a view of the 'size' values of type 'type' starting at 'data'. */
+    AttributeValues(AttrValueType type, void *data, std::size_t size): _type{type}, _data{data}, _size{size} {}
+
+    /** Get a reference to the value of the node 'nodeId'. */
+    inline AttributeValueRef operator[](std::size_t nodeId) const
+    {
+      return AttributeValueRef(_type, static_cast<char*>(_data) + nodeId * attrValueSize(_type));
+    }
+    /** Get the number of values (nodes). */
+    inline std::size_t size() const { return _size; }
+    /** Get the type of the values. */
+    inline AttrValueType valueType() const { return _type; }
+    /** Get a pointer to the first value. */
+    inline void* data() const { return _data; }
+    /** Copy the values into an array of doubles. */
+    std::vector<double> toVector() const;
+
+  private:
+    AttrValueType _type;
+    void *_data;
+    std::size_t _size;
+  };
+
+  /** Compare the values of an attribute (as double) with the values of 'v'. */
+  bool operator==(const AttributeValues &values, const std::vector<double> &v);
+  bool operator==(const std::vector<double> &v, const AttributeValues &values);
+  /** Compare the values (as double) of two attributes. */
+  bool operator==(const AttributeValues &v1, const AttributeValues &v2);
+
   /** Class which represent a collection of attributes computed for a component tree. The attributes
-   *  are stored in an array of arrays, such that, the first pushed attribute is stored at position 0,
+   *  are stored in an array of columns, such that, the first pushed attribute is stored at position 0,
    *  the second pushed attribute is stored at position 1 and so on. One may get the attribute index
-   *  by calling the method attrIndex.
+   *  by calling the method attrIndex, which is a direct array lookup.
+   *
+   *  The values of each attribute are stored contiguously with their own value type (AttrValueType),
+   *  e.g. 32-bit integers for counts and floats for approximations, which takes half the memory of
+   *  doubles. operator[] gives a view which reads and writes any attribute as double, and column<V>
+   *  gives a typed view for tight loops. The values of an attribute do not move when other
+   *  attributes are pushed, so the views obtained once (e.g. by the setUp of an attribute 
+   *  computer) stay valid until the collection is cleared or destroyed.
    */
-  class AttributeCollection 
-  { 
+  class AttributeCollection
+  {
   public:
     AttributeCollection(); /**< Default constructor. */
 
-    /* ==================== INLINE METHOD ================================================ */    
-    /** 
-     * Get the index of the attribute 'type' within the collection of attributes of the 
-     * this instance. */
-    int attrIndex(AttrType type) { return _attrIndex[type]; }
+    /* ==================== INLINE METHOD ================================================ */
+    /**
+     * Get the index of the attribute 'type' within the collection of attributes of the
+     * this instance (-1 if the attribute has not been pushed). */
+    inline int attrIndex(AttrType type) const
+    {
+      auto t = static_cast<std::size_t>(type);
+      return t < _attrIndex.size() ? _attrIndex[t] : -1;
+    }
+
+    /** Get the type of the values of the attribute stored in the index 'attrIndex'. */
+    inline AttrValueType valueType(int attrIndex) const { return _columns[attrIndex].valueType; }
+
+    /** Get the number of attributes of the collection. */
+    inline std::size_t numberOfAttributes() const { return _columns.size(); }
 
     /* ==================== METHODS ====================================================== */
-    /** Get the attribute values stored in the index 'attrIndex'. */
-    std::vector<double>& operator[](int attrIndex);
-    
-    /** 
-     * Get the value of the attribute stored at index 'attrIndex' from the node with id 
+    /** Get a view (as double) of the attribute values stored in the index 'attrIndex'. */
+    AttributeValues operator[](int attrIndex);
+
+    /**
+     * Get a typed view of the attribute values stored in the index 'attrIndex'. It throws
+     * std::invalid_argument if V is not the value type of the attribute. */
+    template<typename V>
+    AttributeColumn<V> column(int attrIndex);
+
+    /**
+     * Get the value of the attribute stored at index 'attrIndex' from the node with id
      * 'nodeId'. */
-    double get(int attrIndex, int nodeId);
+    double get(int attrIndex, std::size_t nodeId);
 
-    /** 
-     * Reserve space to store values of attribute for the attribute identified by 'type' for a 
+    /**
+     * Reserve space to store values of attribute for the attribute identified by 'type' for a
+     * component tree with 'nNodes' nodes. The values are doubles. */
+    void push(AttrType type, std::size_t nNodes);
+
+    /**
+     * Reserve space to store values of type 'valueType' of the attribute identified by 'type'
+     * for a component tree with 'nNodes' nodes. */
+    void push(AttrType type, std::size_t nNodes, AttrValueType valueType);
+
+    /**
+     * Reserve space to store values of type V of the attribute identified by 'type' for a
      * component tree with 'nNodes' nodes. */
-    void push(AttrType type, int nNodes);
+    template<typename V>
+    void push(AttrType type, std::size_t nNodes);
 
     /** Set the 'value' for the node with id 'nodeId' of the attribute stored in the 'attrIndex'. */
-    void set(int attrIndex, int nodeId, double value);        
+    void set(int attrIndex, std::size_t nodeId, double value);
+
+    /** Get the number of bytes used to store the values of all attributes. */
+    std::size_t memoryUsage() const;
 
     /** Clear attributes of the collection. */
     void clear();
-    
-  private:   
-    int _nextIndex;
-    std::map<AttrType, int> _attrIndex; 
-    std::vector<std::vector<double>> _values;
+
+  private:
+    struct Column
+    {
+      Column(AttrValueType pvalueType, std::size_t psize);
+      Column(const Column &other);
+      Column(Column &&other) = default;
+      Column& operator=(Column other);
+
+      AttrValueType valueType;
+      std::size_t size;
+      /*< Untyped storage (aligned for any value type) holding 'size' values of type 'valueType'. */
+      std::unique_ptr<unsigned char[]> storage; 
+    };
+
+    void checkValueType(int attrIndex, AttrValueType valueType) const;
+
+    std::vector<int> _attrIndex;
+    std::vector<Column> _columns;
   };
+
+  /* ===================== [IMPLEMENTATION ] ================================================= */
+  AttributeValueRef::operator double() const
+  {
+    switch (_type) {
+      case AttrValueType::Int32: return *static_cast<std::int32_t*>(_p);
+      case AttrValueType::Int64: return static_cast<double>(*static_cast<std::int64_t*>(_p));
+      case AttrValueType::Float: return *static_cast<float*>(_p);
+      default: return *static_cast<double*>(_p);
+    }
+  }
+
+  AttributeValueRef& AttributeValueRef::operator=(double v)
+  {
+    switch (_type) {
+      case AttrValueType::Int32: *static_cast<std::int32_t*>(_p) = static_cast<std::int32_t>(v); break;
+      case AttrValueType::Int64: *static_cast<std::int64_t*>(_p) = static_cast<std::int64_t>(v); break;
+      case AttrValueType::Float: *static_cast<float*>(_p) = static_cast<float>(v); break;
+      default: *static_cast<double*>(_p) = v; break;
+    }
+    return *this;
+  }
+
+  template<typename V>
+  AttributeColumn<V> AttributeCollection::column(int attrIndex)
+  {
+    checkValueType(attrIndex, AttrValueTypeOf<V>::value);
+    auto &c = _columns[attrIndex];
+    return AttributeColumn<V>(reinterpret_cast<V*>(c.storage.get()), c.size);
+  }
+
+  template<typename V>
+  void AttributeCollection::push(AttrType type, std::size_t nNodes)
+  {
+    push(type, nNodes, AttrValueTypeOf<V>::value);
+  }
 }
-#endif
\ No newline at end of file
+#endif
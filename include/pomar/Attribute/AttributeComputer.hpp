@@ -1,9 +1,12 @@
 #include <pomar/Core/CRTP.hpp>
 #include <pomar/Attribute/AttributeCollection.hpp>
 #include <pomar/ComponentTree/CTree.hpp>
+#include <pomar/Core/Parallel.hpp>
 
 #include <memory>
 #include <functional>
+#include <vector>
+#include <algorithm>
 
 #ifndef ATTRIBUTE_COMPUTER_HPP_INCLUDED
 #define ATTRIBUTE_COMPUTER_HPP_INCLUDED
@@ -25,81 +28,108 @@ namespace pomar
     AttributeCollection compute(const CTree<T> &ct);    
   };
 
+  /**
+   * Function which runs the incremental algorithm on the component tree 'ct': for each node, from 
+   * the leaves to the root, it calls preProcess(node), merge(node, parent) (if the node has a 
+   * parent) and postProcess(node). With 'nthreads' > 1 the tree is partitioned into disjoint 
+   * subtrees of similar size which are processed concurrently (a function is never called 
+   * concurrently for the same node or for a node and its parent), and then the nodes above them 
+   * are processed sequentially. The calls of each node happen in the same order with respect 
+   * to its children and parent as in the sequential algorithm, so the results are identical. */
+  template<class Tree, class PreProcess, class Merge, class PostProcess>
+  void computeIncrementally(const Tree &ct, int nthreads, PreProcess preProcess, Merge merge,
+    PostProcess postProcess);
+
   /**
    * Class which encapsulates the general incremental algorithm to compute attributes. 
    * One should provide functions: 'preProcess' for a initial computation, 'merge' which 
    * merges the computation of a node with its parent, 'postProcess' for some attributes
    * which need computation after merging, and setup which initialises AttributeCollection 
-   * for the computation of the attribute. */
-  template<class T>
+   * for the computation of the attribute. The computation runs on the component tree 
+   * class 'Tree' (CTree or CompactCTree). */
+  template<class T, class Tree = CTree<T>>
   class IncrementalAttributeComputer : 
-    public virtual AttributeComputer<IncrementalAttributeComputer<T>>
+    public virtual AttributeComputer<IncrementalAttributeComputer<T, Tree>>
   {
   public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
     IncrementalAttributeComputer() = delete;    
 
     /**
      * Constructor which receives the needed functions to implement incremental attribute computation.
      */
     IncrementalAttributeComputer(
-      std::function<void(AttributeCollection&, const CTNode<T>&)> pPreProcess,
-      std::function<void(AttributeCollection&, const CTNode<T>&, const CTNode<T>&)> pMerge,
-      std::function<void(AttributeCollection&, const CTNode<T>&)> pPostProcess,
-      std::function<void(AttributeCollection&, const CTree<T>&)> setUp = 
-        [](AttributeCollection& attrs, const CTree<T>& ct) { });
+      std::function<void(AttributeCollection&, const NodeType&)> pPreProcess,
+      std::function<void(AttributeCollection&, const NodeType&, const NodeType&)> pMerge,
+      std::function<void(AttributeCollection&, const NodeType&)> pPostProcess,
+      std::function<void(AttributeCollection&, const Tree&)> setUp = 
+        [](AttributeCollection& attrs, const Tree& ct) { });
 
     /** General incremental algorithm to compute attributes in an component tree 'ct'. */
-    AttributeCollection doCompute(AttributeCollection &attrs, const CTree<T> &ct);    
+    AttributeCollection doCompute(AttributeCollection &attrs, const Tree &ct);    
+    /** 
+     * General incremental algorithm to compute attributes in an component tree 'ct' with 'nthreads' 
+     * threads (see computeIncrementally). */
+    AttributeCollection doCompute(AttributeCollection &attrs, const Tree &ct, int nthreads);
 
     /** Calls function 'setup' set up in the constructor. */
-    void setUp(AttributeCollection &attrs, const CTree<T> &ct);
+    void setUp(AttributeCollection &attrs, const Tree &ct);
     /** Calls function 'preProcess' set up in the constructor. */
-    void preProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
     /** Calls function 'merge' set up in the constructor. */
-    void merge(AttributeCollection &attrs, const CTNode<T> &node, const CTNode<T> &parent);
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
     /** Calls function 'postProcess' set up in the constructor. */
-    void postProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
 
   private:       
-    std::function<void(AttributeCollection&, const CTNode<T>&)> _preProcess;
-    std::function<void(AttributeCollection&, const CTNode<T>&, const CTNode<T>&)> _merge;
-    std::function<void(AttributeCollection&, const CTNode<T>&)> _postProcess;
-    std::function<void(AttributeCollection&, const CTree<T>&)> _setUp;
+    std::function<void(AttributeCollection&, const NodeType&)> _preProcess;
+    std::function<void(AttributeCollection&, const NodeType&, const NodeType&)> _merge;
+    std::function<void(AttributeCollection&, const NodeType&)> _postProcess;
+    std::function<void(AttributeCollection&, const Tree&)> _setUp;
   };
 
   /** This class is used to compute a collection of attributes which can be computed incrementally. */
-  template<class T>
+  template<class T, class Tree = CTree<T>>
   class IncrementalAttributeComputerCollection
   {
   public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
     /** Blank attribute computer collection constructor. */ 
     IncrementalAttributeComputerCollection();
     /** 
      * Initialise an incremental attribute computer collection with a list of incremental attribute computer
      * 'comps'. */
     IncrementalAttributeComputerCollection(
-      std::initializer_list<std::unique_ptr<IncrementalAttributeComputer<T>>> comps);
+      std::initializer_list<std::unique_ptr<IncrementalAttributeComputer<T, Tree>>> comps);
 
     /** Push an incremental attribute computer at the collection. */
-    void push(std::unique_ptr<IncrementalAttributeComputer<T>> attrComputer);
+    void push(std::unique_ptr<IncrementalAttributeComputer<T, Tree>> attrComputer);
     /** clear collection. */
     void clear();
 
     /** Call funtion 'setUp' for each incremental attribute computer. */
-    void setUp(AttributeCollection &attrs, const CTree<T> &ct);
+    void setUp(AttributeCollection &attrs, const Tree &ct);
     /** Call function 'preProcess' for each incremental attribute computer. */
-    void preProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
     /** Call function 'merge' for each incremental attribute computer. */
-    void merge(AttributeCollection &attrs, const CTNode<T> &node, const CTNode<T> &parent);
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
     /** Call function 'postProcess' for each incremental attribute computer. */
-    void postProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
 
     /** Compute incrementally all incremental attribute computers pushed in this instance's collection.*/
-    AttributeCollection compute(const CTree<T> &ctree);
+    AttributeCollection compute(const Tree &ctree);
+    /** 
+     * Compute incrementally all incremental attribute computers pushed in this instance's collection
+     * with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ctree, int nthreads);
     /** Convert this instance to an Incremental Attribute Collection instance. */
-    std::unique_ptr<IncrementalAttributeComputer<T>> toIncrementalAttributeComputer();
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
   private:
-    std::vector<std::unique_ptr<IncrementalAttributeComputer<T>>> _attrComputers;
+    std::vector<std::unique_ptr<IncrementalAttributeComputer<T, Tree>>> _attrComputers;
   };
     
 
@@ -113,46 +143,134 @@ namespace pomar
     return this->underlying().doCompute(attrs, ct);
   }  
 
+  /* ======================= [ Compute Incrementally ] ========================================== */
+  template<class Tree, class PreProcess, class Merge, class PostProcess>
+  void computeIncrementally(const Tree &ct, int nthreads, PreProcess preProcess, Merge merge,
+    PostProcess postProcess)
+  {
+    // Nodes are stored such that a parent comes before its children, so visiting the ids
+    // backwards visits the children before their parent.
+    const long long n = static_cast<long long>(ct.numberOfNodes());
+    std::vector<long long> weight(nthreads > 1 ? n : 0);
+    for (long long id = 0; id < static_cast<long long>(weight.size()); ++id)
+      weight[id] = 1 + static_cast<long long>(ct.nodeElementIndices(id).size());
+    for (long long id = static_cast<long long>(weight.size()) - 1; id > 0; --id)
+      weight[ct.nodeParent(id)] += weight[id];
+
+    const long long grain = weight.empty() ? 0 : weight[0] / (8LL * nthreads);
+    if (nthreads <= 1 || n < 2 || grain == 0) {
+      for (long long id = n - 1; id >= 0; --id) {
+        const auto &node = ct.node(id);
+        preProcess(node);
+        if (node.parent() != -1) {
+          const auto &nparent = ct.node(node.parent());
+          merge(node, nparent);
+        }
+        postProcess(node);
+      }
+      return;
+    }
+
+    // The subtrees whose weight (nodes and elements) is at most 'grain' and whose parent's is 
+    // greater are independent; they are given to the least loaded thread (largest first). 
+    std::vector<long long> subtrees;
+    for (long long id = 1; id < n; ++id) {
+      if (weight[id] <= grain && weight[ct.nodeParent(id)] > grain)
+        subtrees.push_back(id);
+    }
+    std::sort(subtrees.begin(), subtrees.end(), [&weight](long long a, long long b) { 
+      return weight[a] > weight[b]; });
+
+    std::vector<int> thread(n, -1);
+    std::vector<long long> load(nthreads, 0);
+    std::vector<bool> isSubtreeRoot(n, false);
+    for (auto r : subtrees) {
+      auto t = std::min_element(load.begin(), load.end()) - load.begin();
+      thread[r] = static_cast<int>(t);
+      load[t] += weight[r];
+      isSubtreeRoot[r] = true;
+    }
+    for (long long id = 1; id < n; ++id) {
+      if (!isSubtreeRoot[id])
+        thread[id] = thread[ct.nodeParent(id)];
+    }
+
+    // Each thread gets the list of its node ids in decreasing order, so it only visits its own
+    // nodes. The sequential part visits the nodes above the subtrees and the subtree roots.
+    std::vector<std::vector<long long>> nodes(nthreads);
+    std::vector<long long> sequentialNodes;
+    for (long long id = n - 1; id >= 0; --id) {
+      if (thread[id] != -1)
+        nodes[thread[id]].push_back(id);
+      if (thread[id] == -1 || isSubtreeRoot[id])
+        sequentialNodes.push_back(id);
+    }
+
+    // The root of a subtree is only preprocessed concurrently: its merge into its parent and its 
+    // postProcess are called in the sequential part, in the same order as the sequential algorithm.
+    parallelFor(nthreads, [&](int t) {
+      for (auto id : nodes[t]) {
+        const auto &node = ct.node(id);
+        preProcess(node);
+        if (isSubtreeRoot[id]) continue;
+        const auto &nparent = ct.node(node.parent());
+        merge(node, nparent);
+        postProcess(node);
+      }
+    });
+
+    for (auto id : sequentialNodes) {
+      const auto &node = ct.node(id);
+      if (!isSubtreeRoot[id])
+        preProcess(node);
+      if (node.parent() != -1) {
+        const auto &nparent = ct.node(node.parent());
+        merge(node, nparent);
+      }
+      postProcess(node);
+    }
+  }
+
   /* ======================= [Incremental Attribute Computer ] ================================== */
-  template<class T>
-  IncrementalAttributeComputer<T>::IncrementalAttributeComputer(
-      std::function<void(AttributeCollection&, const CTNode<T>&)> pPreProcess,
-      std::function<void(AttributeCollection&, const CTNode<T>&, const CTNode<T>&)> pMerge,
-      std::function<void(AttributeCollection&, const CTNode<T>&)> pPostProcess,
-      std::function<void(AttributeCollection&, const CTree<T>&)> pSetUp)
+  template<class T, class Tree>
+  IncrementalAttributeComputer<T, Tree>::IncrementalAttributeComputer(
+      std::function<void(AttributeCollection&, const NodeType&)> pPreProcess,
+      std::function<void(AttributeCollection&, const NodeType&, const NodeType&)> pMerge,
+      std::function<void(AttributeCollection&, const NodeType&)> pPostProcess,
+      std::function<void(AttributeCollection&, const Tree&)> pSetUp)
       :_preProcess{pPreProcess}, _merge{pMerge}, _postProcess{pPostProcess}, _setUp{pSetUp}
   {}
 
-  template<class T>
-  void IncrementalAttributeComputer<T>::setUp(AttributeCollection &attrs, const CTree<T> &ct)
+  template<class T, class Tree>
+  void IncrementalAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
   {
     return this->_setUp(attrs, ct);
   }
 
-  template<class T>
-  void IncrementalAttributeComputer<T>::preProcess(AttributeCollection &attrs, const CTNode<T> &node)
+  template<class T, class Tree>
+  void IncrementalAttributeComputer<T, Tree>::preProcess(AttributeCollection &attrs, const NodeType &node)
   {
     this->_preProcess(attrs, node);
   }
 
-  template<class T>
-  void IncrementalAttributeComputer<T>::merge(AttributeCollection &attrs, const CTNode<T> &node,
-   const CTNode<T> &parent)
+  template<class T, class Tree>
+  void IncrementalAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node,
+   const NodeType &parent)
   {
     this->_merge(attrs, node, parent);
   }
 
-  template<class T>
-  void IncrementalAttributeComputer<T>::postProcess(AttributeCollection &attrs, const CTNode<T> &node)
+  template<class T, class Tree>
+  void IncrementalAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
   {
     this->_postProcess(attrs, node);
   }
 
-  template<class T>
-  AttributeCollection IncrementalAttributeComputer<T>::doCompute(AttributeCollection &attrs, const CTree<T> &ct)
+  template<class T, class Tree>
+  AttributeCollection IncrementalAttributeComputer<T, Tree>::doCompute(AttributeCollection &attrs, const Tree &ct)
   {
     this->setUp(attrs, ct);
-    ct.transverse([this, &ct, &attrs](const CTNode<T> &node) {
+    ct.transverse([this, &ct, &attrs](const NodeType &node) {
       this->preProcess(attrs, node);
       if (node.parent() != -1) {
         const auto& nparent = ct.node(node.parent());
@@ -163,87 +281,108 @@ namespace pomar
     return attrs;
   }
 
+  template<class T, class Tree>
+  AttributeCollection IncrementalAttributeComputer<T, Tree>::doCompute(AttributeCollection &attrs, const Tree &ct,
+    int nthreads)
+  {
+    this->setUp(attrs, ct);
+    computeIncrementally(ct, nthreads, 
+      [this, &attrs](const NodeType &node) { this->preProcess(attrs, node); },
+      [this, &attrs](const NodeType &node, const NodeType &parent) { this->merge(attrs, node, parent); },
+      [this, &attrs](const NodeType &node) { this->postProcess(attrs, node); });
+    return attrs;
+  }
+
   /* ====================== [ INCREMENTAL ATTRIBUTE COMPUTER ] ======================================  */
-  template<class T>
-  IncrementalAttributeComputerCollection<T>::IncrementalAttributeComputerCollection()
+  template<class T, class Tree>
+  IncrementalAttributeComputerCollection<T, Tree>::IncrementalAttributeComputerCollection()
   {}
 
-  template<class T>
-  IncrementalAttributeComputerCollection<T>::IncrementalAttributeComputerCollection(
-      std::initializer_list<std::unique_ptr<IncrementalAttributeComputer<T>>> comps)
+  template<class T, class Tree>
+  IncrementalAttributeComputerCollection<T, Tree>::IncrementalAttributeComputerCollection(
+      std::initializer_list<std::unique_ptr<IncrementalAttributeComputer<T, Tree>>> comps)
   {}
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::push(
-    std::unique_ptr<IncrementalAttributeComputer<T>> attrComputer)
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::push(
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> attrComputer)
   {
     _attrComputers.push_back(std::move(attrComputer));
   }
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::clear()
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::clear()
   {
     _attrComputers.clear();
   }
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::setUp(AttributeCollection& attrs, const CTree<T> &ct)
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::setUp(AttributeCollection& attrs, const Tree &ct)
   {
     for (auto &c : _attrComputers)
       c->setUp(attrs, ct);
   }
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::preProcess(AttributeCollection &attrs, 
-    const CTNode<T> &node)
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::preProcess(AttributeCollection &attrs, 
+    const NodeType &node)
   {
     for (auto &c : _attrComputers)
       c->preProcess(attrs, node);
   }
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::merge(AttributeCollection &attrs, 
-    const CTNode<T> &node, const CTNode<T> &parent)
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::merge(AttributeCollection &attrs, 
+    const NodeType &node, const NodeType &parent)
   {
     for (auto &c: _attrComputers)
       c->merge(attrs, node, parent);
   }
 
-  template<class T>
-  void IncrementalAttributeComputerCollection<T>::postProcess(AttributeCollection &attrs,
-    const CTNode<T> &node)
+  template<class T, class Tree>
+  void IncrementalAttributeComputerCollection<T, Tree>::postProcess(AttributeCollection &attrs,
+    const NodeType &node)
   {
     for (auto &c : _attrComputers)
       c->postProcess(attrs, node);
   }
 
-  template<class T>
+  template<class T, class Tree>
   AttributeCollection 
-  IncrementalAttributeComputerCollection<T>::compute(const CTree<T> &ctree)
+  IncrementalAttributeComputerCollection<T, Tree>::compute(const Tree &ctree)
   {
     AttributeCollection attrs;
     auto computer = toIncrementalAttributeComputer();
     return computer->doCompute(attrs, ctree);
   }
 
-  template<class T>
-  std::unique_ptr<IncrementalAttributeComputer<T>> 
-  IncrementalAttributeComputerCollection<T>::toIncrementalAttributeComputer()
+  template<class T, class Tree>
+  AttributeCollection 
+  IncrementalAttributeComputerCollection<T, Tree>::compute(const Tree &ctree, int nthreads)
+  {
+    AttributeCollection attrs;
+    auto computer = toIncrementalAttributeComputer();
+    return computer->doCompute(attrs, ctree, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>> 
+  IncrementalAttributeComputerCollection<T, Tree>::toIncrementalAttributeComputer()
   {
-    auto mySetup = [this] (AttributeCollection &attrs, const CTree<T> &ct) {  this->setUp(attrs, ct); };
-    auto myPreProcess = [this](AttributeCollection &attrs, const CTNode<T> &node) {
+    auto mySetup = [this] (AttributeCollection &attrs, const Tree &ct) {  this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection &attrs, const NodeType &node) {
       this->preProcess(attrs, node);
     };
-    auto myMerge = [this](AttributeCollection &attrs, const CTNode<T> &node, 
-      const CTNode<T>& parent) {
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node, 
+      const NodeType& parent) {
       this->merge(attrs, node, parent);
     };
-    auto myPostProcess = [this](AttributeCollection &attrs, const CTNode<T> &node) {
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
       this->postProcess(attrs, node);
     };
 
-    return std::unique_ptr<IncrementalAttributeComputer<T>>(
-      new IncrementalAttributeComputer<T>(myPreProcess, myMerge, myPostProcess, mySetup));
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
   }
 }
 
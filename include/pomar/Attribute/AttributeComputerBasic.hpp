@@ -1,9 +1,14 @@
 #include <pomar/Attribute/AttributeComputer.hpp>
 #include <pomar/Attribute/AttributeCollection.hpp>
 #include <pomar/ComponentTree/CTree.hpp>
+#include <pomar/ComponentTree/CTMeta.hpp>
 
 #include <memory>
 #include <functional>
+#include <type_traits>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
 
 #ifndef ATTRIBUTE_COMPUTER_BASIC_HPP_INCLUDED
 #define ATTRIBUTE_COMPUTER_BASIC_HPP_INCLUDED
@@ -12,86 +17,227 @@
 
 namespace pomar
 {
-  /** Class which computes area for component tree incrementally. */
-  template<class T>
+  /** 
+   * Class which computes area for component tree incrementally. The area is stored as a 32-bit 
+   * integer, or as a 64-bit one for trees whose index type is wider than 32 bits. */
+  template<class T, class Tree = CTree<T>>
   class AreaAttributeComputer
   {
   public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+    /** Type of the area values. */
+    using AreaType = typename std::conditional<(sizeof(typename Tree::IndexType) > 4), 
+      std::int64_t, std::int32_t>::type;
+
     /** 
      * Set up AttributeCollection 'attrs' to store area for each node of the 
      * component tree 'ct'. */
-    void setUp(AttributeCollection &attrs, const CTree<T> &ct);
+    void setUp(AttributeCollection &attrs, const Tree &ct);
     /** 'PreProcess' function of the incremental algorithm to compute area.  */
-    void preProcess(AttributeCollection& attrs, const CTNode<T> &node);
+    void preProcess(AttributeCollection& attrs, const NodeType &node);
     /** 'merge' function of the incremental algorithm to compute area.  */
-    void merge(AttributeCollection &attrs, const CTNode<T> &node, 
-      const CTNode<T> &parent);
+    void merge(AttributeCollection &attrs, const NodeType &node, 
+      const NodeType &parent);
     /** 'postProcess' function of the incremental algorithm to compute area.  */
-    void postProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
 
     /** Compute area for each component tree 'ct' node. */
-    AttributeCollection compute(const CTree<T> &ct);
+    AttributeCollection compute(const Tree &ct);
+    /** Compute area for each component tree 'ct' node with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ct, int nthreads);
     /** Convert this instance to an incremental attribute computer.*/
-    std::unique_ptr<IncrementalAttributeComputer<T>> toIncrementalAttributeComputer();
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
   private:
-    int _myIndex;
+    AttributeColumn<AreaType> _area;
+  };
+
+  /** 
+   * Class which computes the bounding box (BOUNDING_BOX_MIN_X, BOUNDING_BOX_MIN_Y, 
+   * BOUNDING_BOX_MAX_X and BOUNDING_BOX_MAX_Y, inclusive pixel coordinates stored as 32-bit 
+   * integers) of the nodes of the component tree of a 2D image (CTMetaImage2D) incrementally. */
+  template<class T, class Tree = CTree<T>>
+  class BoundingBoxAttributeComputer
+  {
+  public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
+    /** 
+     * Set up AttributeCollection 'attrs' to store the bounding box for each node of the 
+     * component tree 'ct'. It throws std::invalid_argument if 'ct' is not built from a 2D image. */
+    void setUp(AttributeCollection &attrs, const Tree &ct);
+    /** 'PreProcess' function: bounding box of the elements of the node. */
+    void preProcess(AttributeCollection& attrs, const NodeType &node);
+    /** 'merge' function: extend the bounding box of 'parent' by the one of 'node'. */
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
+    /** 'postProcess' function (nothing to be done). */
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
+
+    /** Compute the bounding box for each component tree 'ct' node. */
+    AttributeCollection compute(const Tree &ct);
+    /** Compute the bounding box for each component tree 'ct' node with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ct, int nthreads);
+    /** Convert this instance to an incremental attribute computer.*/
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
+  private:
+    AttributeColumn<std::int32_t> _xmin, _ymin, _xmax, _ymax;
+    int _width;
   };
 
   /* ===================== [IMPLEMENTATION ] ================================================= */
   /* ================ [ AREA ATTRIBUTE COMPUTER ] ============================================ */
-  template<class T>
-  void AreaAttributeComputer<T>::setUp(AttributeCollection &attrs, const CTree<T> &ct)
+  template<class T, class Tree>
+  void AreaAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
   { 
-    attrs.push(AttrType::AREA, ct.numberOfNodes());
-    _myIndex = attrs.attrIndex(AttrType::AREA);
+    attrs.push<AreaType>(AttrType::AREA, ct.numberOfNodes());
+    _area = attrs.column<AreaType>(attrs.attrIndex(AttrType::AREA));
   }
 
-  template<class T>
-  void AreaAttributeComputer<T>::preProcess(AttributeCollection& attrs, 
-    const CTNode<T> &node)
+  template<class T, class Tree>
+  void AreaAttributeComputer<T, Tree>::preProcess(AttributeCollection& attrs, 
+    const NodeType &node)
   {
-    attrs[_myIndex][node.id()] += node.elementIndices().size();
+    _area[node.id()] += node.elementIndices().size();
   }
 
-  template<class T>
-  void AreaAttributeComputer<T>::merge(AttributeCollection &attrs, const CTNode<T> &node, 
-    const CTNode<T> &parent)
+  template<class T, class Tree>
+  void AreaAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node, 
+    const NodeType &parent)
   {
-    attrs[_myIndex][parent.id()] += attrs[_myIndex][node.id()];
+    _area[parent.id()] += _area[node.id()];
   }
 
-  template<class T>
-  void AreaAttributeComputer<T>::postProcess(AttributeCollection &attrs, const CTNode<T> &node)
+  template<class T, class Tree>
+  void AreaAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
   {
     /*This method is kept empty. */
   }
 
-  template<class T>
-  AttributeCollection AreaAttributeComputer<T>::compute(const CTree<T> &ct)
+  template<class T, class Tree>
+  AttributeCollection AreaAttributeComputer<T, Tree>::compute(const Tree &ct)
   {
     auto computer = toIncrementalAttributeComputer();
     AttributeCollection attrs;
     return computer->doCompute(attrs, ct);
   }
 
-  template<class T>
-  std::unique_ptr<IncrementalAttributeComputer<T>> 
-    AreaAttributeComputer<T>::toIncrementalAttributeComputer()
+  template<class T, class Tree>
+  AttributeCollection AreaAttributeComputer<T, Tree>::compute(const Tree &ct, int nthreads)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>> 
+    AreaAttributeComputer<T, Tree>::toIncrementalAttributeComputer()
+  {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection& attrs, const NodeType &node) {
+      this->preProcess(attrs, node);
+    };
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node, 
+      const NodeType &parent) {
+      this->merge(attrs, node, parent);
+    };
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
+      this->postProcess(attrs, node);
+    };
+
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
+  }
+
+  /* ================ [ BOUNDING BOX ATTRIBUTE COMPUTER ] ==================================== */
+  template<class T, class Tree>
+  void BoundingBoxAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
+  {
+    auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(ct.meta());
+    if (!meta)
+      throw std::invalid_argument("the bounding box needs a component tree of a 2D image");
+    _width = meta->width();
+
+    const std::size_t n = ct.numberOfNodes();
+    attrs.push<std::int32_t>(AttrType::BOUNDING_BOX_MIN_X, n); 
+    attrs.push<std::int32_t>(AttrType::BOUNDING_BOX_MIN_Y, n);
+    attrs.push<std::int32_t>(AttrType::BOUNDING_BOX_MAX_X, n); 
+    attrs.push<std::int32_t>(AttrType::BOUNDING_BOX_MAX_Y, n);
+    _xmin = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_X)); 
+    _ymin = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_Y));
+    _xmax = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_X)); 
+    _ymax = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_Y));
+
+    std::fill(_xmin.begin(), _xmin.end(), meta->width());
+    std::fill(_ymin.begin(), _ymin.end(), meta->height());
+    std::fill(_xmax.begin(), _xmax.end(), -1);
+    std::fill(_ymax.begin(), _ymax.end(), -1);
+  }
+
+  template<class T, class Tree>
+  void BoundingBoxAttributeComputer<T, Tree>::preProcess(AttributeCollection& attrs, 
+    const NodeType &node)
+  {
+    std::int32_t x0 = _xmin[node.id()], y0 = _ymin[node.id()], x1 = _xmax[node.id()], y1 = _ymax[node.id()];
+    for (auto elem : node.elementIndices()) {
+      std::int32_t x = static_cast<std::int32_t>(elem % _width), y = static_cast<std::int32_t>(elem / _width);
+      x0 = std::min(x0, x); y0 = std::min(y0, y);
+      x1 = std::max(x1, x); y1 = std::max(y1, y);
+    }
+    _xmin[node.id()] = x0; _ymin[node.id()] = y0; _xmax[node.id()] = x1; _ymax[node.id()] = y1;
+  }
+
+  template<class T, class Tree>
+  void BoundingBoxAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node, 
+    const NodeType &parent)
+  {
+    _xmin[parent.id()] = std::min(_xmin[parent.id()], _xmin[node.id()]);
+    _ymin[parent.id()] = std::min(_ymin[parent.id()], _ymin[node.id()]);
+    _xmax[parent.id()] = std::max(_xmax[parent.id()], _xmax[node.id()]);
+    _ymax[parent.id()] = std::max(_ymax[parent.id()], _ymax[node.id()]);
+  }
+
+  template<class T, class Tree>
+  void BoundingBoxAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    /*This method is kept empty. */
+  }
+
+  template<class T, class Tree>
+  AttributeCollection BoundingBoxAttributeComputer<T, Tree>::compute(const Tree &ct)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct);
+  }
+
+  template<class T, class Tree>
+  AttributeCollection BoundingBoxAttributeComputer<T, Tree>::compute(const Tree &ct, int nthreads)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>> 
+    BoundingBoxAttributeComputer<T, Tree>::toIncrementalAttributeComputer()
   {
-    auto mySetup = [this](AttributeCollection &attrs, const CTree<T> &ct) { this->setUp(attrs, ct); };
-    auto myPreProcess = [this](AttributeCollection& attrs, const CTNode<T> &node) {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection& attrs, const NodeType &node) {
       this->preProcess(attrs, node);
     };
-    auto myMerge = [this](AttributeCollection &attrs, const CTNode<T> &node, 
-      const CTNode<T> &parent) {
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node, 
+      const NodeType &parent) {
       this->merge(attrs, node, parent);
     };
-    auto myPostProcess = [this](AttributeCollection &attrs, const CTNode<T> &node) {
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
       this->postProcess(attrs, node);
     };
 
-    return std::unique_ptr<IncrementalAttributeComputer<T>>(
-      new IncrementalAttributeComputer<T>(myPreProcess, myMerge, myPostProcess, mySetup));
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
   }
 }
-#endif  
\ No newline at end of file
+#endif
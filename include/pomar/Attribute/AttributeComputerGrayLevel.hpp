@@ -0,0 +1,192 @@
+#include <pomar/Attribute/AttributeComputer.hpp>
+#include <pomar/Attribute/AttributeCollection.hpp>
+#include <pomar/ComponentTree/CTree.hpp>
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#ifndef ATTRIBUTE_COMPUTER_GRAY_LEVEL_HPP_INCLUDED
+#define ATTRIBUTE_COMPUTER_GRAY_LEVEL_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+   * Class which computes the gray-level attributes of the nodes of a component tree (max-tree or
+   * min-tree) incrementally:
+   *  - MIN_LEVEL and MAX_LEVEL: the lowest and highest levels of the pixels of the node;
+   *  - HEIGHT: MAX_LEVEL - MIN_LEVEL, i.e. the contrast of the node (the difference between the
+   *    level of the node and the level of its most extreme descendant);
+   *  - VOLUME: the sum of |f(p) - level(node)| over the pixels p of the node;
+   *  - MEAN_LEVEL and LEVEL_VARIANCE: the mean and the variance of the levels of the pixels of
+   *    the node.
+   * The elements of a node all have the level of the node, so each node is processed in constant
+   * time from its number of elements and the whole computation is linear in the number of nodes
+   * (the image is not accessed). The values are stored as doubles. */
+  template<class T, class Tree = CTree<T>>
+  class GrayLevelAttributeComputer
+  {
+  public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
+    /** Set up AttributeCollection 'attrs' to store the attributes for each node of 'ct'. */
+    void setUp(AttributeCollection &attrs, const Tree &ct);
+    /** 'PreProcess' function: levels of the elements of the node. */
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
+    /** 'merge' function: add the levels of 'node' to the ones of 'parent'. */
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
+    /** 'postProcess' function: compute the attributes of the node from its sums. */
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
+
+    /** Compute the gray-level attributes for each component tree 'ct' node. */
+    AttributeCollection compute(const Tree &ct);
+    /** Compute the gray-level attributes for each component tree 'ct' node with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ct, int nthreads);
+    /** Convert this instance to an incremental attribute computer.*/
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
+  private:
+    struct LevelSums { std::int64_t n; double sum, sumSquares; };
+
+    std::vector<LevelSums> _sums;
+    AttributeColumn<double> _min, _max, _height, _volume, _mean, _variance;
+  };
+
+  /**
+   * Compute the extinction value of each node of the component tree 'ct' with respect to the
+   * increasing attribute 'attr' (one value per node, e.g. attrs[attrs.attrIndex(AttrType::AREA)]).
+   * A branch of the tree is followed from a node to its child with the largest attribute (the
+   * one with the smallest id on ties); a node which is not followed by its parent starts a new
+   * branch, whose extinction value is the attribute of its first node (the root's branch
+   * extinction value is the attribute of the root). The extinction value of a node is the one of
+   * its branch, so the extinction value of a leaf is the largest value of 'attr' for which its
+   * regional extremum survives the attribute filter. It runs in time linear in the number of
+   * nodes. */
+  template<class Tree>
+  std::vector<double> extinctionValues(const Tree &ct, const AttributeValues &attr);
+
+  /* ===================== [IMPLEMENTATION ] ================================================= */
+  template<class T, class Tree>
+  void GrayLevelAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
+  {
+    const std::size_t n = ct.numberOfNodes();
+    _sums.assign(n, LevelSums{0, 0.0, 0.0});
+    attrs.push(AttrType::MIN_LEVEL, n); attrs.push(AttrType::MAX_LEVEL, n);
+    attrs.push(AttrType::HEIGHT, n); attrs.push(AttrType::VOLUME, n);
+    attrs.push(AttrType::MEAN_LEVEL, n); attrs.push(AttrType::LEVEL_VARIANCE, n);
+
+    auto column = [&attrs](AttrType type) { return attrs.column<double>(attrs.attrIndex(type)); };
+    _min = column(AttrType::MIN_LEVEL); _max = column(AttrType::MAX_LEVEL);
+    _height = column(AttrType::HEIGHT); _volume = column(AttrType::VOLUME);
+    _mean = column(AttrType::MEAN_LEVEL); _variance = column(AttrType::LEVEL_VARIANCE);
+
+    // The children are merged into a node before its own elements are processed.
+    std::fill(_min.begin(), _min.end(), std::numeric_limits<double>::infinity());
+    std::fill(_max.begin(), _max.end(), -std::numeric_limits<double>::infinity());
+  }
+
+  template<class T, class Tree>
+  void GrayLevelAttributeComputer<T, Tree>::preProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    const double level = static_cast<double>(node.level());
+    const std::int64_t n = node.elementIndices().size();
+    auto &s = _sums[node.id()];
+    s.n += n;
+    s.sum += n * level;
+    s.sumSquares += n * level * level;
+    _min[node.id()] = std::min(_min[node.id()], level);
+    _max[node.id()] = std::max(_max[node.id()], level);
+  }
+
+  template<class T, class Tree>
+  void GrayLevelAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node,
+    const NodeType &parent)
+  {
+    auto &s = _sums[parent.id()];
+    const auto &c = _sums[node.id()];
+    s.n += c.n; s.sum += c.sum; s.sumSquares += c.sumSquares;
+
+    _min[parent.id()] = std::min(_min[parent.id()], _min[node.id()]);
+    _max[parent.id()] = std::max(_max[parent.id()], _max[node.id()]);
+  }
+
+  template<class T, class Tree>
+  void GrayLevelAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    const auto &s = _sums[node.id()];
+    const double level = static_cast<double>(node.level());
+    const double mean = s.n > 0 ? s.sum / s.n : level;
+    _height[node.id()] = _max[node.id()] - _min[node.id()];
+    _volume[node.id()] = std::abs(s.sum - s.n * level);
+    _mean[node.id()] = mean;
+    _variance[node.id()] = s.n > 0 ? std::max(0.0, s.sumSquares / s.n - mean * mean) : 0.0;
+  }
+
+  template<class T, class Tree>
+  AttributeCollection GrayLevelAttributeComputer<T, Tree>::compute(const Tree &ct)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct);
+  }
+
+  template<class T, class Tree>
+  AttributeCollection GrayLevelAttributeComputer<T, Tree>::compute(const Tree &ct, int nthreads)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>>
+    GrayLevelAttributeComputer<T, Tree>::toIncrementalAttributeComputer()
+  {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection& attrs, const NodeType &node) {
+      this->preProcess(attrs, node);
+    };
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node,
+      const NodeType &parent) {
+      this->merge(attrs, node, parent);
+    };
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
+      this->postProcess(attrs, node);
+    };
+
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
+  }
+
+  template<class Tree>
+  std::vector<double> extinctionValues(const Tree &ct, const AttributeValues &attr)
+  {
+    using IndexT = typename Tree::IndexType;
+    const IndexT n = static_cast<IndexT>(ct.numberOfNodes());
+    std::vector<double> ext(n);
+    if (n == 0) return ext;
+
+    // The child of each node with the largest attribute. The ids are visited backwards, so the
+    // child with the smallest id wins on ties.
+    std::vector<IndexT> mainChild(n, -1);
+    for (IndexT id = n - 1; id > 0; --id) {
+      IndexT p = ct.nodeParent(id);
+      if (mainChild[p] == -1 || attr[id] >= attr[mainChild[p]])
+        mainChild[p] = id;
+    }
+
+    // Parents come before their children, so the extinction value of the parent is known.
+    ext[0] = attr[0];
+    for (IndexT id = 1; id < n; ++id) {
+      IndexT p = ct.nodeParent(id);
+      ext[id] = mainChild[p] == id ? ext[p] : static_cast<double>(attr[id]);
+    }
+    return ext;
+  }
+}
+#endif
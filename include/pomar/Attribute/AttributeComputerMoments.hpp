@@ -0,0 +1,374 @@
+#include <pomar/Attribute/AttributeComputer.hpp>
+#include <pomar/Attribute/AttributeCollection.hpp>
+#include <pomar/ComponentTree/CTree.hpp>
+#include <pomar/ComponentTree/CTMeta.hpp>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#ifndef ATTRIBUTE_COMPUTER_MOMENTS_HPP_INCLUDED
+#define ATTRIBUTE_COMPUTER_MOMENTS_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+   * Sums of the powers (up to the second order) of the coordinates of a set of pixels. The
+   * coordinates are relative to the centre of the image, which keeps the sums small enough to be
+   * accumulated exactly in 64-bit integers for images of up to about 77000x77000 pixels (see 
+   * checkMomentSumsRange). */
+  struct SecondOrderMomentSums
+  {
+    static const int order = 2; /**< Highest order of the sums. */
+    std::int64_t n, x, y, xx, xy, yy;
+
+    /** Add the pixel (x, y) (coordinates relative to the centre of the image). */
+    inline void add(std::int64_t px, std::int64_t py)
+    {
+      n++; x += px; y += py;
+      xx += px*px; xy += px*py; yy += py*py;
+    }
+
+    /** Add the sums of another set of pixels. */
+    inline SecondOrderMomentSums& operator+=(const SecondOrderMomentSums &s)
+    {
+      n += s.n; x += s.x; y += s.y; xx += s.xx; xy += s.xy; yy += s.yy;
+      return *this;
+    }
+  };
+
+  /**
+   * Sums of the powers (up to the third order) of the coordinates of a set of pixels, relative to
+   * the centre of the image. They are exact in 64-bit integers for images of up to about 
+   * 9400x9400 pixels (see checkMomentSumsRange). */
+  struct MomentSums
+  {
+    static const int order = 3; /**< Highest order of the sums. */
+    std::int64_t n, x, y, xx, xy, yy, xxx, xxy, xyy, yyy;
+
+    /** Add the pixel (x, y) (coordinates relative to the centre of the image). */
+    inline void add(std::int64_t px, std::int64_t py)
+    {
+      n++; x += px; y += py;
+      xx += px*px; xy += px*py; yy += py*py;
+      xxx += px*px*px; xxy += px*px*py; xyy += px*py*py; yyy += py*py*py;
+    }
+
+    /** Add the sums of another set of pixels. */
+    inline MomentSums& operator+=(const MomentSums &s)
+    {
+      n += s.n; x += s.x; y += s.y; xx += s.xx; xy += s.xy; yy += s.yy;
+      xxx += s.xxx; xxy += s.xxy; xyy += s.xyy; yyy += s.yyy;
+      return *this;
+    }
+  };
+
+  /** Central moments (up to the third order) of a set of pixels. */
+  struct CentralMoments
+  {
+    double mu20, mu02, mu11, mu30, mu03, mu21, mu12;
+  };
+
+  /** Compute the central moments of the set of pixels whose sums are 's' (s.n > 0). */
+  CentralMoments centralMoments(const MomentSums &s);
+
+  /**
+   * Compute the second-order central moments of the set of pixels whose sums are 's' (s.n > 0);
+   * the third-order ones are set to 0. */
+  CentralMoments centralMoments(const SecondOrderMomentSums &s);
+
+  /**
+   * Check that the moment sums up to the order 'order' of any set of pixels of a 'width' x 
+   * 'height' image are exact in 64-bit integers. It throws std::invalid_argument otherwise. */
+  void checkMomentSumsRange(int width, int height, int order);
+
+  /**
+   * Eccentricity of the ellipse with the same second-order central moments: sqrt(1 - l2/l1)
+   * where l1 >= l2 are the eigenvalues of the covariance matrix (0 for a single pixel). */
+  double eccentricity(const CentralMoments &mu);
+
+  /**
+   * Orientation (in radians, in (-pi/2, pi/2]) of the major axis of the ellipse with the same
+   * second-order central moments, measured from the x axis towards the y axis (image rows). */
+  double orientation(const CentralMoments &mu);
+
+  /** The seven Hu moment invariants of a set of 'n' pixels whose central moments are 'mu'. */
+  std::array<double, 7> huMoments(const CentralMoments &mu, std::int64_t n);
+
+  /**
+   * Base class of the attribute computers which accumulate the moment sums (SecondOrderMomentSums
+   * or MomentSums) of the nodes of the component tree of a 2D image (CTMetaImage2D). The sums of 
+   * each node are kept by the computer (not in the AttributeCollection) while the tree is 
+   * transversed. */
+  template<class Tree, class Sums = MomentSums>
+  class MomentSumsComputer
+  {
+  public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
+  protected:
+    /** Initialise the sums of the nodes of 'ct'. It throws std::invalid_argument if 'ct' is not
+     *  built from a 2D image or if the image is too large for the sums to be exact. */
+    void setUpSums(const Tree &ct);
+    /** Add the elements of 'node' to its sums. */
+    void addElements(const NodeType &node);
+    /** Add the sums of 'node' to the ones of 'parent'. */
+    void mergeSums(const NodeType &node, const NodeType &parent);
+
+    /** Offset of the x coordinate to the relative coordinates of the sums. */
+    inline double originX() const { return _width / 2; }
+    /** Offset of the y coordinate to the relative coordinates of the sums. */
+    inline double originY() const { return _height / 2; }
+
+    std::vector<Sums> _sums;
+  private:
+    int _width, _height;
+  };
+
+  /**
+   * Class which computes the centroid (CENTROID_X, CENTROID_Y), the second-order central moments
+   * (CENTRAL_MOMENT_20, CENTRAL_MOMENT_02, CENTRAL_MOMENT_11), the ECCENTRICITY and the ORIENTATION
+   * of the nodes of the component tree of a 2D image incrementally. Only the sums up to the 
+   * second order are accumulated (48 bytes per node). */
+  template<class T, class Tree = CTree<T>>
+  class CentralMomentsAttributeComputer : public MomentSumsComputer<Tree, SecondOrderMomentSums>
+  {
+  public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
+    /** Set up AttributeCollection 'attrs' to store the attributes for each node of 'ct'. */
+    void setUp(AttributeCollection &attrs, const Tree &ct);
+    /** 'PreProcess' function: sums of the elements of the node. */
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
+    /** 'merge' function: add the sums of 'node' to the ones of 'parent'. */
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
+    /** 'postProcess' function: compute the attributes of the node from its sums. */
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
+
+    /** Compute the attributes for each component tree 'ct' node. */
+    AttributeCollection compute(const Tree &ct);
+    /** Compute the attributes for each component tree 'ct' node with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ct, int nthreads);
+    /** Convert this instance to an incremental attribute computer.*/
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
+  private:
+    AttributeColumn<double> _cx, _cy, _mu20, _mu02, _mu11, _ecc, _orient;
+  };
+
+  /**
+   * Class which computes the seven Hu moment invariants (HU_MOMENT_1 to HU_MOMENT_7) of the nodes
+   * of the component tree of a 2D image incrementally. */
+  template<class T, class Tree = CTree<T>>
+  class HuMomentsAttributeComputer : public MomentSumsComputer<Tree, MomentSums>
+  {
+  public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+
+    /** Set up AttributeCollection 'attrs' to store the Hu moments for each node of 'ct'. */
+    void setUp(AttributeCollection &attrs, const Tree &ct);
+    /** 'PreProcess' function: sums of the elements of the node. */
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
+    /** 'merge' function: add the sums of 'node' to the ones of 'parent'. */
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
+    /** 'postProcess' function: compute the Hu moments of the node from its sums. */
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
+
+    /** Compute the Hu moments for each component tree 'ct' node. */
+    AttributeCollection compute(const Tree &ct);
+    /** Compute the Hu moments for each component tree 'ct' node with 'nthreads' threads. */
+    AttributeCollection compute(const Tree &ct, int nthreads);
+    /** Convert this instance to an incremental attribute computer.*/
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
+  private:
+    AttributeColumn<double> _hu[7];
+  };
+
+  /* ===================== [IMPLEMENTATION ] ================================================= */
+  /* ====================== [ MOMENT SUMS COMPUTER ] ========================================= */
+  template<class Tree, class Sums>
+  void MomentSumsComputer<Tree, Sums>::setUpSums(const Tree &ct)
+  {
+    auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(ct.meta());
+    if (!meta)
+      throw std::invalid_argument("moments need a component tree of a 2D image");
+    checkMomentSumsRange(meta->width(), meta->height(), Sums::order);
+    _width = meta->width();
+    _height = meta->height();
+    _sums.assign(ct.numberOfNodes(), Sums());
+  }
+
+  template<class Tree, class Sums>
+  void MomentSumsComputer<Tree, Sums>::addElements(const NodeType &node)
+  {
+    const std::int64_t ox = _width / 2, oy = _height / 2;
+    auto &s = _sums[node.id()];
+    for (auto elem : node.elementIndices())
+      s.add(elem % _width - ox, elem / _width - oy);
+  }
+
+  template<class Tree, class Sums>
+  void MomentSumsComputer<Tree, Sums>::mergeSums(const NodeType &node, const NodeType &parent)
+  {
+    _sums[parent.id()] += _sums[node.id()];
+  }
+
+  /* ================= [ CENTRAL MOMENTS ATTRIBUTE COMPUTER ] ================================ */
+  template<class T, class Tree>
+  void CentralMomentsAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
+  {
+    this->setUpSums(ct);
+    const std::size_t n = ct.numberOfNodes();
+    attrs.push(AttrType::CENTROID_X, n); attrs.push(AttrType::CENTROID_Y, n);
+    attrs.push(AttrType::CENTRAL_MOMENT_20, n); attrs.push(AttrType::CENTRAL_MOMENT_02, n);
+    attrs.push(AttrType::CENTRAL_MOMENT_11, n);
+    attrs.push(AttrType::ECCENTRICITY, n); attrs.push(AttrType::ORIENTATION, n);
+
+    auto column = [&attrs](AttrType type) { return attrs.column<double>(attrs.attrIndex(type)); };
+    _cx = column(AttrType::CENTROID_X); _cy = column(AttrType::CENTROID_Y);
+    _mu20 = column(AttrType::CENTRAL_MOMENT_20); _mu02 = column(AttrType::CENTRAL_MOMENT_02);
+    _mu11 = column(AttrType::CENTRAL_MOMENT_11);
+    _ecc = column(AttrType::ECCENTRICITY); _orient = column(AttrType::ORIENTATION);
+  }
+
+  template<class T, class Tree>
+  void CentralMomentsAttributeComputer<T, Tree>::preProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    this->addElements(node);
+  }
+
+  template<class T, class Tree>
+  void CentralMomentsAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node,
+    const NodeType &parent)
+  {
+    this->mergeSums(node, parent);
+  }
+
+  template<class T, class Tree>
+  void CentralMomentsAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    const auto &s = this->_sums[node.id()];
+    auto mu = centralMoments(s);
+    _cx[node.id()] = this->originX() + static_cast<double>(s.x) / s.n;
+    _cy[node.id()] = this->originY() + static_cast<double>(s.y) / s.n;
+    _mu20[node.id()] = mu.mu20;
+    _mu02[node.id()] = mu.mu02;
+    _mu11[node.id()] = mu.mu11;
+    _ecc[node.id()] = eccentricity(mu);
+    _orient[node.id()] = orientation(mu);
+  }
+
+  template<class T, class Tree>
+  AttributeCollection CentralMomentsAttributeComputer<T, Tree>::compute(const Tree &ct)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct);
+  }
+
+  template<class T, class Tree>
+  AttributeCollection CentralMomentsAttributeComputer<T, Tree>::compute(const Tree &ct, int nthreads)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>>
+    CentralMomentsAttributeComputer<T, Tree>::toIncrementalAttributeComputer()
+  {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection& attrs, const NodeType &node) {
+      this->preProcess(attrs, node);
+    };
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node,
+      const NodeType &parent) {
+      this->merge(attrs, node, parent);
+    };
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
+      this->postProcess(attrs, node);
+    };
+
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
+  }
+
+  /* =================== [ HU MOMENTS ATTRIBUTE COMPUTER ] =================================== */
+  template<class T, class Tree>
+  void HuMomentsAttributeComputer<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
+  {
+    this->setUpSums(ct);
+    const AttrType types[7] = {AttrType::HU_MOMENT_1, AttrType::HU_MOMENT_2, AttrType::HU_MOMENT_3,
+      AttrType::HU_MOMENT_4, AttrType::HU_MOMENT_5, AttrType::HU_MOMENT_6, AttrType::HU_MOMENT_7};
+    for (int i = 0; i < 7; ++i) {
+      attrs.push(types[i], ct.numberOfNodes());
+      _hu[i] = attrs.column<double>(attrs.attrIndex(types[i]));
+    }
+  }
+
+  template<class T, class Tree>
+  void HuMomentsAttributeComputer<T, Tree>::preProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    this->addElements(node);
+  }
+
+  template<class T, class Tree>
+  void HuMomentsAttributeComputer<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node,
+    const NodeType &parent)
+  {
+    this->mergeSums(node, parent);
+  }
+
+  template<class T, class Tree>
+  void HuMomentsAttributeComputer<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
+  {
+    const auto &s = this->_sums[node.id()];
+    auto hu = huMoments(centralMoments(s), s.n);
+    for (int i = 0; i < 7; ++i)
+      _hu[i][node.id()] = hu[i];
+  }
+
+  template<class T, class Tree>
+  AttributeCollection HuMomentsAttributeComputer<T, Tree>::compute(const Tree &ct)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct);
+  }
+
+  template<class T, class Tree>
+  AttributeCollection HuMomentsAttributeComputer<T, Tree>::compute(const Tree &ct, int nthreads)
+  {
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>>
+    HuMomentsAttributeComputer<T, Tree>::toIncrementalAttributeComputer()
+  {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection& attrs, const NodeType &node) {
+      this->preProcess(attrs, node);
+    };
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node,
+      const NodeType &parent) {
+      this->merge(attrs, node, parent);
+    };
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
+      this->postProcess(attrs, node);
+    };
+
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
+  }
+}
+#endif
@@ -1,8 +1,12 @@
-#include <pomar/Core/PixelIndexer.hpp>
+#include <pomar/Math/Point.hpp>
 #include <pomar/Attribute/AttributeComputer.hpp>
+#include <pomar/Attribute/QuadsDecisionTables.hpp>
 
-#include <fstream>
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
 
 #ifndef ATTRIBUTE_COMPUTER_QUADS_HPP_INCLUDED
 #define ATTRIBUTE_COMPUTER_QUADS_HPP_INCLUDED
@@ -22,17 +26,39 @@ namespace pomar
   class AttributeFromQuadsComputer
   {
   public:
-    /** Method which setups attributres indices and Quads connectivity. */
+    /** 
+     * Method which setups attributres indices and Quads connectivity, and resolves the columns
+     * read by counts() and written by setValue(). */
     void setUp(AttributeCollection &attrs, QConnectivity con);
     /** Interface for compute attribute of the node with nodeId identification. */
     virtual void compute(size_t nodeId, AttributeCollection &attrs) = 0;
     /** Interface to indicates the attribute type which the class computes. */
     virtual AttrType attrType() = 0;
+    /** 
+     * Type of the values of the attribute (double by default). Integer attributes (Int32) are
+     * stored as Int64 for trees whose index type is wider than 32 bits, as the quads counts. */
+    virtual AttrValueType valueType() { return AttrValueType::Double; }
 
   protected:
+    /** Quads counts of a node. */
+    struct QuadsCounts { std::int64_t q1, q2, qd, q3, q4; };
+
+    /** Get the quads counts of the node 'nodeId' (32 or 64-bit counts, see setUp). */
+    inline QuadsCounts counts(size_t nodeId) const;
+    /** Set the value of the attribute of the node 'nodeId' (converted to its value type). */
+    inline void setValue(size_t nodeId, double value);
+
     int _p1, _p2, _pd, _p3, _p4;
     int _attrIdx; 
     QConnectivity _con;
+
+  private:
+    // Counts Q1, Q2, QD, Q3 and Q4 of the collection: either the 32 or the 64-bit ones are set.
+    const std::int32_t *_counts32[5];
+    const std::int64_t *_counts64[5];
+    void *_values;
+    AttrValueType _valueType;
+    std::size_t _valueSize;
   };
 
   /** Class which computes discrete area from Quads counting. */
@@ -41,6 +67,8 @@ namespace pomar
   public:
     /** Return QUADS_AREA attribute type. */
     inline AttrType attrType() { return AttrType::QUADS_AREA; }
+    /** The value is stored as an integer. */
+    inline AttrValueType valueType() { return AttrValueType::Int32; }
     /** Compute discrete area from Quads counting.  */ 
     void compute(size_t nodeId, AttributeCollection &attrs);
   };
@@ -51,6 +79,8 @@ namespace pomar
   public:
     /** Return QUADS_CONTINUOUS_AREA attribute type.  */
     inline AttrType attrType() { return AttrType::QUADS_CONTINUOUS_AREA; }
+    /** The value is stored as a float. */
+    inline AttrValueType valueType() { return AttrValueType::Float; }
     /** Compute continuous area approximation from Quads counting. */
     void compute(size_t nodeId, AttributeCollection &attrs);
   };
@@ -61,6 +91,8 @@ namespace pomar
   public:
     /** Return QUADS_PERIMETER attribute type. */
     inline AttrType attrType() { return AttrType::QUADS_PERIMETER; }
+    /** The value is stored as an integer. */
+    inline AttrValueType valueType() { return AttrValueType::Int32; }
     /** Compute discrete perimeter from Quads counting. */
     void compute(size_t nodeId, AttributeCollection &attrs);
   };
@@ -71,6 +103,8 @@ namespace pomar
   public:
     /** Return QUADS_CONTINUOUS attribute type.  */
     inline AttrType attrType() { return AttrType::QUADS_CONTINUOUS_PERIMETER; }
+    /** The value is stored as a float. */
+    inline AttrValueType valueType() { return AttrValueType::Float; }
     /** Compute continuous perimeter from Quads counting. */
     void compute(size_t nodeId, AttributeCollection &attrs);
   };
@@ -81,6 +115,8 @@ namespace pomar
   public:
     /** Returns QUADS_EULER_NUMBER attribute type. */
     inline AttrType attrType() { return AttrType::QUADS_EULER_NUMBER; }
+    /** The value is stored as an integer. */
+    inline AttrValueType valueType() { return AttrValueType::Int32; }
     /** Compute Euler Number from Quads counting. */
     void compute(size_t nodeId, AttributeCollection &attrs);
   };
@@ -95,37 +131,52 @@ namespace pomar
    * Dennis J. Silva; Wonder A. L. Alves; Alexandre Morimitsu; Ronaldo F. Hashimoto
    * 2016 IEEE International Conference on Image Processing (ICIP)
   */
-  template<class T>
+  template<class T, class Tree = CTree<T>>
   class AttributeComputerQuads
   {
   public:
+    /** Type of the nodes of the component tree (CTNode or CompactCTNode). */
+    using NodeType = typename Tree::NodeType;
+    /** 
+     * Type of the quads counts (QUADS_Q1, ..., QUADS_Q4): a 32-bit integer, or a 64-bit one for 
+     * trees whose index type is wider than 32 bits. */
+    using CountType = typename std::conditional<(sizeof(typename Tree::IndexType) > 4), 
+      std::int64_t, std::int32_t>::type;
+
+    /** 
+     * Contructor which receives a tree type, connectivity and the Quads counting attribute 
+     * computers. The decision tables are embedded in the library (see QuadsDecisionTables.hpp).
+    */
+    AttributeComputerQuads(QTreeType qTreeType, QConnectivity qConnectivity,
+      const std::vector<std::shared_ptr<AttributeFromQuadsComputer>>& qattrComputers = {});
+
     /** 
-     * Contructor which receives a tree type, connectivity, the resource path 
-     * (path to the directory which contains file dt-tree-type-connectivity.dat,
-     * default= "./resource/pomar/"), Quads counting attribute computer.
-     * 
+     * Contructor kept for compatibility: the resource path (the directory which contained the
+     * dt-tree-type-connectivity.dat files) is ignored since the decision tables are embedded.
     */
     AttributeComputerQuads(QTreeType qTreeType, QConnectivity qConnectivity,
-      const std::string &resource = "./resource/pomar/",
+      const std::string &resource,
       const std::vector<std::shared_ptr<AttributeFromQuadsComputer>>& qattrComputers = {});
 
     /** initialise necessary object attributes. */
-    void setUp(AttributeCollection &attrs, const CTree<T> &ct);
+    void setUp(AttributeCollection &attrs, const Tree &ct);
 
     /** PreProcess procedure of the quads counting algorithm . */
-    void preProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void preProcess(AttributeCollection &attrs, const NodeType &node);
     
     /** merge procedure of the quads counting algorithm . */
-    void merge(AttributeCollection &attrs, const CTNode<T> &node, const CTNode<T> &parent);
+    void merge(AttributeCollection &attrs, const NodeType &node, const NodeType &parent);
     
     /** postProcess procedure of the quads counting algorithm . */
-    void postProcess(AttributeCollection &attrs, const CTNode<T> &node);
+    void postProcess(AttributeCollection &attrs, const NodeType &node);
 
     /** compute quads counting. */ 
-    AttributeCollection compute(const CTree<T> &ct);
+    AttributeCollection compute(const Tree &ct);
+    /** compute quads counting with 'nthreads' threads. */ 
+    AttributeCollection compute(const Tree &ct, int nthreads);
 
     /** Convert this object into an IncrementalAttribute Computer instance. */
-    std::unique_ptr<IncrementalAttributeComputer<T>> toIncrementalAttributeComputer();
+    std::unique_ptr<IncrementalAttributeComputer<T, Tree>> toIncrementalAttributeComputer();
   private:
     static const int P1; static const int P2; static const int P3;
     static const int P4; static const int PD;
@@ -133,43 +184,59 @@ namespace pomar
     static const int P1T; static const int P2T;
     static const int P3T;  static const int PDT;
 
-    static const int NUM_DT_LEAVES;
+    static const int WINDOW_CODE_EQUAL;
 
-    bool isOutOfDomain(int index) const;
-    bool isLower(int ip, int iq);
-    bool isGreater(int ip, int iq);
+    static int compare(T q, T p);
+    /** Get the column of the count 'type', which setUp has pushed. */
+    static AttributeColumn<CountType> countColumn(AttributeCollection &attrs, AttrType type);
 
-    const std::vector<unsigned char>& counting(int ip);
-    void readDT(const std::string &resource);
+    void codePixels(const std::vector<T> &f, int width, int height);
+    int codeInteriorPixel(const T *row, int width, int x) const;
+    int codeBorderPixel(const std::vector<T> &f, int width, int height, int x, int y) const;
+
+    const unsigned char* counting(std::size_t ip) const;
   private:
-    int _p1, _p2, _p3, _pd, _p4;
+    AttributeColumn<CountType> _q1, _q2, _q3, _qd, _q4;
     std::vector<std::shared_ptr<AttributeFromQuadsComputer>> _qattrComputers;
     std::vector<IPoint2D> _window;
-    std::vector<std::vector<unsigned char>> _dt;
-    std::vector<T> _f;
-    std::unique_ptr<PixelIndexer> _pixelIndexer;
+    const unsigned char *_dt;
+    std::vector<unsigned short> _codes;
     QTreeType _qTreeType;
     QConnectivity _qconn;
   };
 
+  /* ------------------------- [ ATTRIBUTE FROM QUADS COMPUTER ] -------------------------- */
+  AttributeFromQuadsComputer::QuadsCounts AttributeFromQuadsComputer::counts(size_t nodeId) const
+  {
+    if (_counts64[0])
+      return QuadsCounts{_counts64[0][nodeId], _counts64[1][nodeId], _counts64[2][nodeId], 
+        _counts64[3][nodeId], _counts64[4][nodeId]};
+    return QuadsCounts{_counts32[0][nodeId], _counts32[1][nodeId], _counts32[2][nodeId], 
+      _counts32[3][nodeId], _counts32[4][nodeId]};
+  }
+
+  void AttributeFromQuadsComputer::setValue(size_t nodeId, double value)
+  {
+    AttributeValueRef(_valueType, static_cast<char*>(_values) + nodeId * _valueSize) = value;
+  }
+
   /* ------------------------- [ ATTRIBUTE COMPUTER QUADS ] ------------------------------- */
-  template<class T> const int AttributeComputerQuads<T>::P1 = 0;  
-  template<class T> const int AttributeComputerQuads<T>::P2 = 1;  
-  template<class T> const int AttributeComputerQuads<T>::P3 = 2;
-  template<class T> const int AttributeComputerQuads<T>::P4 = 3;
-  template<class T> const int AttributeComputerQuads<T>::PD = 4; 
-
-  template<class T> const int AttributeComputerQuads<T>::P1T = 5;  
-  template<class T> const int AttributeComputerQuads<T>::P2T = 6;
-  template<class T> const int AttributeComputerQuads<T>::P3T = 7;
-  template<class T> const int AttributeComputerQuads<T>::PDT = 8; 
-  
-  template<class T> const int AttributeComputerQuads<T>::NUM_DT_LEAVES = 6561;
-
-  template<class T>
-  AttributeComputerQuads<T>::AttributeComputerQuads(QTreeType qTreeType, 
-    QConnectivity qConnectivity, const std::string &resource, 
-    const std::vector<std::shared_ptr<AttributeFromQuadsComputer>>& qattrComputers)
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P1 = 0;  
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P2 = 1;  
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P3 = 2;
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P4 = 3;
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::PD = 4; 
+
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P1T = 5;  
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P2T = 6;
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::P3T = 7;
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::PDT = 8; 
+
+  template<class T, class Tree> const int AttributeComputerQuads<T, Tree>::WINDOW_CODE_EQUAL = 3280;
+
+  template<class T, class Tree>
+  AttributeComputerQuads<T, Tree>::AttributeComputerQuads(QTreeType qTreeType, 
+    QConnectivity qConnectivity, const std::vector<std::shared_ptr<AttributeFromQuadsComputer>>& qattrComputers)
   {
     _window.insert(_window.end(),{IPoint2D{-1,-1}, IPoint2D{0,-1}, IPoint2D{1,-1}, 
       IPoint2D{-1,0}, IPoint2D{1,0}, IPoint2D{-1,1}, IPoint2D{0,1}, IPoint2D{1,1}});
@@ -179,196 +246,185 @@ namespace pomar
     _qTreeType = qTreeType;
     if (_qTreeType == QTreeType::MaxTree) {
       if (qConnectivity == QConnectivity::Eight)
-        readDT(resource + "/dt-max-tree-8c.dat");
+        _dt = &QUADS_DT_MAX_TREE_8C[0][0];
       else
-        readDT(resource + "/dt-max-tree-4c.dat");
+        _dt = &QUADS_DT_MAX_TREE_4C[0][0];
     }
     else {
       if (qConnectivity == QConnectivity::Eight)
-        readDT(resource + "/dt-min-tree-8c.dat");
+        _dt = &QUADS_DT_MIN_TREE_8C[0][0];
       else
-        readDT(resource + "/dt-min-tree-4c.dat");
+        _dt = &QUADS_DT_MIN_TREE_4C[0][0];
     }
   }
 
-  template<class T>
-  void AttributeComputerQuads<T>::setUp(AttributeCollection &attrs, const CTree<T> &ct)
+  template<class T, class Tree>
+  AttributeComputerQuads<T, Tree>::AttributeComputerQuads(QTreeType qTreeType, 
+    QConnectivity qConnectivity, const std::string &, 
+    const std::vector<std::shared_ptr<AttributeFromQuadsComputer>>& qattrComputers)
+    :AttributeComputerQuads(qTreeType, qConnectivity, qattrComputers)
+  {}
+
+  template<class T, class Tree>
+  void AttributeComputerQuads<T, Tree>::setUp(AttributeCollection &attrs, const Tree &ct)
   {
     auto n = ct.numberOfNodes();
     auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(ct.meta());
-    _f = ct.convertToVector();
-    attrs.push(AttrType::QUADS_Q1, n); attrs.push(AttrType::QUADS_Q2, n); attrs.push(AttrType::QUADS_QD, n);
-    attrs.push(AttrType::QUADS_Q3, n); attrs.push(AttrType::QUADS_Q4, n);
+    attrs.push<CountType>(AttrType::QUADS_Q1, n); attrs.push<CountType>(AttrType::QUADS_Q2, n); 
+    attrs.push<CountType>(AttrType::QUADS_QD, n); attrs.push<CountType>(AttrType::QUADS_Q3, n); 
+    attrs.push<CountType>(AttrType::QUADS_Q4, n);
 
-    _p1 = attrs.attrIndex(AttrType::QUADS_Q1); _p2 = attrs.attrIndex(AttrType::QUADS_Q2);
-    _pd = attrs.attrIndex(AttrType::QUADS_QD); _p3 = attrs.attrIndex(AttrType::QUADS_Q3);
-    _p4 = attrs.attrIndex(AttrType::QUADS_Q4);
+    _q1 = countColumn(attrs, AttrType::QUADS_Q1); _q2 = countColumn(attrs, AttrType::QUADS_Q2);
+    _qd = countColumn(attrs, AttrType::QUADS_QD); _q3 = countColumn(attrs, AttrType::QUADS_Q3);
+    _q4 = countColumn(attrs, AttrType::QUADS_Q4);
 
     for (auto q : _qattrComputers) { 
-      attrs.push(q->attrType(), n);
+      auto valueType = q->valueType();
+      attrs.push(q->attrType(), n, valueType == AttrValueType::Int32 ? AttrValueTypeOf<CountType>::value : valueType);
       q->setUp(attrs, _qconn);
     }
 
-    std::unique_ptr<PixelIndexer> tpixelIndexer{new PixelIndexerDefaultValue{meta->width(), meta->height()}};
-    _pixelIndexer = std::move(tpixelIndexer);
+    codePixels(ct.convertToVector(), meta->width(), meta->height());
   }
 
-  template<class T>
-  void AttributeComputerQuads<T>::preProcess(AttributeCollection &attrs, const CTNode<T> &node)
+  template<class T, class Tree>
+  void AttributeComputerQuads<T, Tree>::preProcess(AttributeCollection &attrs, const NodeType &node)
   {
-    for (auto& elem : node.elementIndices()) {
-      auto c = counting(elem); 
-      attrs[_p1][node.id()] += c[P1] - c[P1T]; attrs[_p2][node.id()] += c[P2] - c[P2T]; 
-      attrs[_p3][node.id()] += c[P3] - c[P3T]; attrs[_pd][node.id()] += c[PD] - c[PDT] ;
-      attrs[_p4][node.id()] += c[P4]; 
+    CountType q1 = 0, q2 = 0, q3 = 0, qd = 0, q4 = 0;
+    for (auto elem : node.elementIndices()) {
+      const unsigned char *c = counting(elem); 
+      q1 += c[P1] - c[P1T]; q2 += c[P2] - c[P2T]; q3 += c[P3] - c[P3T]; 
+      qd += c[PD] - c[PDT]; q4 += c[P4];
     }
+    _q1[node.id()] += q1; _q2[node.id()] += q2; _q3[node.id()] += q3; _qd[node.id()] += qd; 
+    _q4[node.id()] += q4;
   }
 
-  template<class T>
-  void AttributeComputerQuads<T>::merge(AttributeCollection &attrs, const CTNode<T> &node, 
-    const CTNode<T> &parent)
+  template<class T, class Tree>
+  void AttributeComputerQuads<T, Tree>::merge(AttributeCollection &attrs, const NodeType &node, 
+    const NodeType &parent)
   {
-    attrs[_p1][parent.id()] += attrs[_p1][node.id()]; attrs[_p2][parent.id()] += attrs[_p2][node.id()];
-    attrs[_p3][parent.id()] += attrs[_p3][node.id()]; attrs[_p4][parent.id()] += attrs[_p4][node.id()];
-    attrs[_pd][parent.id()] += attrs[_pd][node.id()];
+    _q1[parent.id()] += _q1[node.id()]; _q2[parent.id()] += _q2[node.id()]; 
+    _q3[parent.id()] += _q3[node.id()]; _qd[parent.id()] += _qd[node.id()];
+    _q4[parent.id()] += _q4[node.id()];
   }
 
-  template<class T>
-  void AttributeComputerQuads<T>::postProcess(AttributeCollection &attrs, const CTNode<T> &node)
+  template<class T, class Tree>
+  void AttributeComputerQuads<T, Tree>::postProcess(AttributeCollection &attrs, const NodeType &node)
   {
-    for (auto q: _qattrComputers)
+    for (const auto &q: _qattrComputers)
       q->compute(node.id(), attrs);
   }
 
-  template<class T>
-  AttributeCollection AttributeComputerQuads<T>::compute(const CTree<T> &ct)
+  template<class T, class Tree>
+  AttributeCollection AttributeComputerQuads<T, Tree>::compute(const Tree &ct)
   {
     auto computer = toIncrementalAttributeComputer();
     AttributeCollection attrs;
     return computer->doCompute(attrs, ct);
   }
 
-  template<class T>
-  std::unique_ptr<IncrementalAttributeComputer<T>> 
-  AttributeComputerQuads<T>::toIncrementalAttributeComputer()
+  template<class T, class Tree>
+  AttributeCollection AttributeComputerQuads<T, Tree>::compute(const Tree &ct, int nthreads)
   {
-    auto mySetup = [this](AttributeCollection &attrs, const CTree<T> &ct) { this->setUp(attrs, ct); };
-    auto myPreProcess = [this](AttributeCollection &attrs, const CTNode<T> &node) { 
+    auto computer = toIncrementalAttributeComputer();
+    AttributeCollection attrs;
+    return computer->doCompute(attrs, ct, nthreads);
+  }
+
+  template<class T, class Tree>
+  std::unique_ptr<IncrementalAttributeComputer<T, Tree>> 
+  AttributeComputerQuads<T, Tree>::toIncrementalAttributeComputer()
+  {
+    auto mySetup = [this](AttributeCollection &attrs, const Tree &ct) { this->setUp(attrs, ct); };
+    auto myPreProcess = [this](AttributeCollection &attrs, const NodeType &node) { 
       this->preProcess(attrs, node); 
     };
-    auto myMerge = [this](AttributeCollection &attrs, const CTNode<T> &node, const CTNode<T> &parent) {
+    auto myMerge = [this](AttributeCollection &attrs, const NodeType &node, const NodeType &parent) {
       this->merge(attrs, node, parent);
     };
-    auto myPostProcess = [this](AttributeCollection &attrs, const CTNode<T> &node) {
+    auto myPostProcess = [this](AttributeCollection &attrs, const NodeType &node) {
       this->postProcess(attrs, node);
     };
 
-    return std::unique_ptr<IncrementalAttributeComputer<T>>(
-      new IncrementalAttributeComputer<T>(myPreProcess, myMerge, myPostProcess, mySetup));
-  }
-
-  template<class T>
-  const std::vector<unsigned char>& AttributeComputerQuads<T>::counting(int ip)
-  {
-    auto p = _pixelIndexer->pixel(ip);
-    std::string coding = {"11111111"};
-    for (size_t i = 0; i < _window.size(); i++) {
-      const auto& n = _window[i];
-      auto iq = _pixelIndexer->index(p + n);
-      if (isLower(ip, iq))
-        coding[i] = '0';
-      else if (isGreater(ip, iq))
-        coding[i] = '2';      
-    }
-    
-    auto idt = std::stoi(coding, 0, 3);
-    return _dt[idt];
-  }
-
-  template<class T>
-  bool AttributeComputerQuads<T>::isLower(int ip, int iq) 
-  {
-    if (isOutOfDomain(iq)) 
-      return _qTreeType == QTreeType::MaxTree;
-    return _f[iq] < _f[ip];
+    return std::unique_ptr<IncrementalAttributeComputer<T, Tree>>(
+      new IncrementalAttributeComputer<T, Tree>(myPreProcess, myMerge, myPostProcess, mySetup));
   }
 
-  template<class T>
-  bool AttributeComputerQuads<T>::isGreater(int ip, int iq)
+  template<class T, class Tree>
+  AttributeColumn<typename AttributeComputerQuads<T, Tree>::CountType> 
+  AttributeComputerQuads<T, Tree>::countColumn(AttributeCollection &attrs, AttrType type)
   {
-    if (isOutOfDomain(iq))
-      return _qTreeType == QTreeType::MinTree;
-    return _f[iq] > _f[ip];
+    return attrs.column<CountType>(attrs.attrIndex(type));
   }
 
-  template<class T>  
-  bool AttributeComputerQuads<T>::isOutOfDomain(int index) const
+  template<class T, class Tree>
+  int AttributeComputerQuads<T, Tree>::compare(T q, T p)
   {
-    return index < 0;
+    return (q > p) - (q < p);
   }
 
-  template<class T>
-  void AttributeComputerQuads<T>::readDT(const std::string &resource)
+  // The decision tree leaf of a pixel is indexed by the base-3 number whose digits are the 
+  // comparisons with its window (in the order of _window, most significant first): 0 for a 
+  // lower neighbour, 1 for an equal one and 2 for a greater one. WINDOW_CODE_EQUAL (11111111 
+  // in base 3) is the code of a pixel whose neighbours are all equal to it.
+  template<class T, class Tree>
+  void AttributeComputerQuads<T, Tree>::codePixels(const std::vector<T> &f, int width, int height)
   {
-    std::ifstream in{resource, std::ios::binary};
-    _dt.resize(NUM_DT_LEAVES);
-    char buffer[9];
-
-    for (auto i = 0; i < NUM_DT_LEAVES; i++) {
-      in.read(buffer, 9);
-      _dt[i].insert(_dt[i].end(), buffer, buffer + 9);
+    _codes.resize(f.size());
+    for (int y = 0; y < height; ++y) {
+      const std::size_t offset = static_cast<std::size_t>(y) * width;
+      if (y == 0 || y == height - 1 || width < 3) {
+        for (int x = 0; x < width; ++x) 
+          _codes[offset + x] = static_cast<unsigned short>(codeBorderPixel(f, width, height, x, y));
+        continue;
+      }
+
+      // The window of the interior pixels of a row lies inside the image, so the row is coded 
+      // without bounds checking by a branchless loop which the compiler vectorises.
+      const T *row = f.data() + offset;
+      unsigned short *codes = _codes.data() + offset;
+      codes[0] = static_cast<unsigned short>(codeBorderPixel(f, width, height, 0, y));
+      for (int x = 1; x < width - 1; ++x) 
+        codes[x] = static_cast<unsigned short>(codeInteriorPixel(row, width, x));
+      codes[width - 1] = static_cast<unsigned short>(codeBorderPixel(f, width, height, width - 1, y));
     }
   }
 
-  /* --------------------- [ AttibuteFromQuadsComputers ] ---------------------------------- */
-  void AttributeFromQuadsComputer::setUp(AttributeCollection &attrs, QConnectivity con)
+  template<class T, class Tree>
+  int AttributeComputerQuads<T, Tree>::codeInteriorPixel(const T *row, int width, int x) const
   {
-    _p1 = attrs.attrIndex(AttrType::QUADS_Q1);
-    _p2 = attrs.attrIndex(AttrType::QUADS_Q2);
-    _pd = attrs.attrIndex(AttrType::QUADS_QD); 
-    _p3 = attrs.attrIndex(AttrType::QUADS_Q3); 
-    _p4 = attrs.attrIndex(AttrType::QUADS_Q4);
-    _con = con;
-    _attrIdx = attrs.attrIndex(attrType());
+    const T *up = row - width, *down = row + width;
+    const T p = row[x];
+    return WINDOW_CODE_EQUAL
+      + 2187 * compare(up[x-1], p) + 729 * compare(up[x], p) + 243 * compare(up[x+1], p)
+      + 81 * compare(row[x-1], p) + 27 * compare(row[x+1], p)
+      + 9 * compare(down[x-1], p) + 3 * compare(down[x], p) + compare(down[x+1], p);
   }
 
-  /* ------------------- [ AttibuteFromQuadsComputers subclasses ] ------------------------------- */
-  void QArea::compute(size_t nodeId, AttributeCollection &attrs)
+  template<class T, class Tree>
+  int AttributeComputerQuads<T, Tree>::codeBorderPixel(const std::vector<T> &f, int width, int height, 
+    int x, int y) const
   {
-    auto area = (attrs[_p1][nodeId] + (2.0*attrs[_p2][nodeId]) + (2.0*attrs[_pd][nodeId]) + 
-      (3.0*attrs[_p3][nodeId]) + (4.0*attrs[_p4][nodeId])) / 4.0;    
-    attrs[_attrIdx][nodeId] = area;
-  }
-
-  void QCArea::compute(size_t nodeId, AttributeCollection &attrs)
-  {
-    auto area = 0.25*((attrs[_p1][nodeId]/2.0) + attrs[_p2][nodeId] + attrs[_pd][nodeId] +
-      + ((7.0/2.0)*attrs[_p3][nodeId]) + (4.0*attrs[_p4][nodeId]));
-    attrs[_attrIdx][nodeId] = area;
-  }
-
-  void QPerimeter::compute(size_t nodeId, AttributeCollection &attrs)
-  {
-    auto perimeter = attrs[_p1][nodeId] + attrs[_p2][nodeId] + (2.0*attrs[_pd][nodeId]) + 
-      attrs[_p3][nodeId];
-    attrs[_attrIdx][nodeId] = perimeter;
-  }
-
-  void QCPerimeter::compute(size_t nodeId, AttributeCollection &attrs)
-  {
-    auto perimeter = attrs[_p2][nodeId] + ((attrs[_p1][nodeId] + attrs[_p3][nodeId]) / 1.41);
-    attrs[_attrIdx][nodeId] = perimeter;
+    // Pixels out of the domain are lower than every pixel of a max-tree and greater than 
+    // every pixel of a min-tree.
+    const int outOfDomain = _qTreeType == QTreeType::MaxTree ? 0 : 2;
+    const T p = f[static_cast<std::size_t>(y) * width + x];
+    int code = 0;
+    for (const auto &n : _window) {
+      int qx = x + n.x(), qy = y + n.y();
+      if (qx < 0 || qx >= width || qy < 0 || qy >= height) 
+        code = 3 * code + outOfDomain;
+      else
+        code = 3 * code + 1 + compare(f[static_cast<std::size_t>(qy) * width + qx], p);
+    }
+    return code;
   }
 
-  void QEulerNumber::compute(size_t nodeId, AttributeCollection &attrs)
+  template<class T, class Tree>
+  const unsigned char* AttributeComputerQuads<T, Tree>::counting(std::size_t ip) const
   {
-    auto e = 0.0;
-    if (_con == Four)
-      e = (attrs[_p1][nodeId] - attrs[_p3][nodeId] + (2.0 * attrs[_pd][nodeId])) / 4.0;
-    else
-      e = (attrs[_p1][nodeId] - attrs[_p3][nodeId] - (2.0 * attrs[_pd][nodeId])) / 4.0;
-    
-    attrs[_attrIdx][nodeId] = e;
+    return _dt + _codes[ip] * QUADS_DT_LEAF_SIZE;
   }
 }
 #endif
\ No newline at end of file
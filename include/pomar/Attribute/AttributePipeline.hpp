@@ -0,0 +1,170 @@
+#include <pomar/Attribute/AttributeCollection.hpp>
+#include <pomar/Attribute/AttributeComputer.hpp>
+
+#include <tuple>
+#include <cstddef>
+
+#ifndef ATTRIBUTE_PIPELINE_HPP_INCLUDED
+#define ATTRIBUTE_PIPELINE_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+   * Class which calls the stage 'I' of each attribute computer of a tuple (in order) and then
+   * the ones from I+1 to N-1. It is used by AttributePipeline to expand its stages at compile time. */
+  template<std::size_t I, std::size_t N>
+  struct AttributePipelineStages
+  {
+    template<class Computers, class Tree>
+    static inline void setUp(Computers &comps, AttributeCollection &attrs, const Tree &ct)
+    {
+      std::get<I>(comps).setUp(attrs, ct);
+      AttributePipelineStages<I+1, N>::setUp(comps, attrs, ct);
+    }
+
+    template<class Computers, class Node>
+    static inline void preProcess(Computers &comps, AttributeCollection &attrs, const Node &node)
+    {
+      std::get<I>(comps).preProcess(attrs, node);
+      AttributePipelineStages<I+1, N>::preProcess(comps, attrs, node);
+    }
+
+    template<class Computers, class Node>
+    static inline void merge(Computers &comps, AttributeCollection &attrs, const Node &node,
+      const Node &parent)
+    {
+      std::get<I>(comps).merge(attrs, node, parent);
+      AttributePipelineStages<I+1, N>::merge(comps, attrs, node, parent);
+    }
+
+    template<class Computers, class Node>
+    static inline void postProcess(Computers &comps, AttributeCollection &attrs, const Node &node)
+    {
+      std::get<I>(comps).postProcess(attrs, node);
+      AttributePipelineStages<I+1, N>::postProcess(comps, attrs, node);
+    }
+  };
+
+  /** End of the expansion of the stages: there is no computer left. */
+  template<std::size_t N>
+  struct AttributePipelineStages<N, N>
+  {
+    template<class Computers, class Tree>
+    static inline void setUp(Computers &, AttributeCollection &, const Tree &) {}
+
+    template<class Computers, class Node>
+    static inline void preProcess(Computers &, AttributeCollection &, const Node &) {}
+
+    template<class Computers, class Node>
+    static inline void merge(Computers &, AttributeCollection &, const Node &, const Node &) {}
+
+    template<class Computers, class Node>
+    static inline void postProcess(Computers &, AttributeCollection &, const Node &) {}
+  };
+
+  /**
+   * Class which computes a fixed set of incremental attribute computers (e.g.
+   * AttributePipeline<AreaAttributeComputer<T>, AttributeComputerQuads<T>>) in a single
+   * transversal of the component tree. Unlike IncrementalAttributeComputerCollection, the stages
+   * ('setUp', 'preProcess', 'merge' and 'postProcess') of the computers are called directly
+   * (no std::function or virtual call), so the compiler can inline all of them in the loop over
+   * the nodes. The computers are called in the order they are given and the pipeline works
+   * with any component tree class (CTree or CompactCTree) the computers accept. */
+  template<class... Computers>
+  class AttributePipeline
+  {
+  public:
+    static_assert(sizeof...(Computers) > 0, "an attribute pipeline needs at least one attribute computer");
+
+    /** Construct a pipeline from copies of the attribute computers 'comps'. */
+    explicit AttributePipeline(Computers... comps);
+
+    /** Get the attribute computer 'I' of the pipeline. */
+    template<std::size_t I>
+    typename std::tuple_element<I, std::tuple<Computers...>>::type& get() { return std::get<I>(_computers); }
+
+    /** Compute the attributes of all computers for each node of the component tree 'ct'. */
+    template<class Tree>
+    AttributeCollection compute(const Tree &ct);
+
+    /**
+     * Compute the attributes of all computers for each node of the component tree 'ct' and store
+     * them in the collection 'attrs'. */
+    template<class Tree>
+    AttributeCollection doCompute(AttributeCollection &attrs, const Tree &ct);
+
+    /** 
+     * Compute the attributes of all computers for each node of the component tree 'ct' with 
+     * 'nthreads' threads (see computeIncrementally); the results are the same as the sequential ones. */
+    template<class Tree>
+    AttributeCollection compute(const Tree &ct, int nthreads);
+
+    /** 
+     * Compute the attributes of all computers for each node of the component tree 'ct' with 
+     * 'nthreads' threads and store them in the collection 'attrs'. */
+    template<class Tree>
+    AttributeCollection doCompute(AttributeCollection &attrs, const Tree &ct, int nthreads);
+
+  private:
+    using Stages = AttributePipelineStages<0, sizeof...(Computers)>;
+    std::tuple<Computers...> _computers;
+  };
+
+  /** Create an attribute pipeline from the attribute computers 'comps'. */
+  template<class... Computers>
+  AttributePipeline<Computers...> makeAttributePipeline(Computers... comps);
+
+  /* ============================= [IMPLEMENTATION ] ======================================== */
+  template<class... Computers>
+  AttributePipeline<Computers...>::AttributePipeline(Computers... comps)
+    :_computers{comps...}
+  {}
+
+  template<class... Computers>
+  template<class Tree>
+  AttributeCollection AttributePipeline<Computers...>::compute(const Tree &ct)
+  {
+    AttributeCollection attrs;
+    return doCompute(attrs, ct);
+  }
+
+  template<class... Computers>
+  template<class Tree>
+  AttributeCollection AttributePipeline<Computers...>::doCompute(AttributeCollection &attrs, const Tree &ct)
+  {
+    return doCompute(attrs, ct, 1);
+  }
+
+  template<class... Computers>
+  template<class Tree>
+  AttributeCollection AttributePipeline<Computers...>::compute(const Tree &ct, int nthreads)
+  {
+    AttributeCollection attrs;
+    return doCompute(attrs, ct, nthreads);
+  }
+
+  template<class... Computers>
+  template<class Tree>
+  AttributeCollection AttributePipeline<Computers...>::doCompute(AttributeCollection &attrs, const Tree &ct,
+    int nthreads)
+  {
+    using NodeType = typename Tree::NodeType;
+    Stages::setUp(_computers, attrs, ct);
+    computeIncrementally(ct, nthreads,
+      [this, &attrs](const NodeType &node) { Stages::preProcess(_computers, attrs, node); },
+      [this, &attrs](const NodeType &node, const NodeType &parent) { 
+        Stages::merge(_computers, attrs, node, parent); },
+      [this, &attrs](const NodeType &node) { Stages::postProcess(_computers, attrs, node); });
+    return attrs;
+  }
+
+  template<class... Computers>
+  AttributePipeline<Computers...> makeAttributePipeline(Computers... comps)
+  {
+    return AttributePipeline<Computers...>(comps...);
+  }
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef QUADS_DECISION_TABLES_HPP_INCLUDED
+#define QUADS_DECISION_TABLES_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /** Number of leaves of the quads counting decision trees (one for each 3x3 window coding, 3^8). */
+  const int QUADS_DT_LEAVES = 6561;
+  /** Number of countings stored in each leaf (P1, P2, P3, P4, PD, P1T, P2T, P3T and PDT). */
+  const int QUADS_DT_LEAF_SIZE = 9;
+
+  /**
+   * Quads counting decision tables of max-trees and min-trees with 4 and 8-connectivity. They 
+   * are generated at build time from resource/pomar/dt-*.dat (see GenerateQuadsTables.cmake) 
+   * and compiled into the library, so no file is read at run time. */
+  extern const unsigned char QUADS_DT_MAX_TREE_4C[QUADS_DT_LEAVES][QUADS_DT_LEAF_SIZE];
+  extern const unsigned char QUADS_DT_MAX_TREE_8C[QUADS_DT_LEAVES][QUADS_DT_LEAF_SIZE];
+  extern const unsigned char QUADS_DT_MIN_TREE_4C[QUADS_DT_LEAVES][QUADS_DT_LEAF_SIZE];
+  extern const unsigned char QUADS_DT_MIN_TREE_8C[QUADS_DT_LEAVES][QUADS_DT_LEAF_SIZE];
+}
+
+#endif
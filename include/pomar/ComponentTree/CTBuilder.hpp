@@ -1,7 +1,11 @@
 #include <pomar/AdjacencyRelation/Adjacency.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
 #include <pomar/ComponentTree/CTree.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
 #include <pomar/ComponentTree/CTSorter.hpp>
+#include <pomar/ComponentTree/CTBuilderWorkspace.hpp>
 #include <pomar/ComponentTree/CTMeta.hpp>
+#include <pomar/Core/Parallel.hpp>
 #include <type_traits>
 #include <vector>
 #include <memory>
@@ -9,6 +13,8 @@
 #include <limits>
 #include <algorithm>
 #include <numeric>
+#include <utility>
+#include <stdexcept>
 
 #ifndef CTBUILDED_HPP_INCLUDED
 #define CTBUILDED_HPP_INCLUDED
@@ -17,11 +23,70 @@
 
 namespace pomar
 {
+  /** Max-tree and min-tree (of the class Tree, CTree or CompactCTree) of the same elements. */
+  template<typename Tree>
+  struct DualTrees
+  {
+    Tree maxTree; /**< Max-tree. */
+    Tree minTree; /**< Min-tree. */
+  };
+
   /**
   * Component Tree Builder. This class represents a general algorithm to build 
   * component tree. This class provides the build method and its overloads, such that,
   * an user can build the component tree by providing an adjacency relation and 
   * and sorting method (or a TreeType).
+  *
+  * The builder can use several threads: the elements are split in contiguous chunks
+  * (horizontal strips for a CTMetaImage2D, slabs of slices for a CTMetaImage3D), a partial tree is
+  * built for each chunk in its own thread and the partial trees are merged along the
+  * chunk borders (Wilkinson et al., "Concurrent computation of attribute filters on
+  * shared memory parallel machines", 2008). When building from a TreeType, the elements
+  * are also sorted using the same number of threads. The resulting tree is the same as
+  * the one built sequentially. The threads come from the shared ThreadPool, so they are
+  * created once and reused by the next builds. Each thread works on its own copy of a 
+  * dynamic adjacency relation, which must implement Adjacency::clone() (otherwise the 
+  * parallel build throws std::logic_error).
+  *
+  * The union-find can either attach the zpar roots as the original algorithm does
+  * (Algorithm::UnionFind) or keep them balanced by rank (Algorithm::UnionByRank), which
+  * stores the canonical element of each zpar root apart from it (Najman and Couprie,
+  * "Building the component tree in quasi-linear time", 2006). The latter keeps the 
+  * zpar chains short on staircase and gradient images.
+  *
+  * For images of integer types up to 16 bits, the builder can also flood the image 
+  * from its lowest (highest for the min-tree) level using a hierarchical queue 
+  * (Algorithm::HierarchicalQueue) in the non-recursive form of the algorithm of Salembier
+  * et al., "Antiextensive connected operators for image and sequence processing", 1998.
+  * It does not sort the elements and builds the same tree as the union-find. 
+  *
+  * The tree type and the sorting algorithm can also be given as template parameters (e.g. 
+  * build<CTBuilder::TreeType::MinTree, RadixSortTag>(pmeta, elements, adj)), such that, the 
+  * sort is called directly and only the chosen sorting algorithm is instantiated.
+  *
+  * The build and buildCompact overloads which take an ImageView2D build the tree directly 
+  * over external memory (e.g. camera buffers or matrices with padded rows), without copying
+  * the image into a vector. The element indices of the tree are the tight ones (y * width + x).
+  * The pixels of a view are sorted row by row (with the threads of the builder) and the other
+  * accesses locate the row of a pixel without division (see ImageView2D).
+  *
+  * buildROI and buildCompactROI build the tree of a region of interest (e.g. a detection window
+  * or a tile) of an image view without cropping it: the adjacency relation is restricted to 
+  * the ROI and the meta-information (CTMetaImageROI2D) maps the ROI-local element indices of 
+  * the tree to the global indices of the image (see also CTree::nodeGlobalElementIndices and 
+  * CTree::nodeByGlobalElement). A ROI is built as fast as a cropped copy (benchROI), without the copy.
+  *
+  * The algorithms are templates over the adjacency relation. An Adjacency given by pointer
+  * is visited through virtual calls (DynamicAdjacency), while an adjacency relation known
+  * at compile time (e.g. GridAdjacency2D) given by value is inlined in the inner loops.
+  *
+  * The buildCompact overloads return the same tree in its compact representation
+  * (CompactCTree), which is created with a few allocations only. For repeated builds (e.g.
+  * video frames), buildCompact can also build into an existing CompactCTree using the scratch
+  * arrays of a CTBuilderWorkspace, which performs no allocation once the arrays have grown.
+  *
+  * The buildDual overloads build the max-tree and the min-tree of the same elements from a 
+  * single sort (e.g. for self-dual filters): the min-tree order is the max-tree order reversed.
   */
   class CTBuilder
   {
@@ -32,6 +97,34 @@ namespace pomar
       MinTree = 1  /**< Min-tree. */
     };    
 
+    /** Union-find variants used to build the component tree. */
+    enum class Algorithm {
+      UnionFind = 0,  /**< Union-find with path compression only. */
+      UnionByRank = 1, /**< Union-find with union by rank and path halving. */
+      HierarchicalQueue = 2 /**< Flooding using a hierarchical queue (integer types up to 16 bits, 
+                                 sequential only). Other types, and builds from a sort function,
+                                 use UnionByRank. */
+    };
+
+    /** Construct a builder which builds component trees sequentially. */
+    CTBuilder();
+
+    /** Construct a builder which builds component trees using 'nthreads' threads. */
+    explicit CTBuilder(int nthreads);
+
+    /** Construct a builder which uses the union-find variant 'algorithm' and 'nthreads' threads. */
+    explicit CTBuilder(Algorithm algorithm, int nthreads = 1);
+
+    /** Get the number of threads used to build a component tree. */
+    inline int numberOfThreads() const { return _nthreads; }
+    /** Set the number of threads used to build a component tree. */
+    inline void numberOfThreads(int nthreads) { _nthreads = nthreads; }
+
+    /** Get the union-find variant used to build a component tree. */
+    inline Algorithm algorithm() const { return _algorithm; }
+    /** Set the union-find variant used to build a component tree. */
+    inline void algorithm(Algorithm algorithm) { _algorithm = algorithm; }
+
     /**
     * Build a component tree of the type treeType and the graph with the
     *   vertices equal to elements and the edges defined by the adjacency
@@ -68,6 +161,159 @@ namespace pomar
     CTree<T> build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
       std::shared_ptr<Adjacency> adj, std::function<std::vector<int>(const std::vector<T> &)> sort);
 
+    /**
+    *   Build a component tree of the type treeType and the graph with the vertices equal
+    *   to elements and the edges defined by the adjacency relation adj known at compile 
+    *   time (e.g. GridAdjacency2D).
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type 
+    build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, TreeType treeType);
+
+    /**
+    *   Build a component tree of the graph with the vertices equal to elements and the edges
+    *   defined by the adjacency relation adj known at compile time (e.g. GridAdjacency2D)
+    *   using a sort strategy.
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type 
+    build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+      std::function<std::vector<IndexT>(const std::vector<T> &)> sort);
+
+    /**
+    *   Build a component tree of the type 'treeType' known at compile time using the adjacency
+    *   relation adj known at compile time. The elements are sorted by the algorithm 'SortTag' 
+    *   (CountingSortTag, RadixSortTag, ComparisonSortTag or DefaultSortTag for SortStrategy<T>,
+    *   see SortAlgorithm), which is checked against T at compile time. The tree is the same as 
+    *   the one of build(pmeta, elements, adj, treeType).
+    */
+    template<TreeType treeType, typename SortTag = DefaultSortTag, typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type 
+    build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj);
+
+    /**
+    *   Build a component tree of the type treeType in its compact representation (see 
+    *   CompactCTree). The algorithm and the tree are the same as the ones of build.
+    */
+    template<typename T>
+    CompactCTree<T> buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+      std::unique_ptr<Adjacency> adj, TreeType treeType);
+
+    /**
+    *   Build a component tree of the type treeType in its compact representation (see 
+    *   CompactCTree). The algorithm and the tree are the same as the ones of build.
+    */
+    template<typename T>
+    CompactCTree<T> buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+      std::shared_ptr<Adjacency> adj, TreeType treeType);
+
+    /**
+    *   Build a component tree of the type treeType in its compact representation using the
+    *   adjacency relation adj known at compile time (e.g. GridAdjacency2D).
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type 
+    buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+      TreeType treeType);
+
+    /**
+    *   Build a component tree of the type 'treeType' known at compile time in its compact 
+    *   representation, sorting the elements with the algorithm 'SortTag' (see build<treeType, SortTag>).
+    */
+    template<TreeType treeType, typename SortTag = DefaultSortTag, typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type 
+    buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj);
+
+    /**
+    *   Build a component tree of the type treeType in its compact representation into 'tree',
+    *   using the adjacency relation adj known at compile time and the scratch arrays of 
+    *   'workspace'. The arrays of the workspace and of the tree are reused, so repeated builds
+    *   of images of the same size do not allocate memory once they have grown to the largest 
+    *   tree. The tree is the same as the one of buildCompact. These builds are sequential (the 
+    *   number of threads of the builder is ignored): to build several images at the same time 
+    *   use one workspace (and tree) per thread. With Algorithm::HierarchicalQueue, integer types
+    *   of up to 16 bits are flooded with the arrays of the workspace too (other types use union 
+    *   by rank).
+    */
+    template<typename T, typename IndexT, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value>::type 
+    buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+      TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree);
+
+    /**
+    *   Build the max-tree and the min-tree of the graph with the vertices equal to elements and
+    *   the edges defined by the adjacency relation adj. The elements are sorted once and the 
+    *   min-tree uses the reversed order (see dualTreeSort). With two threads or more, the two 
+    *   trees are built at the same time with half of the threads each. The trees are the same as 
+    *   the ones built by build with TreeType::MaxTree and TreeType::MinTree.
+    */
+    template<typename T>
+    DualTrees<CTree<T>> buildDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+      std::shared_ptr<Adjacency> adj);
+
+    /**
+    *   Build the max-tree and the min-tree from a single sort (see buildDual) using the adjacency
+    *   relation adj known at compile time (e.g. GridAdjacency2D).
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, DualTrees<CTree<T, IndexT>>>::type 
+    buildDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj);
+
+    /**
+    *   Build the max-tree and the min-tree from a single sort (see buildDual) in their compact 
+    *   representation using the adjacency relation adj known at compile time.
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, DualTrees<CompactCTree<T, IndexT>>>::type 
+    buildCompactDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj);
+
+    /**
+    *   Build a component tree of the type treeType of the pixels of the image view 'image', 
+    *   using the adjacency relation adj known at compile time (e.g. GridAdjacency2D). The tree is
+    *   the same as the one of a tight copy of the image.
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type 
+    build(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, TreeType treeType);
+
+    /**
+    *   Build a component tree of the type treeType of the pixels of the image view 'image' in its 
+    *   compact representation.
+    */
+    template<typename IndexT = int, typename T, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type 
+    buildCompact(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, 
+      TreeType treeType);
+
+    /**
+    *   Build a component tree of the type treeType of the pixels of the image view 'image' into 
+    *   'tree' using the scratch arrays of 'workspace' (see the overload which takes a vector).
+    */
+    template<typename T, typename IndexT, typename Adj>
+    typename std::enable_if<isStaticAdjacency<Adj>::value>::type 
+    buildCompact(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, 
+      TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree);
+
+    /**
+    *   Build a component tree of the type treeType of the region of interest of size 
+    *   width x height whose top-left pixel is (x, y) in the image view 'image', using the 
+    *   adjacency relation Adj(width, height) known at compile time (e.g. GridAdjacency8). The
+    *   element indices of the tree are local to the ROI and its meta-information is a 
+    *   CTMetaImageROI2D which maps them to global indices. The tree is the same as the one of a
+    *   cropped copy of the ROI. It throws std::invalid_argument if the ROI is not inside the image.
+    */
+    template<typename Adj, typename IndexT = int, typename T>
+    CTree<T, IndexT> buildROI(const ImageView2D<T> &image, int x, int y, int width, int height, 
+      TreeType treeType);
+
+    /**
+    *   Build a component tree of the type treeType of a region of interest of the image view 
+    *   'image' in its compact representation (see buildROI). 
+    */
+    template<typename Adj, typename IndexT = int, typename T>
+    CompactCTree<T, IndexT> buildCompactROI(const ImageView2D<T> &image, int x, int y, int width, int height, 
+      TreeType treeType);
+
   protected:
     /** 
      * Build overload which receives an adjacency relation pointer and function for
@@ -82,12 +328,136 @@ namespace pomar
     CTree<T> build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, Adjacency *adj,
 			       TreeType treeType);
 
-    /** Algorithm find from Union-find data structure with path compression. */
-    int findRoot(std::vector<int>& zpar, int x) const;
+    /** 
+    * Build a component tree (of the class Tree, CTree or CompactCTree) of the type treeType using 
+    * the adjacency relation 'adj'. */
+    template<typename Tree, typename Elements, typename Adj>
+    Tree buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj, 
+      TreeType treeType);
+
+    /** 
+    * Build a component tree of the type treeType known at compile time, sorting the elements
+    * with the algorithm 'SortTag' (unless it is flooded). */
+    template<typename Tree, TreeType treeType, typename SortTag, typename Elements, typename Adj>
+    Tree buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj);
+
+    /** Build a component tree using the adjacency relation 'adj' and the sorting function 'sort'. */
+    template<typename Tree, typename T, typename Adj>
+    Tree buildTree(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, Adj &adj, 
+      std::function<std::vector<typename Tree::IndexType>(const std::vector<T> &)> sort);
+
+    /** 
+    * Build a component tree from the sorted indices 'sortedIndices' of the elements using 
+    * 'nthreads' threads for the union-find. */
+    template<typename Tree, typename Elements, typename Adj>
+    Tree buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj, 
+      const std::vector<typename Tree::IndexType> &sortedIndices, int nthreads);
+
+    /** 
+    * Build a compact component tree of the elements (a std::vector or an ImageView2D) into 
+    * 'tree' using the scratch arrays of 'workspace'. */
+    template<typename Elements, typename T, typename IndexT, typename Adj>
+    void buildCompactInto(std::shared_ptr<CTMeta> pmeta, const Elements &elements, const Adj &adj, 
+      TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree);
+
+    /** Build the max-tree and the min-tree (of the class Tree) from a single sort. */
+    template<typename Tree, typename Elements, typename Adj>
+    DualTrees<Tree> buildDualTrees(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj);
+
+    /** Algorithm find from Union-find data structure with path compression (path halving). */
+    template<typename IndexT>
+    IndexT findRoot(std::vector<IndexT>& zpar, IndexT x) const;
+
+    /** Throw std::invalid_argument if 'n' elements cannot be indexed by the type IndexT. */
+    template<typename IndexT>
+    void checkIndexType(size_t n) const;
+
+    /**
+    * Sequential union-find which computes the parent array (before canonization) 
+    * by processing the elements in the reverse order of 'sortedIndices'. */
+    template<typename IndexT, typename Adj>
+    std::vector<IndexT> unionFind(const std::vector<IndexT> &sortedIndices, Adj &adj) const;
+
+    /**
+    * Process the sorted elements [first, last) in the reverse order using the union-find 
+    * variant of this builder. Only elements in [begin, end) are processed and the edges 
+    * from them to elements in [end, ...) are pushed into 'borderEdges'. */
+    template<typename IndexT, typename Adj>
+    void unionFind(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end, 
+      std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges) const;
+
+    /** Same as unionFind, using the scratch arrays 'buffers' (resized to end - begin). */
+    template<typename IndexT, typename Adj>
+    void unionFind(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end, 
+      std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges,
+      UnionFindBuffers<IndexT> &buffers) const;
+
+    /** unionFind over a range of elements attaching the zpar roots directly.*/
+    template<typename IndexT, typename Adj>
+    void unionFindByParent(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end, 
+      std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges,
+      UnionFindBuffers<IndexT> &buffers) const;
+
+    /** unionFind over a range of elements using union by rank. */
+    template<typename IndexT, typename Adj>
+    void unionFindByRank(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end, 
+      std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges,
+      UnionFindBuffers<IndexT> &buffers) const;
+
+    /**
+    * Parallel union-find which computes a parent array with the same canonical tree as 
+    * unionFind. Each chunk [boundaries[i], boundaries[i+1]) is processed and canonized by
+    * its own thread (with its own copy of 'adj') and the partial trees are merged pairwise
+    * along the chunk borders. */
+    template<typename Elements, typename IndexT, typename Adj>
+    std::vector<IndexT> parallelUnionFind(const Elements &elements, const std::vector<IndexT> &sortedIndices, 
+      const std::vector<IndexT> &boundaries, Adj &adj) const;
+
+    /** 
+    * Split 'size' elements in at most 'nchunks' chunks. Chunks are aligned to the image
+    * rows when 'pmeta' is a CTMetaImage2D and to the volume slices when it is a CTMetaImage3D. */
+    std::vector<long long> chunkBoundaries(std::shared_ptr<CTMeta> pmeta, long long size, int nchunks) const;
+
+    /**
+    * Merge the partial (canonized) trees which contain the adjacent elements x and y. 'rank'
+    * is the position of each element in the sorted indices. */
+    template<typename Elements, typename IndexT>
+    void connect(const Elements &elements, std::vector<IndexT> &parent, const std::vector<IndexT> &rank, 
+      IndexT x, IndexT y) const;
+
+    /** Find the element which represents the node of x in a partial tree (with path compression). */
+    template<typename Elements, typename IndexT>
+    IndexT levelRoot(const Elements &elements, std::vector<IndexT> &parent, IndexT x) const;
+
+    /** Build the component tree by flooding when T is an integer type of up to 16 bits. */
+    template<typename Tree, typename Elements, typename Adj>
+    Tree buildByFlooding(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+      TreeType treeType, std::true_type) const;
+
+    /** Types which cannot be flooded are built by union by rank. */
+    template<typename Tree, typename Elements, typename Adj>
+    Tree buildByFlooding(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+      TreeType treeType, std::false_type);
+
+    /** 
+    * Flood the elements (of an integer type of up to 16 bits) into the parent array 'parent' 
+    * and the level roots sorted by level 'sortedLevelRoots' using the scratch arrays 'buffers'. */
+    template<typename Elements, typename IndexT, typename Adj>
+    void flood(const Elements &elements, Adj &adj, TreeType treeType, std::vector<IndexT> &parent,
+      std::vector<IndexT> &sortedLevelRoots, FloodingBuffers<IndexT> &buffers, std::true_type) const;
+
+    /** Types which cannot be flooded are sorted before calling flood, so it does nothing. */
+    template<typename Elements, typename IndexT, typename Adj>
+    void flood(const Elements &, Adj &, TreeType, std::vector<IndexT> &, std::vector<IndexT> &, 
+      FloodingBuffers<IndexT> &, std::false_type) const {}
 
     /** Make all elements of a node point to exactly one canonical element. */
-    template<typename T>
-    void canonizeTree(const std::vector<T>& elements, const std::vector<int> &sortedIndices, std::vector<int>& parent) const;
+    template<typename Elements, typename IndexT>
+    void canonizeTree(const Elements& elements, const std::vector<IndexT> &sortedIndices, std::vector<IndexT>& parent) const;
+
+  private:
+    int _nthreads;
+    Algorithm _algorithm;
   };
 
 
@@ -99,22 +469,39 @@ namespace pomar
   template<typename T>
   CTree<T> CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, Adjacency *adj,
 			        TreeType treeType)
+  {
+    DynamicAdjacency dadj(adj);
+    return buildTree<CTree<T>>(pmeta, elements, dadj, treeType);
+  }
+
+  template<typename Tree, typename Elements, typename Adj>
+  Tree CTBuilder::buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+    TreeType treeType)
   {
     switch(treeType) {
       case CTBuilder::TreeType::MaxTree:
-      {      	
-      	return build(pmeta, elements, adj, 
-          static_cast<std::function<std::vector<int>(const std::vector<T>&)>>(&maxTreeSort<T>));
-      }
+        return buildTree<Tree, TreeType::MaxTree, DefaultSortTag>(pmeta, elements, adj);
       case CTBuilder::TreeType::MinTree:
-      {      	
-      	return build(pmeta, elements, adj, 
-          static_cast<std::function<std::vector<int>(const std::vector<T>&)>>(&minTreeSort<T>));
-      }
+        return buildTree<Tree, TreeType::MinTree, DefaultSortTag>(pmeta, elements, adj);
     }
     throw std::invalid_argument("invalid tree type: treeType must be a valid value of the enumeration TreeType");
   }
 
+  template<typename Tree, CTBuilder::TreeType treeType, typename SortTag, typename Elements, typename Adj>
+  Tree CTBuilder::buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj)
+  {
+    using T = typename Elements::value_type;
+    using IndexT = typename Tree::IndexType;
+    using Floodable = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+    checkIndexType<IndexT>(elements.size());
+    if (_algorithm == Algorithm::HierarchicalQueue && Floodable::value)
+      return buildByFlooding<Tree>(pmeta, elements, adj, treeType, Floodable());
+
+    auto sortedIndices = TreeSorter<treeType == TreeType::MinTree, SortTag>::template sort<IndexT>(
+      elements, _nthreads);
+    return buildTree<Tree>(pmeta, elements, adj, sortedIndices, _nthreads);
+  }
+
   template<typename T>
   CTree<T> CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
     std::unique_ptr<Adjacency> adj, TreeType treeType)
@@ -144,39 +531,665 @@ namespace pomar
     return build(pmeta, elements, adj.get(), sort);
   }
 
+  /* ===================================[ BUILD FROM STATIC ADJACENCY ]================================================== */
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type
+  CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, TreeType treeType)
+  {
+    Adj sadj(adj);
+    return buildTree<CTree<T, IndexT>>(pmeta, elements, sadj, treeType);
+  }
+
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type
+  CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+    std::function<std::vector<IndexT>(const std::vector<T> &)> sort)
+  {
+    Adj sadj(adj);
+    return buildTree<CTree<T, IndexT>>(pmeta, elements, sadj, sort);
+  }
+
+  template<CTBuilder::TreeType treeType, typename SortTag, typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type
+  CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj)
+  {
+    Adj sadj(adj);
+    return buildTree<CTree<T, IndexT>, treeType, SortTag>(pmeta, elements, sadj);
+  }
+
+  /* ===================================[ BUILD COMPACT TREE ]=========================================================== */
+  template<typename T>
+  CompactCTree<T> CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+    std::unique_ptr<Adjacency> adj, TreeType treeType)
+  {
+    DynamicAdjacency dadj(adj.get());
+    return buildTree<CompactCTree<T>>(pmeta, elements, dadj, treeType);
+  }
+
+  template<typename T>
+  CompactCTree<T> CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+    std::shared_ptr<Adjacency> adj, TreeType treeType)
+  {
+    DynamicAdjacency dadj(adj.get());
+    return buildTree<CompactCTree<T>>(pmeta, elements, dadj, treeType);
+  }
+
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type
+  CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+    TreeType treeType)
+  {
+    Adj sadj(adj);
+    return buildTree<CompactCTree<T, IndexT>>(pmeta, elements, sadj, treeType);
+  }
+
+  template<CTBuilder::TreeType treeType, typename SortTag, typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type
+  CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj)
+  {
+    Adj sadj(adj);
+    return buildTree<CompactCTree<T, IndexT>, treeType, SortTag>(pmeta, elements, sadj);
+  }
+
+  /* ================================[ BUILD COMPACT TREE WITH A WORKSPACE ]============================================= */
+  template<typename T, typename IndexT, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value>::type 
+  CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj, 
+    TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree)
+  {
+    buildCompactInto(pmeta, elements, adj, treeType, workspace, tree);
+  }
+
+  /* ======================================[ BUILD FROM IMAGE VIEWS ]==================================================== */
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CTree<T, IndexT>>::type
+  CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, TreeType treeType)
+  {
+    Adj sadj(adj);
+    return buildTree<CTree<T, IndexT>>(pmeta, image, sadj, treeType);
+  }
+
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, CompactCTree<T, IndexT>>::type
+  CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, 
+    TreeType treeType)
+  {
+    Adj sadj(adj);
+    return buildTree<CompactCTree<T, IndexT>>(pmeta, image, sadj, treeType);
+  }
+
+  template<typename T, typename IndexT, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value>::type 
+  CTBuilder::buildCompact(std::shared_ptr<CTMeta> pmeta, const ImageView2D<T> &image, const Adj &adj, 
+    TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree)
+  {
+    buildCompactInto(pmeta, image, adj, treeType, workspace, tree);
+  }
+
+  /* ======================================[ BUILD REGION OF INTEREST ]================================================= */
+  template<typename Adj, typename IndexT, typename T>
+  CTree<T, IndexT> CTBuilder::buildROI(const ImageView2D<T> &image, int x, int y, int width, int height, 
+    TreeType treeType)
+  {
+    static_assert(isStaticAdjacency<Adj>::value, "buildROI needs an adjacency relation known at compile time");
+    auto roi = image.roi(x, y, width, height);
+    auto meta = std::make_shared<CTMetaImageROI2D>(image.width(), image.height(), x, y, width, height);
+    Adj adj(width, height);
+    return buildTree<CTree<T, IndexT>>(meta, roi, adj, treeType);
+  }
+
+  template<typename Adj, typename IndexT, typename T>
+  CompactCTree<T, IndexT> CTBuilder::buildCompactROI(const ImageView2D<T> &image, int x, int y, int width, 
+    int height, TreeType treeType)
+  {
+    static_assert(isStaticAdjacency<Adj>::value, "buildCompactROI needs an adjacency relation known at compile time");
+    auto roi = image.roi(x, y, width, height);
+    auto meta = std::make_shared<CTMetaImageROI2D>(image.width(), image.height(), x, y, width, height);
+    Adj adj(width, height);
+    return buildTree<CompactCTree<T, IndexT>>(meta, roi, adj, treeType);
+  }
+
+  template<typename Elements, typename T, typename IndexT, typename Adj>
+  void CTBuilder::buildCompactInto(std::shared_ptr<CTMeta> pmeta, const Elements &elements, const Adj &adj, 
+    TreeType treeType, CTBuilderWorkspace<T, IndexT> &workspace, CompactCTree<T, IndexT> &tree)
+  {
+    checkIndexType<IndexT>(elements.size());
+    if (treeType != TreeType::MaxTree && treeType != TreeType::MinTree)
+      throw std::invalid_argument("invalid tree type: treeType must be a valid value of the enumeration TreeType");
+
+    using Floodable = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+    const IndexT UNDEF = -1;
+    auto &sortedIndices = workspace._sortedIndices;
+    auto &parent = workspace._parent;
+    if (_algorithm == Algorithm::HierarchicalQueue && Floodable::value) {
+      // The flooding outputs the level roots only, which is all the compact tree needs.
+      flood(elements, adj, treeType, parent, sortedIndices, workspace._flooding, Floodable());
+      tree.assign(pmeta, parent, sortedIndices, elements);
+      return;
+    }
+
+    sortIndexInto(elements, treeType == TreeType::MinTree, sortedIndices, workspace._sort);
+
+    // The whole image is a single range, so no border edge is pushed (nor allocated).
+    std::vector<std::pair<IndexT,IndexT>> borderEdges;
+    parent.assign(elements.size(), UNDEF);
+    unionFind(sortedIndices.data(), sortedIndices.data() + sortedIndices.size(), adj, IndexT(0), 
+      static_cast<IndexT>(elements.size()), parent, borderEdges, workspace._unionFind);
+    canonizeTree(elements, sortedIndices, parent);
+
+    tree.assign(pmeta, parent, sortedIndices, elements);
+  }
+
+  /* ======================================[ BUILD DUAL TREES ]========================================================== */
+  template<typename T>
+  DualTrees<CTree<T>> CTBuilder::buildDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, 
+    std::shared_ptr<Adjacency> adj)
+  {
+    DynamicAdjacency dadj(adj.get());
+    return buildDualTrees<CTree<T>>(pmeta, elements, dadj);
+  }
+
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, DualTrees<CTree<T, IndexT>>>::type 
+  CTBuilder::buildDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj)
+  {
+    Adj sadj(adj);
+    return buildDualTrees<CTree<T, IndexT>>(pmeta, elements, sadj);
+  }
+
+  template<typename IndexT, typename T, typename Adj>
+  typename std::enable_if<isStaticAdjacency<Adj>::value, DualTrees<CompactCTree<T, IndexT>>>::type 
+  CTBuilder::buildCompactDual(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, const Adj &adj)
+  {
+    Adj sadj(adj);
+    return buildDualTrees<CompactCTree<T, IndexT>>(pmeta, elements, sadj);
+  }
+
+  template<typename Tree, typename Elements, typename Adj>
+  DualTrees<Tree> CTBuilder::buildDualTrees(std::shared_ptr<CTMeta> pmeta, const Elements &elements, 
+    Adj &adj)
+  {
+    using T = typename Elements::value_type;
+    using IndexT = typename Tree::IndexType;
+    using Floodable = std::integral_constant<bool, std::is_integral<T>::value && sizeof(T) <= 2>;
+    checkIndexType<IndexT>(elements.size());
+
+    // Flooding does not sort the elements, so each tree is flooded on its own.
+    const bool flooding = _algorithm == Algorithm::HierarchicalQueue && Floodable::value;
+    std::vector<IndexT> maxSorted, minSorted;
+    if (!flooding) {
+      maxSorted = TreeSorter<false>::sort<IndexT>(elements, _nthreads);
+      minSorted = dualTreeSort(elements, maxSorted);
+    }
+
+    DualTrees<Tree> trees;
+    const int ntasks = _nthreads > 1 ? 2 : 1;
+    const int nthreads = _nthreads / ntasks;
+    auto buildTrees = [&](int task, Adj &tadj) {
+      for (int t = task; t < 2; t += ntasks) {
+        const bool maxTree = t == 0;
+        auto &tree = maxTree ? trees.maxTree : trees.minTree;
+        if (flooding)
+          tree = buildByFlooding<Tree>(pmeta, elements, tadj, 
+            maxTree ? TreeType::MaxTree : TreeType::MinTree, Floodable());
+        else
+          tree = buildTree<Tree>(pmeta, elements, tadj, maxTree ? maxSorted : minSorted, nthreads);
+      }
+    };
+    // The adjacency relation is only copied when each tree is built by its own thread.
+    if (ntasks == 1)
+      buildTrees(0, adj);
+    else
+      parallelFor(ntasks, [&](int task) { Adj tadj(adj); buildTrees(task, tadj); });
+    return trees;
+  }
+
   /* ========================================[ BUILDING ALGORITHM ]====================================================== */
   template<typename T>
   CTree<T> CTBuilder::build(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, Adjacency *adj,
 						        std::function<std::vector<int>(const std::vector<T> &)> sort)
   {
-    const int UNDEF = -1;
-    std::vector<int> parent(elements.size(), UNDEF);
-    std::vector<int> zpar(elements.size());
+    DynamicAdjacency dadj(adj);
+    return buildTree<CTree<T>>(pmeta, elements, dadj, sort);
+  }
+
+  template<typename Tree, typename T, typename Adj>
+  Tree CTBuilder::buildTree(std::shared_ptr<CTMeta> pmeta, const std::vector<T> &elements, Adj &adj,
+    std::function<std::vector<typename Tree::IndexType>(const std::vector<T> &)> sort)
+  {
+    checkIndexType<typename Tree::IndexType>(elements.size());
+    return buildTree<Tree>(pmeta, elements, adj, sort(elements), _nthreads);
+  }
+
+  template<typename Tree, typename Elements, typename Adj>
+  Tree CTBuilder::buildTree(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+    const std::vector<typename Tree::IndexType> &sortedIndices, int nthreads)
+  {
+    using IndexT = typename Tree::IndexType;
+    std::vector<IndexT> parent;
+
+    auto chunks = chunkBoundaries(pmeta, elements.size(), nthreads);
+    std::vector<IndexT> boundaries(chunks.begin(), chunks.end());
+    if (boundaries.size() > 2)
+      parent = parallelUnionFind(elements, sortedIndices, boundaries, adj);
+    else
+      parent = unionFind(sortedIndices, adj);
+
+    canonizeTree(elements, sortedIndices, parent);
+
+    return Tree(pmeta, parent, sortedIndices, elements);
+  }
+
+  /* ========================================[ FIND ROOT ]========================================================= */
+  template<typename IndexT>
+  IndexT CTBuilder::findRoot(std::vector<IndexT>& zpar, IndexT p) const
+  {
+    while (zpar[p] != p) {
+      zpar[p] = zpar[zpar[p]];
+      p = zpar[p];
+    }
+    return p;
+  }
+
+  template<typename IndexT>
+  void CTBuilder::checkIndexType(size_t n) const
+  {
+    if (n > static_cast<size_t>(std::numeric_limits<IndexT>::max()))
+      throw std::invalid_argument("too many elements: the index type cannot index all the elements");
+  }
+
+  /* ========================================[ UNION FIND ]======================================================== */
+  template<typename IndexT, typename Adj>
+  std::vector<IndexT> CTBuilder::unionFind(const std::vector<IndexT> &sortedIndices, Adj &adj) const
+  {
+    const IndexT UNDEF = -1;
+    std::vector<IndexT> parent(sortedIndices.size(), UNDEF);
+    std::vector<std::pair<IndexT,IndexT>> borderEdges;
+
+    unionFind(sortedIndices.data(), sortedIndices.data() + sortedIndices.size(), adj, IndexT(0), 
+      static_cast<IndexT>(sortedIndices.size()), parent, borderEdges);
+
+    return parent;
+  }
+
+  template<typename IndexT, typename Adj>
+  void CTBuilder::unionFind(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end,
+    std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges) const
+  {
+    UnionFindBuffers<IndexT> buffers;
+    unionFind(first, last, adj, begin, end, parent, borderEdges, buffers);
+  }
+
+  template<typename IndexT, typename Adj>
+  void CTBuilder::unionFind(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end,
+    std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges, 
+    UnionFindBuffers<IndexT> &buffers) const
+  {
+    switch (_algorithm) {
+      case Algorithm::UnionFind:
+        unionFindByParent(first, last, adj, begin, end, parent, borderEdges, buffers);
+        return;
+      case Algorithm::UnionByRank:
+      // Flooding depends on the tree type, so builds from a sort function use union by rank.
+      case Algorithm::HierarchicalQueue:
+        unionFindByRank(first, last, adj, begin, end, parent, borderEdges, buffers);
+        return;
+    }
+    throw std::invalid_argument("invalid algorithm: algorithm must be a valid value of the enumeration Algorithm");
+  }
+
+  /* ===================================[ UNION FIND BY PARENT ]=================================================== */
+  template<typename IndexT, typename Adj>
+  void CTBuilder::unionFindByParent(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end,
+    std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges, 
+    UnionFindBuffers<IndexT> &buffers) const
+  {
+    const IndexT UNDEF = -1;
+    // zpar is indexed relative to 'begin'. Each entry is set when its element is processed.
+    auto &zpar = buffers.zpar;
+    zpar.resize(end - begin);
 
-    auto sortedIndices = sort(elements);
+    for (auto it = last; it != first; ) {
+      auto p = *--it;
+      parent[p] = p;
+      zpar[p - begin] = p - begin;
+      adj.forEachNeighbour(p, [&](IndexT n) {
+        if (n < begin || n >= end) {
+          if (n >= end) borderEdges.emplace_back(p, n);
+        }
+        else if (parent[n] != UNDEF) {
+          auto r = findRoot(zpar, static_cast<IndexT>(n - begin));
+          if (r != p - begin) {
+            zpar[r] = p - begin;
+            parent[r + begin] = p;
+          }
+        }
+      });
+    }
+  }
+
+  /* ====================================[ UNION FIND BY RANK ]==================================================== */
+  template<typename IndexT, typename Adj>
+  void CTBuilder::unionFindByRank(const IndexT *first, const IndexT *last, Adj &adj, IndexT begin, IndexT end,
+    std::vector<IndexT> &parent, std::vector<std::pair<IndexT,IndexT>> &borderEdges,
+    UnionFindBuffers<IndexT> &buffers) const
+  {
+    const IndexT UNDEF = -1;
+    // zpar, rank and repr are indexed relative to 'begin'. repr stores the canonical element 
+    // (the last processed one) of the component whose zpar root is the index.
+    auto &zpar = buffers.zpar, &repr = buffers.repr;
+    auto &rank = buffers.rank;
+    zpar.resize(end - begin);
+    repr.resize(end - begin);
+    rank.assign(end - begin, 0);
 
-    for (int i = sortedIndices.size() - 1; i >= 0; i--) {
+    for (auto it = last; it != first; ) {
+      auto p = *--it;
+      IndexT zp = p - begin;
+      parent[p] = p;
+      zpar[zp] = repr[zp] = zp;
+      adj.forEachNeighbour(p, [&](IndexT n) {
+        if (n < begin || n >= end) {
+          if (n >= end) borderEdges.emplace_back(p, n);
+        }
+        else if (parent[n] != UNDEF) {
+          auto zn = findRoot(zpar, static_cast<IndexT>(n - begin));
+          if (zn != zp) {
+            parent[repr[zn] + begin] = p;
+            if (rank[zp] < rank[zn])
+              std::swap(zp, zn);
+            zpar[zn] = zp;
+            repr[zp] = p - begin;
+            if (rank[zp] == rank[zn])
+              rank[zp]++;
+          }
+        }
+      });
+    }
+  }
+
+  /* ===================================[ PARALLEL UNION FIND ]========================================================= */
+  template<typename Elements, typename IndexT, typename Adj>
+  std::vector<IndexT> CTBuilder::parallelUnionFind(const Elements &elements, const std::vector<IndexT> &sortedIndices,
+    const std::vector<IndexT> &boundaries, Adj &adj) const
+  {
+    const IndexT UNDEF = -1;
+    const IndexT n = sortedIndices.size();
+    const int nchunks = boundaries.size() - 1;
+    std::vector<IndexT> parent(n, UNDEF);
+    std::vector<IndexT> rank(n);
+
+    auto chunkOf = [&boundaries](IndexT p) {
+      return static_cast<int>(std::upper_bound(boundaries.begin(), boundaries.end(), p) - boundaries.begin()) - 1;
+    };
+
+    // Distribute the sorted indices among the chunks keeping their relative order. Since the
+    // chunk i has boundaries[i+1] - boundaries[i] elements, its sorted elements are stored in
+    // chunkSorted[boundaries[i], boundaries[i+1]).
+    std::vector<IndexT> chunkSorted(n);
+    std::vector<IndexT> next(boundaries.begin(), boundaries.end() - 1);
+    for (IndexT i = 0; i < n; ++i) {
       auto p = sortedIndices[i];
-      parent[p] = zpar[p] = p;
-      auto neighbours = adj->neighbours(p);
-      for (auto n: neighbours) {
-        if (n != Adjacency::NoAdjacentIndex && parent[n] != UNDEF) {
-          auto r = findRoot(zpar, n);
-          if (r != p)
-            zpar[r] = parent[r] = p;
+      rank[p] = i;
+      chunkSorted[next[chunkOf(p)]++] = p;
+    }
+
+    // Build and canonize a partial tree for each chunk considering only the edges inside the 
+    // chunk. The edges which go to the next chunks are kept to merge the partial trees.
+    std::vector<std::vector<std::pair<IndexT,IndexT>>> borderEdges(nchunks);
+    parallelFor(nchunks, [&](int c) {
+      Adj cadj(adj);
+      auto begin = boundaries[c], end = boundaries[c+1];
+      unionFind(chunkSorted.data() + begin, chunkSorted.data() + end, cadj, begin, end,
+        parent, borderEdges[c]);
+
+      for (IndexT i = begin; i < end; ++i) {
+        auto p = chunkSorted[i];
+        auto q = parent[p];
+        if (elements[q] == elements[parent[q]])
+          parent[p] = parent[q];
+      }
+    });
+
+    // Merge the partial trees pairwise: at each step the group of chunks [l, l+step) is merged
+    // with [l+step, l+2*step). Merges of different groups touch disjoint elements.
+    for (int step = 1; step < nchunks; step *= 2) {
+      std::vector<int> lefts;
+      for (int l = 0; l + step < nchunks; l += 2*step)
+        lefts.push_back(l);
+
+      parallelFor(lefts.size(), [&](int t) {
+        auto l = lefts[t], r = l + step, rend = std::min(l + 2*step, nchunks);
+        for (int c = l; c < r; ++c) {
+          for (const auto& e: borderEdges[c]) {
+            auto cq = chunkOf(e.second);
+            if (cq >= r && cq < rend)
+              connect(elements, parent, rank, e.first, e.second);
+          }
         }
+      });
+    }
+
+    return parent;
+  }
+
+  /* =========================================[ CONNECT ]=============================================================== */
+  template<typename Elements, typename IndexT>
+  void CTBuilder::connect(const Elements &elements, std::vector<IndexT> &parent, const std::vector<IndexT> &rank, 
+    IndexT x, IndexT y) const
+  {
+    // Walk down both branches from x and y interleaving their nodes by rank, such that every
+    // parent keeps a lower rank than its children. Two nodes of the same level are merged by 
+    // making the one with the higher rank point to the other one.
+    x = levelRoot(elements, parent, x);
+    y = levelRoot(elements, parent, y);
+    while (x != y) {
+      if (rank[x] < rank[y])
+        std::swap(x, y);
+
+      auto z = parent[x];
+      if (z == x) {
+        parent[x] = y;
+        return;
+      }
+
+      z = levelRoot(elements, parent, z);
+      if (rank[z] >= rank[y]) {
+        x = z;
+      }
+      else {
+        parent[x] = y;
+        x = y;
+        y = z;
       }
     }
+  }
 
-    canonizeTree(elements, sortedIndices, parent);
+  /* =======================================[ LEVEL ROOT ]============================================================= */
+  template<typename Elements, typename IndexT>
+  IndexT CTBuilder::levelRoot(const Elements &elements, std::vector<IndexT> &parent, IndexT x) const
+  {
+    auto r = x;
+    while (parent[r] != r && elements[parent[r]] == elements[r])
+      r = parent[r];
 
-    return CTree<T>(pmeta, parent, sortedIndices, elements);
+    while (parent[x] != r && parent[x] != x && elements[parent[x]] == elements[x]) {
+      auto next = parent[x];
+      parent[x] = r;
+      x = next;
+    }
+    return r;
+  }
+
+  /* =======================================[ FLOODING ]================================================================= */
+  template<typename Tree, typename Elements, typename Adj>
+  Tree CTBuilder::buildByFlooding(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+    TreeType treeType, std::true_type) const
+  {
+    using IndexT = typename Tree::IndexType;
+    std::vector<IndexT> parent, sortedLevelRoots;
+    FloodingBuffers<IndexT> buffers;
+    flood(elements, adj, treeType, parent, sortedLevelRoots, buffers, std::true_type());
+    return Tree(pmeta, parent, sortedLevelRoots, elements);
+  }
+
+  template<typename Elements, typename IndexT, typename Adj>
+  void CTBuilder::flood(const Elements &elements, Adj &adj, TreeType treeType, std::vector<IndexT> &parent,
+    std::vector<IndexT> &sortedLevelRoots, FloodingBuffers<IndexT> &buffers, std::true_type) const
+  {
+    const IndexT UNDEF = -1;
+    const IndexT INQUEUE = -2;
+    const IndexT n = static_cast<IndexT>(elements.size());
+    parent.assign(n, UNDEF);
+    sortedLevelRoots.clear();
+    if (n == 0)
+      return;
+
+    // Map the values to levels in [0, nlevels) such that the root has level 0.
+    // As std::minmax_element, pmin is the first lowest element and pmax the last highest one.
+    // The sequential passes read the elements with forEachElement (row by row for image views).
+    using T = typename Elements::value_type;
+    IndexT pmin = 0, pmax = 0;
+    T minElement = elements[0], maxElement = elements[0];
+    forEachElement(elements, 1, n, [&](std::size_t p, T value) {
+      if (value < minElement) { minElement = value; pmin = static_cast<IndexT>(p); }
+      if (!(value < maxElement)) { maxElement = value; pmax = static_cast<IndexT>(p); }
+    });
+    const int minValue = minElement, maxValue = maxElement;
+    const int nlevels = maxValue - minValue + 1;
+    const bool maxTree = treeType == TreeType::MaxTree;
+    auto level = [minValue, maxValue, maxTree](T value) {
+      return maxTree ? static_cast<int>(value) - minValue : maxValue - static_cast<int>(value);
+    };
+    auto lvl = [&elements, &level](IndexT p) { return level(elements[p]); };
+
+    // Hierarchical queue: the level l uses queue[head[l], tail[l]). Each element is queued 
+    // exactly once, so the segment of a level has the size of its histogram.
+    auto &queue = buffers.queue;
+    auto &head = buffers.head;
+    auto &tail = buffers.tail;
+    queue.resize(n);
+    head.assign(nlevels + 1, 0);
+    forEachElement(elements, 0, n, [&](std::size_t, T value) { head[level(value) + 1]++; });
+    for (int l = 1; l <= nlevels; ++l)
+      head[l] += head[l-1];
+    tail.assign(head.begin(), head.end() - 1);
+
+    auto &stack = buffers.stack;
+    stack.clear();
+    int current = 0;
+    auto push = [&](IndexT p) {
+      auto l = lvl(p);
+      parent[p] = INQUEUE;
+      queue[tail[l]++] = p;
+      if (l > current) current = l;
+    };
+
+    // The flooding starts at an element of the lowest level, which is the representative of the 
+    // root node. Each node is represented by its first flooded element and 'stack' stores the 
+    // representatives of the nodes being flooded from the lowest level to the highest one.
+    auto pstart = maxTree ? pmin : pmax;
+    push(pstart);
+    stack.push_back(pstart);
+
+    while (current >= 0) {
+      auto h = current;
+      auto p = queue[head[h]];
+
+      // Stop at the first neighbour higher than p, which is flooded before p is removed.
+      bool higher = false;
+      adj.forEachNeighbour(p, [&](IndexT q) {
+        if (!higher && parent[q] == UNDEF) {
+          push(q);
+          if (lvl(q) > h) {
+            stack.push_back(q);
+            higher = true;
+          }
+        }
+      });
+      if (higher)
+        continue;
+
+      head[h]++;
+      parent[p] = stack.back();
+      while (current >= 0 && head[current] == tail[current])
+        current--;
+
+      // When the next element is lower than p, the nodes above its level are complete.
+      if (current >= 0 && current < h) {
+        while (lvl(stack.back()) > current) {
+          auto r = stack.back();
+          stack.pop_back();
+          if (stack.empty() || lvl(stack.back()) < current)
+            stack.push_back(queue[head[current]]);
+          parent[r] = stack.back();
+        }
+      }
+    }
+
+    for (size_t i = stack.size() - 1; i > 0; --i)
+      parent[stack[i]] = stack[i-1];
+    parent[stack.front()] = stack.front();
+
+    // Choose the element with the lowest index of each node as its canonical element, as the 
+    // union-find does with stable sorts. 'canon' (which reuses the queue) maps representatives
+    // to canonical elements.
+    auto &canon = queue;
+    std::fill(canon.begin(), canon.end(), UNDEF);
+    forEachElement(elements, 0, n, [&](std::size_t i, T value) {
+      auto p = static_cast<IndexT>(i);
+      auto rep = (parent[p] == p || lvl(parent[p]) != level(value)) ? p : parent[p];
+      if (canon[rep] == UNDEF)
+        canon[rep] = p;
+    });
+
+    auto root = stack.front();
+    for (IndexT p = 0; p < n; ++p) {
+      if (canon[p] != UNDEF && p != root)
+        parent[p] = canon[parent[p]];
+    }
+
+    for (IndexT p = 0; p < n; ++p) {
+      if (canon[p] == UNDEF) {
+        parent[p] = canon[parent[p]];
+      }
+      else if (canon[p] != p) {
+        auto c = canon[p];
+        parent[c] = (p == root) ? c : parent[p];
+        parent[p] = c;
+      }
+    }
+
+    // The canonical elements sorted by level (and index) define the node order of the tree.
+    auto &offset = head;
+    offset.assign(nlevels + 1, 0);
+    auto isCanonical = [&parent, &lvl](IndexT p, int l) { return parent[p] == p || lvl(parent[p]) != l; };
+    forEachElement(elements, 0, n, [&](std::size_t p, T value) {
+      auto l = level(value);
+      if (isCanonical(static_cast<IndexT>(p), l)) offset[l + 1]++;
+    });
+    for (int l = 1; l <= nlevels; ++l)
+      offset[l] += offset[l-1];
+
+    sortedLevelRoots.resize(offset.back());
+    forEachElement(elements, 0, n, [&](std::size_t p, T value) {
+      auto l = level(value);
+      if (isCanonical(static_cast<IndexT>(p), l)) sortedLevelRoots[offset[l]++] = static_cast<IndexT>(p);
+    });
+  }
+
+  template<typename Tree, typename Elements, typename Adj>
+  Tree CTBuilder::buildByFlooding(std::shared_ptr<CTMeta> pmeta, const Elements &elements, Adj &adj,
+    TreeType treeType, std::false_type)
+  {
+    // The builds only flood integer types of up to 16 bits, so the other types are sorted.
+    return buildTree<Tree>(pmeta, elements, adj, treeType);
   }
 
   /* ==================================[ CANONIZE TREE ]========================================================================== */
-  template<typename T>
-  void CTBuilder::canonizeTree(const std::vector<T>& elements, const std::vector<int>& sortedIndices,
-					      std::vector<int>& parent) const
+  template<typename Elements, typename IndexT>
+  void CTBuilder::canonizeTree(const Elements& elements, const std::vector<IndexT>& sortedIndices,
+					      std::vector<IndexT>& parent) const
   {
     for (size_t i = 0; i < sortedIndices.size(); i++) {
       auto p = sortedIndices[i];
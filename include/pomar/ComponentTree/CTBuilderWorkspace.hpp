@@ -0,0 +1,84 @@
+#include <pomar/Core/Sort.hpp>
+
+#include <vector>
+#include <cstddef>
+
+#ifndef CTBUILDER_WORKSPACE_HPP_INCLUDED
+#define CTBUILDER_WORKSPACE_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  class CTBuilder;
+
+  /** 
+   * Scratch arrays of the union-find of CTBuilder (indexed relative to the first element of the
+   * processed range). */
+  template<typename IndexT>
+  struct UnionFindBuffers
+  {
+    std::vector<IndexT> zpar;
+    std::vector<IndexT> repr;
+    std::vector<unsigned char> rank;
+  };
+
+  /** Scratch arrays of the flooding of CTBuilder (the hierarchical queue and the node stack). */
+  template<typename IndexT>
+  struct FloodingBuffers
+  {
+    std::vector<IndexT> queue;
+    std::vector<IndexT> head;
+    std::vector<IndexT> tail;
+    std::vector<IndexT> stack;
+  };
+
+  /**
+   * Scratch memory of CTBuilder for repeated builds (e.g. the frames of a video): the sorted
+   * indices, the parent array, the union-find, flooding and sorting arrays. They are owned by the
+   * workspace and keep their capacity between builds, so building trees of images of the same
+   * size again with CTBuilder::buildCompact(..., workspace, tree) does not allocate memory
+   * (the output CompactCTree also reuses its arrays). A workspace must not be shared by builds
+   * running at the same time: use one workspace per thread. */
+  template<typename T, typename IndexT = int>
+  class CTBuilderWorkspace
+  {
+  public:
+    /** Construct an empty workspace (its arrays grow in the first build). */
+    CTBuilderWorkspace() {}
+
+    /** Get the number of bytes reserved by the arrays of the workspace. */
+    std::size_t memoryUsage() const;
+
+    /** Release the memory of the workspace. */
+    void clear();
+
+  private:
+    friend class CTBuilder;
+
+    SortBuffers<T, IndexT> _sort;
+    UnionFindBuffers<IndexT> _unionFind;
+    FloodingBuffers<IndexT> _flooding;
+    std::vector<IndexT> _sortedIndices;
+    std::vector<IndexT> _parent;
+  };
+
+  /* ===================== [IMPLEMENTATION ] ================================================= */
+  template<typename T, typename IndexT>
+  std::size_t CTBuilderWorkspace<T, IndexT>::memoryUsage() const
+  {
+    return sizeof(IndexT) * (_sort.counter.capacity() + _sort.tmpIdx.capacity() + _unionFind.zpar.capacity() 
+      + _unionFind.repr.capacity() + _flooding.queue.capacity() + _flooding.head.capacity() 
+      + _flooding.tail.capacity() + _flooding.stack.capacity() + _sortedIndices.capacity() + _parent.capacity())
+      + sizeof(typename RadixKeyTypeOf<T>::type) * (_sort.keys.capacity() + _sort.tmpKeys.capacity())
+      + _unionFind.rank.capacity();
+  }
+
+  template<typename T, typename IndexT>
+  void CTBuilderWorkspace<T, IndexT>::clear()
+  {
+    *this = CTBuilderWorkspace<T, IndexT>();
+  }
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include <pomar/Core/ImageView.hpp>
+
 #ifndef CT_META_HPP_INCLUDED
 #define CT_META_HPP_INCLUDED
 
@@ -22,6 +24,11 @@ namespace pomar
      * height and number of channel. */ 
     CTMetaImage2D(int pwidth, int pheight, int pnchannel);
 
+    /** Constructor meta-information using the size of the image view 'view'. */
+    template<typename T>
+    explicit CTMetaImage2D(const ImageView2D<T> &view, int pnchannel = 1)
+      : CTMetaImage2D(view.width(), view.height(), pnchannel) {}
+
     inline int width() const { return _width; } /**< Input image width. */
     inline int height() const { return _height; } /**< Input image height. */
     inline int nchannel() const { return _nchannel; } /**< Input image number of channels. */
@@ -32,5 +39,63 @@ namespace pomar
     int _height;
     int _nchannel;
   };
+
+  /** 
+   * Component tree from a region of interest (ROI) of an Image2D meta-information. The width and
+   * the height are the ones of the ROI, whose elements are indexed as a tight image (local 
+   * indices), and the ROI position in the whole image maps them to the global indices of the 
+   * image (y * imageWidth + x). */
+  class CTMetaImageROI2D : public CTMetaImage2D
+  {
+  public:
+    CTMetaImageROI2D() = delete;
+    /** Constructor meta-information of the ROI of size pwidth x pheight whose top-left pixel is
+     * (px, py) in an image of size pimageWidth x pimageHeight. It throws std::invalid_argument 
+     * if the ROI is not inside the image. */
+    CTMetaImageROI2D(int pimageWidth, int pimageHeight, int px, int py, int pwidth, int pheight, 
+      int pnchannel = 1);
+
+    inline int x() const { return _x; } /**< Column of the top-left pixel of the ROI. */
+    inline int y() const { return _y; } /**< Row of the top-left pixel of the ROI. */
+    inline int imageWidth() const { return _imageWidth; } /**< Width of the whole image. */
+    inline int imageHeight() const { return _imageHeight; } /**< Height of the whole image. */
+
+    /** Get the global index (in the whole image) of the element with local index 'p'. */
+    inline long long globalIndex(long long p) const
+    {
+      return (_y + p / width()) * static_cast<long long>(_imageWidth) + _x + p % width();
+    }
+
+    /** Get the local index of the pixel with global index 'g' (-1 if it is outside the ROI). */
+    long long localIndex(long long g) const;
+
+  private:
+    int _imageWidth;
+    int _imageHeight;
+    int _x;
+    int _y;
+  };
+
+  /** Component tree from Image3D (volume) meta-information. */
+  class CTMetaImage3D : public virtual CTMeta
+  {
+  public:
+    CTMetaImage3D() = delete;
+    /** Constructor meta-information using volume input's width,
+     * height, depth and number of channel. */
+    CTMetaImage3D(int pwidth, int pheight, int pdepth, int pnchannel);
+
+    inline int width() const { return _width; } /**< Input volume width. */
+    inline int height() const { return _height; } /**< Input volume height. */
+    inline int depth() const { return _depth; } /**< Input volume depth (number of slices). */
+    inline int nchannel() const { return _nchannel; } /**< Input volume number of channels. */
+
+    ~CTMetaImage3D();
+  private:
+    int _width;
+    int _height;
+    int _depth;
+    int _nchannel;
+  };
 }
 #endif
\ No newline at end of file
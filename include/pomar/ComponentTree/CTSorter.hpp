@@ -3,8 +3,10 @@
 #include <numeric>
 #include <limits>
 #include <type_traits>
+#include <cstddef>
 
 #include <pomar/Core/Sort.hpp>
+#include <pomar/Core/ImageView.hpp>
 
 #ifndef CTSORTER_HPP_INCLUDED
 #define CTSORTER_HPP_INCLUDED
@@ -15,33 +17,116 @@ namespace pomar
 {
   /** 
    * Function used to sort the pixels of an image in the component tree building algorithm, 
-   * such that, the resulting tree is the max-tree. */
-  template<typename T>
-  std::vector<int> maxTreeSort(const std::vector<T> &elements);
+   * such that, the resulting tree is the max-tree. The sorting algorithm is chosen at compile
+   * time (see SortStrategy): counting sort for 8 and 16-bit unsigned types, radix sort for the other
+   * integer types, float and double. The indices have the type IndexT (int by default). */
+  template<typename T, typename IndexT = int>
+  std::vector<IndexT> maxTreeSort(const std::vector<T> &elements);
 
   /**
    * Function used to sort the pixels of an image in the component tree building algorithm,
    * such that, the resulting tree is the min-tree. */
-  template<typename T>
-  std::vector<int> minTreeSort(const std::vector<T> &elements);
+  template<typename T, typename IndexT = int>
+  std::vector<IndexT> minTreeSort(const std::vector<T> &elements);
+
+  /**
+   * Same as maxTreeSort(elements) using 'nthreads' threads (it returns the same order). */
+  template<typename T, typename IndexT = int>
+  std::vector<IndexT> parallelMaxTreeSort(const std::vector<T> &elements, int nthreads);
+
+  /**
+   * Same as minTreeSort(elements) using 'nthreads' threads (it returns the same order). */
+  template<typename T, typename IndexT = int>
+  std::vector<IndexT> parallelMinTreeSort(const std::vector<T> &elements, int nthreads);
+
+  /**
+   * Sorter of the elements in the order of the min-tree (or the max-tree if 'MinTree' is false) 
+   * whose sorting algorithm is chosen at compile time by 'SortTag' (see SortAlgorithm), such 
+   * that, only this algorithm is instantiated. */
+  template<bool MinTree, typename SortTag = DefaultSortTag>
+  struct TreeSorter
+  {
+    /** Sort the elements using 'nthreads' threads (the result is the same as minTreeSort or maxTreeSort). */
+    template<typename IndexT = int, typename T>
+    static std::vector<IndexT> sort(const std::vector<T> &elements, int nthreads = 1);
+
+    /** Sort the pixels of the image view 'elements' using 'nthreads' threads (row by row). */
+    template<typename IndexT = int, typename T>
+    static std::vector<IndexT> sort(const ImageView2D<T> &elements, int nthreads = 1);
+  };
+
+  /**
+   * Get the order of the dual tree from the order 'sortedIndices' of the elements of a tree,
+   * in linear time: the order is reversed and the equal elements keep their increasing index
+   * order. It returns minTreeSort(elements) from maxTreeSort(elements) and vice versa. The 
+   * elements can be a std::vector or an ImageView2D. */
+  template<typename Elements, typename IndexT>
+  std::vector<IndexT> dualTreeSort(const Elements &elements, const std::vector<IndexT> &sortedIndices);
 
 
   /* ====================[ IMPLEMENTATION ]============================================= */
-  template<typename T>
-  std::vector<int> maxTreeSort(const std::vector<T> &elements)
+  template<typename T, typename IndexT>
+  std::vector<IndexT> maxTreeSort(const std::vector<T> &elements)
   {    
-    if (isLowSizeType<T>())      
-      return incresingCountingSortIndex(elements);
-    return STLsortIndex<T>(elements, [](const T& v1, const T& v2) { return v1 < v2; });           
+    return increasingSortIndex<T, IndexT>(elements);
   }
 
 
-  template<typename T>
-  std::vector<int> minTreeSort(const std::vector<T> &elements)
+  template<typename T, typename IndexT>
+  std::vector<IndexT> minTreeSort(const std::vector<T> &elements)
+  {
+    return decreasingSortIndex<T, IndexT>(elements);
+  }
+
+  template<typename T, typename IndexT>
+  std::vector<IndexT> parallelMaxTreeSort(const std::vector<T> &elements, int nthreads)
+  {
+    return increasingSortIndex<T, IndexT>(elements, nthreads);
+  }
+
+  template<typename T, typename IndexT>
+  std::vector<IndexT> parallelMinTreeSort(const std::vector<T> &elements, int nthreads)
+  {
+    return decreasingSortIndex<T, IndexT>(elements, nthreads);
+  }
+
+  template<bool MinTree, typename SortTag>
+  template<typename IndexT, typename T>
+  std::vector<IndexT> TreeSorter<MinTree, SortTag>::sort(const std::vector<T> &elements, int nthreads)
+  {
+    using Algorithm = typename SortAlgorithm<SortTag, T>::type;
+    return MinTree ? decreasingSortIndex<T, IndexT>(elements, nthreads, Algorithm()) : 
+      increasingSortIndex<T, IndexT>(elements, nthreads, Algorithm());
+  }
+
+  template<bool MinTree, typename SortTag>
+  template<typename IndexT, typename T>
+  std::vector<IndexT> TreeSorter<MinTree, SortTag>::sort(const ImageView2D<T> &elements, int nthreads)
+  {
+    std::vector<IndexT> idx;
+    SortBuffers<T, IndexT> buffers;
+    sortIndexInto(elements, MinTree, idx, buffers, nthreads, SortTag());
+    return idx;
+  }
+
+  template<typename Elements, typename IndexT>
+  std::vector<IndexT> dualTreeSort(const Elements &elements, const std::vector<IndexT> &sortedIndices)
   {
-    if (isLowSizeType<T>())
-      return decreasingCountingSortIndex(elements);
-    return STLsortIndex<T>(elements, [](const T& v1, const T& v2){ return v1 > v2; });
+    using T = typename Elements::value_type;
+    // Each run of equal elements is copied from the end of 'sortedIndices' in its own order. 
+    const std::size_t n = sortedIndices.size();
+    std::vector<IndexT> dual(n);
+    std::size_t end = n, pos = 0;
+    while (end > 0) {
+      auto begin = end - 1;
+      const T &level = elements[sortedIndices[begin]];
+      while (begin > 0 && elements[sortedIndices[begin-1]] == level)
+        --begin;
+      pos = std::copy(sortedIndices.begin() + begin, sortedIndices.begin() + end, dual.begin() + pos) 
+        - dual.begin();
+      end = begin;
+    }
+    return dual;
   }
 }
 #endif
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include <pomar/ComponentTree/CTMeta.hpp>
+#include <pomar/Core/Parallel.hpp>
+#include <pomar/Core/ImageView.hpp>
 
 #include <iostream>
 #include <vector>
@@ -7,6 +9,8 @@
 #include <cstddef>
 #include <memory>
 #include <algorithm>
+#include <type_traits>
+#include <stdexcept>
 #include <iostream>
 
 #ifndef MORPHOLOGICAL_TREE_H_INCLUDED
@@ -21,50 +25,59 @@ namespace pomar
   * It stores a list of identification of the elements which
   * represent its node and the full component tree node can be reconstructed using
   * the elements of this node and the full representation of its children nodes.
-  * This class is not meant to be used outside the class CTree.
+  * This class is not meant to be used outside the class CTree. IndexT is the (signed)
+  * integer type of the node and element ids.
   */
-  template<class NT>
+  template<class NT, class IndexT = int>
   class CTNode
   {
   public:
     /** Default constructor. */
     CTNode();
     /** Construct a component tree node with an id and level. */
-    CTNode(int id, NT level);
+    CTNode(IndexT id, NT level);
 
-    inline int id() const { return _id; } /**< Get node's id. */
-    inline void id(int id) { _id = id; } /**< Set node's id.  */
+    inline IndexT id() const { return _id; } /**< Get node's id. */
+    inline void id(IndexT id) { _id = id; } /**< Set node's id.  */
 
     inline const NT& level() const { return _level; } /**< Get node's level. */
     inline void level(const NT& level) { _level = level; } /**< Set node's level. */
 
     /** Get parent node id. */
-    inline int parent() const { return _parent; }
+    inline IndexT parent() const { return _parent; }
     /** Set parent node id. */
-    inline void parent(int parent) { _parent = parent; }
+    inline void parent(IndexT parent) { _parent = parent; }
 
     /** Get an array with the id for each child node. */
-    inline const std::vector<int>& children() const { return _children; }
+    inline const std::vector<IndexT>& children() const { return _children; }
     /** Add a child node id. */
-    inline void addChild(int child) { _children.push_back(child); }
+    inline void addChild(IndexT child) { _children.push_back(child); }
     /** Remove a child node id*/
-    inline void removeChild(int child) { _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end()); }
+    inline void removeChild(IndexT child) { _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end()); }
 		/** Change the id of the child at position cpos */
-		inline void child(int cpos, int id) { _children[cpos] = id; }
+		inline void child(size_t cpos, IndexT id) { _children[cpos] = id; }
+    /** Remove the children ids for which 'pred' is true (in a single pass). */
+    template<class Pred>
+    inline void removeChildrenIf(Pred pred) { _children.erase(std::remove_if(_children.begin(), _children.end(), pred), _children.end()); }
 
     /** Get the array with the id for each element stored in this node.  */
-    inline const std::vector<int>& elementIndices() const { return _elementIndices; }
+    inline const std::vector<IndexT>& elementIndices() const { return _elementIndices; }
     /** Add an id to the element set of this node.*/
-    inline void addElementIndex(int elementIndex) { _elementIndices.push_back(elementIndex); }
+    inline void addElementIndex(IndexT elementIndex) { _elementIndices.push_back(elementIndex); }
     /** Insert a range of element indices to the elements set. */
-    void insertElementIndices(const std::vector<int>& indices);
+    void insertElementIndices(const std::vector<IndexT>& indices);
+
+    /** Reserve space for 'n' children. */
+    inline void reserveChildren(size_t n) { _children.reserve(n); }
+    /** Reserve space for 'n' element indices. */
+    inline void reserveElementIndices(size_t n) { _elementIndices.reserve(n); }
   private:
-    int _id;
+    IndexT _id;
     NT _level;
-    int _parent;
+    IndexT _parent;
 
-    std::vector<int> _children;
-    std::vector<int> _elementIndices;
+    std::vector<IndexT> _children;
+    std::vector<IndexT> _elementIndices;
   };
 
   /* ================ ALIASES ================================================== */
@@ -79,29 +92,57 @@ namespace pomar
 
 
   /* =============== CTNODE CONTRUCTORS ========================================= */
-  template<class NT>
-  CTNode<NT>::CTNode()
+  template<class NT, class IndexT>
+  CTNode<NT, IndexT>::CTNode()
   {}
 
-  template<class NT>
-  CTNode<NT>::CTNode(int id, NT level)
+  template<class NT, class IndexT>
+  CTNode<NT, IndexT>::CTNode(IndexT id, NT level)
     :_id(id), _level(level)
   {}
 
-  template<class NT>
-  void CTNode<NT>::insertElementIndices(const std::vector<int>& indices)
+  template<class NT, class IndexT>
+  void CTNode<NT, IndexT>::insertElementIndices(const std::vector<IndexT>& indices)
   {
 		_elementIndices.insert(_elementIndices.end(), indices.begin(), indices.end());
   }
 
 
+  /* ========================[ RECONSTRUCTION ]=================================================== */
+  /** 
+   * Write the level 'levelOf(nodeOf(p))' of the node of each element p in [0, size) into 'out[p]'.
+   * The elements are split in 'nthreads' contiguous chunks, each one written by its own thread, so
+   * the output is written sequentially. It is used by the component trees and by the filters to
+   * write their images into a buffer. */
+  template<class T, class NodeOf, class LevelOf>
+  void writeNodeLevels(std::size_t size, NodeOf nodeOf, LevelOf levelOf, T *out, int nthreads = 1);
+
+  /** 
+   * Write the level of the node of each pixel of a 'width' x 'height' image (see writeNodeLevels) 
+   * into 'out', whose rows start 'rowStride' values apart. The rows are split among 'nthreads' 
+   * threads. */
+  template<class T, class NodeOf, class LevelOf>
+  void writeNodeLevels(int width, int height, NodeOf nodeOf, LevelOf levelOf, T *out, 
+    std::ptrdiff_t rowStride, int nthreads = 1);
+
   /**
   * This class represents a component tree using its compact representation.
+  * The node and element ids have the signed integer type IndexT: int by default,
+  * a wider type (e.g. long long) for images of more than 2^31 pixels or a narrower 
+  * one (e.g. short) to reduce the memory of small images.
   */
-  template<class T>
+  template<class T, class IndexT = int>
   class CTree
   {
   public:
+    static_assert(std::is_integral<IndexT>::value && std::is_signed<IndexT>::value, 
+      "IndexT must be a signed integer type");
+
+    /** Type of the nodes of this tree. */
+    using NodeType = CTNode<T, IndexT>;
+    /** Type of the node and element ids. */
+    using IndexType = IndexT;
+
     /** Default constructor */
     CTree() {}
 
@@ -109,38 +150,55 @@ namespace pomar
     *   the indices of the elements set ordered (this order define the type of
     *   the tree such as max-tree or min-tree).
     */
-    CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<int>& parent, const std::vector<int>& sortedIndices, 
+    CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, const std::vector<IndexT>& sortedIndices, 
       const std::vector<T>& elements);
 
+    /** Construct a component tree whose elements are the pixels of the image view 'elements'. */
+    CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, const std::vector<IndexT>& sortedIndices, 
+      const ImageView2D<T>& elements);
+
     /** Transverse the tree from the leaves to the node calling the visit callback
     *   for each node. This transverse guarantees that all children nodes are
     *   visited before it visits theirs parent node.
     */
-    void transverse(std::function<void(const CTNode<T>&)> visit) const;
+    void transverse(std::function<void(const CTNode<T, IndexT>&)> visit) const;
 
     /** Get the number of nodes of the tree. */
     inline size_t numberOfNodes() const { return _nodes.size(); }
+    /** Get the number of elements (pixels) of the tree. */
+    inline size_t numberOfElements() const { return _cmap.size(); }
 
     /** Get the level of the node identified by id. */
-    inline const T& nodeLevel(int id) const { return _nodes[id].level(); }
+    inline const T& nodeLevel(IndexT id) const { return _nodes[id].level(); }
     /** Get parent id of the node identified by the id. */
-    inline int nodeParent(int id) const { return _nodes[id].parent(); }
+    inline IndexT nodeParent(IndexT id) const { return _nodes[id].parent(); }
     /** Get the children node ids of the node identified by id. */
-    inline const std::vector<int>& nodeChildren(int id) const { return _nodes[id].children(); }
+    inline const std::vector<IndexT>& nodeChildren(IndexT id) const { return _nodes[id].children(); }
     /** Returns an array with the identification of each element stored in this node. */
-    inline const std::vector<int>& nodeElementIndices(int id) const { return _nodes[id].elementIndices(); }
+    inline const std::vector<IndexT>& nodeElementIndices(IndexT id) const { return _nodes[id].elementIndices(); }
     /** Return the id of the node which the element is stored */
-    inline int nodeByElement(int element) const { return _cmap[element]; }
+    inline IndexT nodeByElement(IndexT element) const { return _cmap[element]; }
+    /** 
+    * Get the global indices of the elements stored in the node identified by id: the indices 
+    * in the whole image for a tree of a region of interest (CTMetaImageROI2D) and the element
+    * indices otherwise. */
+    std::vector<long long> nodeGlobalElementIndices(IndexT id) const;
+    /** 
+    * Return the id of the node which stores the element with global index 'g' (see 
+    * nodeGlobalElementIndices), or -1 if it is not an element of the tree. */
+    IndexT nodeByGlobalElement(long long g) const;
     /** Return a node with the id passed by the parameter  */
-    inline const CTNode<T>& node(int id) const { return _nodes[id]; }
+    inline const CTNode<T, IndexT>& node(IndexT id) const { return _nodes[id]; }
     /** Reconstruct the full component tree node identified by id. */
-    std::vector<int> reconstructNode(int id);
+    std::vector<IndexT> reconstructNode(IndexT id) const;
 
     /** Prune nodes which 'shouldPrune' is true. This function removes all nodes
     *   which shouldPrune is true and all theirs decendents. This function
-    *   modifies the component tree object that calls it.
+    *   modifies the component tree object that calls it. The root is never pruned
+    *   and the running time is linear in the number of nodes and elements, whatever
+    *   the depth of the tree.
     */
-    void prune(std::function<bool(const CTNode<T>&)> shouldPrune);
+    void prune(std::function<bool(const CTNode<T, IndexT>&)> shouldPrune);
 
     /** TODO: Write description. */
     inline std::shared_ptr<CTMeta> meta() const { return _meta; }
@@ -148,23 +206,32 @@ namespace pomar
     /** Convert the component tree to the array representation. */
     std::vector<T> convertToVector() const;
 
+    /** Write the array representation of the component tree into 'out', which has room for
+    *   numberOfElements() values. The elements are written in order, split in 'nthreads' chunks.
+    */
+    void convertTo(T *out, int nthreads = 1) const;
+
+    /** Write the image of the component tree of a 2D image (CTMetaImage2D) into 'out', whose rows
+    *   start 'rowStride' values apart (e.g. a region of a larger image). The rows are split among
+    *   'nthreads' threads. It throws std::invalid_argument if the tree is not of a 2D image.
+    */
+    void convertToRows(T *out, std::ptrdiff_t rowStride, int nthreads = 1) const;
+
   private:
-    void createNodes(const std::vector<int>& parent, const std::vector<int>& sortedIndices, const std::vector<T>& elements);
-    void _reconstructNode(int id, std::vector<int>& rec);
+    template<class Elements>
+    void createNodes(const std::vector<IndexT>& parent, const std::vector<IndexT>& sortedIndices, const Elements& elements);
 
 
     std::vector<bool> removeChildrenAndReturnsPrunnedNodeMap(
-        std::function<bool(const CTNode<T>&)> shouldPrune);
-    void _prune(CTNode<T>& node, std::vector<bool>& prunnedNodes);
-    void _rprune(CTNode<T>& keptNode, CTNode<T>& nodeToPrune, std::vector<bool>& prunnedNodes);
+        std::function<bool(const CTNode<T, IndexT>&)> shouldPrune);
     void removePrunnedNodes(const std::vector<bool> &prunnedNodes);
-    void updateChildrenIdFromPrune(const std::vector<int> &lut);
-    std::vector<int> updateParentIdAndCreateLut(const std::vector<bool> &prunnedNodes);
-    void updateCmap(const std::vector<int> lut);
+    void updateChildrenIdFromPrune(const std::vector<IndexT> &lut);
+    std::vector<IndexT> updateParentIdAndCreateLut(const std::vector<bool> &prunnedNodes);
+    void updateCmap(const std::vector<IndexT> &lut);
 	 
   protected:
-    std::vector<CTNode<T>> _nodes;
-    std::vector<int> _cmap;
+    std::vector<CTNode<T, IndexT>> _nodes;
+    std::vector<IndexT> _cmap;
     std::shared_ptr<CTMeta> _meta;
   };
 
@@ -179,182 +246,269 @@ namespace pomar
   using DCTree = CTree<double>;
 
   /* =========================[ MORPHOLOGICAL TREE - TRANSVERSAL ]================================ */
-  template<class T>
-  CTree<T>::CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<int>& parent, 
-    const std::vector<int>& sortedIndices, const std::vector<T>& elements): _meta{pmeta}
+  template<class T, class IndexT>
+  CTree<T, IndexT>::CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const std::vector<T>& elements): _meta{pmeta}
+  {
+    createNodes(parent, sortedIndices, elements);
+  }
+
+  template<class T, class IndexT>
+  CTree<T, IndexT>::CTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const ImageView2D<T>& elements): _meta{pmeta}
   {
     createNodes(parent, sortedIndices, elements);
   }
 
   /* ==========================[ MORPHOLOGICAL TREE - TRANSVERSAL ]================================ */
-  template<class T>
-  void CTree<T>::transverse(std::function<void(const CTNode<T>&)> visit) const
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::transverse(std::function<void(const CTNode<T, IndexT>&)> visit) const
   {
-    for (int i = _nodes.size()-1; i >= 0; --i)
+    for (IndexT i = _nodes.size()-1; i >= 0; --i)
       visit(_nodes[i]);
   }
 
   /* ==========================[ MORPHOLOGICAL TREE - CREATE NODES ]=============================== */
-  template<class T>
-  void CTree<T>::createNodes(const std::vector<int> &parent, const std::vector<int> &sortedIndices,
-					  const std::vector<T> &elements)
+  template<class T, class IndexT>
+  template<class Elements>
+  void CTree<T, IndexT>::createNodes(const std::vector<IndexT> &parent, const std::vector<IndexT> &sortedIndices,
+					  const Elements &elements)
   {
-    const int UNDEF = -1;
-    std::vector<int> sortedLevelRoots;
+    // The children and element indices of each node are counted before they are inserted, 
+    // so each vector is allocated once with its exact size. It keeps the memory footprint
+    // of large images and volumes close to the size of the data.
+    const IndexT UNDEF = -1;
     _cmap.resize(elements.size(), UNDEF);
 
-    for (size_t i = 0; i < sortedIndices.size(); ++i) {
-      auto p = sortedIndices[i];
-      if (elements[parent[p]] != elements[p] || parent[p] == p)
-	      sortedLevelRoots.push_back(p);
-    }
-
-    _nodes.resize(sortedLevelRoots.size());
+    auto isLevelRoot = [&parent, &elements](IndexT p) { 
+      return elements[parent[p]] != elements[p] || parent[p] == p; 
+    };
 
-    auto p = sortedLevelRoots.front();
-    auto& root = _nodes[0];
-    _cmap[p] = 0;
-    root.id(0);
-    root.level(elements[p]);
-    root.addElementIndex(p);
-    root.parent(UNDEF);
+    // The levels are only compared once per element: then the level roots are the elements
+    // already mapped to a node.
+    size_t nnodes = 0;
+    for (auto p : sortedIndices) {
+      if (isLevelRoot(p)) _cmap[p] = static_cast<IndexT>(nnodes++);
+    }
 
+    std::vector<IndexT> sortedLevelRoots(nnodes);
+    for (auto p : sortedIndices) {
+      if (_cmap[p] != UNDEF)
+	      sortedLevelRoots[_cmap[p]] = p;
+    }
 
-    for (size_t i = 1; i < sortedLevelRoots.size(); i++) {
+    _nodes.resize(nnodes);
+    std::vector<IndexT> count(nnodes, 0);
+    for (size_t i = 0; i < sortedLevelRoots.size(); i++) {
       auto p = sortedLevelRoots[i];
       _cmap[p] = i;
       auto& node = _nodes[i];
-      auto& parentNode = _nodes[_cmap[parent[p]]];
       node.id(i);
-      node.parent(parentNode.id());
       node.level(elements[p]);
-      node.addElementIndex(p);
-      parentNode.addChild(node.id());
+      node.parent(i == 0 ? UNDEF : _cmap[parent[p]]);
+      if (i > 0) count[node.parent()]++;
+    }
+
+    for (size_t i = 0; i < nnodes; i++) {
+      _nodes[i].reserveChildren(count[i]);
+      count[i] = 1;
     }
+    for (size_t i = 1; i < nnodes; i++)
+      _nodes[_nodes[i].parent()].addChild(i);
 
     for (size_t i = 0; i < elements.size(); i++) {
       if (_cmap[i] == UNDEF) {
       	_cmap[i] = _cmap[parent[i]];
-      	_nodes[_cmap[i]].addElementIndex(i);
+        count[_cmap[i]]++;
       }
     }
+
+    for (size_t i = 0; i < nnodes; i++) {
+      _nodes[i].reserveElementIndices(count[i]);
+      _nodes[i].addElementIndex(sortedLevelRoots[i]);
+    }
+    for (size_t i = 0; i < elements.size(); i++) {
+      if (_nodes[_cmap[i]].elementIndices().front() != static_cast<IndexT>(i))
+        _nodes[_cmap[i]].addElementIndex(i);
+    }
   }
 
   /* ====================[ COMPONENT TREE - RECONSTRUCT NODE ]========================== */
-  template<class T>
-  std::vector<int> CTree<T>::reconstructNode(int id)
+  template<class T, class IndexT>
+  std::vector<IndexT> CTree<T, IndexT>::reconstructNode(IndexT id) const
   {
-    std::vector<int> rec;
-    this->_reconstructNode(id, rec);
+    // The nodes of the subtree of 'id' are visited in depth-first order using a stack, 
+    // so deep trees do not overflow the call stack.
+    std::vector<IndexT> rec;
+    std::vector<IndexT> stack{id};
+    while (!stack.empty()) {
+      auto n = stack.back();
+      stack.pop_back();
+      const auto &elems = nodeElementIndices(n);
+      rec.insert(rec.end(), elems.begin(), elems.end());
+      const auto &children = nodeChildren(n);
+      stack.insert(stack.end(), children.rbegin(), children.rend());
+    }
     return rec;
   }
 
-  template<class T>
-  void CTree<T>::_reconstructNode(int id, std::vector<int>& rec)
+  /* ==================[ COMPONENT TREE - GLOBAL ELEMENT INDICES ]========================== */
+  template<class T, class IndexT>
+  std::vector<long long> CTree<T, IndexT>::nodeGlobalElementIndices(IndexT id) const
   {
-    auto nodeElements = nodeElementIndices(id);
-    auto children = nodeChildren(id);
-    rec.insert(std::end(rec), std::begin(nodeElements), std::end(nodeElements));
+    const auto &elems = nodeElementIndices(id);
+    std::vector<long long> global(elems.begin(), elems.end());
+    if (auto roi = dynamic_cast<const CTMetaImageROI2D*>(_meta.get())) {
+      for (auto &p : global)
+        p = roi->globalIndex(p);
+    }
+    return global;
+  }
 
-    for (auto c: children)
-      this->_reconstructNode(c, rec);
+  template<class T, class IndexT>
+  IndexT CTree<T, IndexT>::nodeByGlobalElement(long long g) const
+  {
+    auto roi = dynamic_cast<const CTMetaImageROI2D*>(_meta.get());
+    auto p = roi ? roi->localIndex(g) : g;
+    return (p < 0 || p >= static_cast<long long>(_cmap.size())) ? IndexT(-1) : _cmap[p];
   }
 
   /* ==================[ COMPONENT TREE - CONVERT TO VECTOR ]=============================== */
-  template<class T>
-  std::vector<T> CTree<T>::convertToVector() const
+  template<class T, class IndexT>
+  std::vector<T> CTree<T, IndexT>::convertToVector() const
   {
     std::vector<T> v(_cmap.size());
-    for (auto& node: _nodes) {
-      for(auto e : node.elementIndices())
-        v[e] = node.level();
-    }
-
+    convertTo(v.data());
     return v;
   }
 
-  /* ===================[ PRUNNING ]===================================================== */
-  template<class T>
-  void CTree<T>::prune(std::function<bool(const CTNode<T>&)> shouldPrune)
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::convertTo(T *out, int nthreads) const
   {
-    auto prunnedNodes = removeChildrenAndReturnsPrunnedNodeMap(shouldPrune);
-    auto lut = updateParentIdAndCreateLut(prunnedNodes);
-    removePrunnedNodes(prunnedNodes);
-    updateChildrenIdFromPrune(lut);
-    updateCmap(lut);
+    writeNodeLevels(_cmap.size(), [this](size_t p) { return _cmap[p]; },
+      [this](IndexT id) { return _nodes[id].level(); }, out, nthreads);
   }
 
-  template<class T>
-  std::vector<bool> CTree<T>::removeChildrenAndReturnsPrunnedNodeMap(
-    std::function<bool(const CTNode<T>&)> shouldPrune)
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::convertToRows(T *out, std::ptrdiff_t rowStride, int nthreads) const
   {
-    std::vector<bool> prunnedNodes(_nodes.size(), false);
-    for (auto& node : _nodes) {
-	    if (!prunnedNodes[node.id()] && shouldPrune(node))
-	    	_prune(node, prunnedNodes);
-		}
+    auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(_meta);
+    if (!meta || static_cast<size_t>(meta->width()) * meta->height() != _cmap.size())
+      throw std::invalid_argument("the component tree is not of a 2D image");
+    writeNodeLevels(meta->width(), meta->height(), [this](size_t p) { return _cmap[p]; },
+      [this](IndexT id) { return _nodes[id].level(); }, out, rowStride, nthreads);
+  }
 
-    return prunnedNodes;
+  /* =====================[ RECONSTRUCTION - WRITE NODE LEVELS ]============================ */
+  template<class T, class NodeOf, class LevelOf>
+  void writeNodeLevels(std::size_t size, NodeOf nodeOf, LevelOf levelOf, T *out, int nthreads)
+  {
+    const int ntasks = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(
+      std::max(1, nthreads), size / 4096 + 1)));
+    auto boundaries = splitRange(size, ntasks);
+    parallelFor(ntasks, [&](int t) {
+      for (std::size_t p = boundaries[t]; p < boundaries[t+1]; ++p)
+        out[p] = levelOf(nodeOf(p));
+    });
   }
 
-  template<class T>
-  void CTree<T>::_prune(CTNode<T>& node, std::vector<bool>& prunnedNodes)
+  template<class T, class NodeOf, class LevelOf>
+  void writeNodeLevels(int width, int height, NodeOf nodeOf, LevelOf levelOf, T *out, 
+    std::ptrdiff_t rowStride, int nthreads)
+  {
+    const int ntasks = std::max(1, std::min(nthreads, height));
+    auto boundaries = splitRange(height, ntasks);
+    parallelFor(ntasks, [&](int t) {
+      for (int y = boundaries[t]; y < boundaries[t+1]; ++y) {
+        const std::size_t row = static_cast<std::size_t>(y) * width;
+        T *outRow = out + y * rowStride;
+        for (int x = 0; x < width; ++x)
+          outRow[x] = levelOf(nodeOf(row + x));
+      }
+    });
+  }
+
+  /* ===================[ PRUNNING ]===================================================== */
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::prune(std::function<bool(const CTNode<T, IndexT>&)> shouldPrune)
   {
-    auto& parent = _nodes[node.parent()];
-    _rprune(parent, node, prunnedNodes);
-    parent.removeChild(node.id());
+    auto prunnedNodes = removeChildrenAndReturnsPrunnedNodeMap(shouldPrune);
+    auto lut = updateParentIdAndCreateLut(prunnedNodes);
+    removePrunnedNodes(prunnedNodes);
+    updateChildrenIdFromPrune(lut);
+    updateCmap(lut);
   }
 
-  template<class T>
-  void CTree<T>::_rprune(CTNode<T>& keptNode, CTNode<T>& nodeToPrune, std::vector<bool>& prunnedNodes)
+  template<class T, class IndexT>
+  std::vector<bool> CTree<T, IndexT>::removeChildrenAndReturnsPrunnedNodeMap(
+    std::function<bool(const CTNode<T, IndexT>&)> shouldPrune)
   {
-    keptNode.insertElementIndices(nodeToPrune.elementIndices());
+    // Parents come before their children, so visiting the ids forwards decides a parent
+    // before its children: the descendants of a pruned node are pruned and merged into 
+    // the same kept node as their parent.
+    const size_t nnodes = _nodes.size();
+    std::vector<bool> prunnedNodes(nnodes, false);
+    std::vector<IndexT> keptNode(nnodes);
+    std::vector<size_t> mergedElements(nnodes, 0);
+    for (size_t i = 1; i < nnodes; i++) {
+      const auto& node = _nodes[i];
+      IndexT p = node.parent();
+      if (prunnedNodes[p] || shouldPrune(node)) {
+        prunnedNodes[i] = true;
+        keptNode[i] = prunnedNodes[p] ? keptNode[p] : p;
+        mergedElements[keptNode[i]] += node.elementIndices().size();
+      }
+    }
 
-	 for (auto elem: nodeToPrune.elementIndices())
-		_cmap[elem] = keptNode.id();
+    for (size_t i = 0; i < nnodes; i++) {
+      if (mergedElements[i] > 0)
+        _nodes[i].reserveElementIndices(_nodes[i].elementIndices().size() + mergedElements[i]);
+    }
+    for (size_t i = 1; i < nnodes; i++) {
+      if (!prunnedNodes[i]) continue;
+      auto& kept = _nodes[keptNode[i]];
+      kept.insertElementIndices(_nodes[i].elementIndices());
+      for (auto elem : _nodes[i].elementIndices())
+        _cmap[elem] = kept.id();
+    }
 
-    prunnedNodes[nodeToPrune.id()] = true;
-    for (auto c : nodeToPrune.children()) {
-      _rprune(keptNode, _nodes[c], prunnedNodes);
+    for (size_t i = 0; i < nnodes; i++) {
+      if (!prunnedNodes[i])
+        _nodes[i].removeChildrenIf([&prunnedNodes](IndexT c) { return prunnedNodes[c]; });
     }
+    return prunnedNodes;
   }
 
-  template<class T>
-  void CTree<T>::removePrunnedNodes(const std::vector<bool> &prunnedNodes)
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::removePrunnedNodes(const std::vector<bool> &prunnedNodes)
   {
     _nodes.erase(std::remove_if(_nodes.begin(), _nodes.end(),
-        [&prunnedNodes](CTNode<T>& node) {
+        [&prunnedNodes](CTNode<T, IndexT>& node) {
           return prunnedNodes[node.id()];
         }), _nodes.end());
   }
 
-  template<class T>
-  void CTree<T>::updateChildrenIdFromPrune(const std::vector<int> &lut)
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::updateChildrenIdFromPrune(const std::vector<IndexT> &lut)
   {
-	  auto& root = _nodes.front();    
-    auto children = root.children();
-    for(size_t c = 0; c < children.size(); c++) { 
-	    root.child(c, lut[children[c]]);
-    }
-
-    for (size_t i = 1; i < _nodes.size(); i++) {
+    for (size_t i = 0; i < _nodes.size(); i++) {
       auto& node = _nodes[i];
-      node.id(lut[node.id()]);
-      node.parent(lut[node.parent()]);
-      auto children = node.children();
-      
-      for(size_t c = 0; c < children.size(); c++) { 
-        node.child(c, lut[children[c]]);
+      if (i > 0) {
+        node.id(lut[node.id()]);
+        node.parent(lut[node.parent()]);
       }
+      const auto &children = node.children();
+      for(size_t c = 0; c < children.size(); c++) 
+        node.child(c, lut[children[c]]);
 		}
   }
 
-  template<class T>
-  std::vector<int> CTree<T>::updateParentIdAndCreateLut(
+  template<class T, class IndexT>
+  std::vector<IndexT> CTree<T, IndexT>::updateParentIdAndCreateLut(
     const std::vector<bool> &prunnedNodes)
   {
-    std::vector<int> lut(prunnedNodes.size());
-    int count = 0;
+    std::vector<IndexT> lut(prunnedNodes.size());
+    IndexT count = 0;
     for (size_t i = 1; i < _nodes.size(); i++) {
       if (prunnedNodes[i]) {
         count++;
@@ -366,8 +520,8 @@ namespace pomar
     return lut;
   }
 
-  template<class T>
-  void CTree<T>::updateCmap(const std::vector<int> lut)
+  template<class T, class IndexT>
+  void CTree<T, IndexT>::updateCmap(const std::vector<IndexT> &lut)
   {
      for(auto &c: _cmap)
         c = lut[c];
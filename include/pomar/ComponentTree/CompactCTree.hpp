@@ -0,0 +1,414 @@
+#include <pomar/ComponentTree/CTMeta.hpp>
+#include <pomar/ComponentTree/CTree.hpp>
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+#include <stdexcept>
+
+#ifndef COMPACT_CTREE_HPP_INCLUDED
+#define COMPACT_CTREE_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /** 
+  * Read-only view of a contiguous range of indices (e.g. the children or the elements 
+  * of a CompactCTree node). It is valid while the tree which owns the indices is. */
+  template<class IndexT>
+  class IndexRange
+  {
+  public:
+    /** Construct a view of [first, last). */
+    IndexRange(const IndexT *first, const IndexT *last): _first{first}, _last{last} {}
+
+    inline const IndexT* begin() const { return _first; } /**< Begin of the range. */
+    inline const IndexT* end() const { return _last; } /**< End of the range. */
+    inline size_t size() const { return _last - _first; } /**< Number of indices. */
+    inline bool empty() const { return _first == _last; } /**< Check whether the range is empty. */
+    inline IndexT operator[](size_t i) const { return _first[i]; } /**< The i-th index. */
+    inline IndexT front() const { return *_first; } /**< The first index. */
+
+    /** Copy the indices into a vector. */
+    inline std::vector<IndexT> toVector() const { return std::vector<IndexT>(_first, _last); }
+
+  private:
+    const IndexT *_first;
+    const IndexT *_last;
+  };
+
+  template<class T, class IndexT = int>
+  class CompactCTree;
+
+  /** 
+  * View of a node of a CompactCTree. It provides the same interface as CTNode, so the 
+  * attribute computers run on both trees. */
+  template<class T, class IndexT = int>
+  class CompactCTNode
+  {
+  public:
+    /** Construct a view of the node 'id' of 'tree'. */
+    CompactCTNode(const CompactCTree<T, IndexT> *tree, IndexT id): _tree{tree}, _id{id} {}
+
+    inline IndexT id() const { return _id; } /**< Get node's id. */
+    inline const T& level() const { return _tree->nodeLevel(_id); } /**< Get node's level. */
+    inline IndexT parent() const { return _tree->nodeParent(_id); } /**< Get parent node id. */
+    /** Get the id of each child node. */
+    inline IndexRange<IndexT> children() const { return _tree->nodeChildren(_id); }
+    /** Get the id of each element stored in this node. */
+    inline IndexRange<IndexT> elementIndices() const { return _tree->nodeElementIndices(_id); }
+
+  private:
+    const CompactCTree<T, IndexT> *_tree;
+    IndexT _id;
+  };
+
+  /**
+  * This class represents a component tree using its compact representation stored in flat
+  * arrays (structure of arrays): the parent and level of each node, the children of the nodes
+  * in a CSR layout (the children of the node i are _children[_childOffset[i], _childOffset[i+1]))
+  * and the elements of all nodes in a single array ordered by node (with the same layout).
+  * A tree with millions of nodes needs a few allocations only and its nodes are visited
+  * in order of memory. The nodes, children and elements are ordered as in CTree.
+  *
+  * The node and element ids have the signed integer type IndexT (int by default, see CTree).
+  *
+  * The tree is read-only: it is built by CTBuilder::buildCompact (or from a CTree) and its
+  * nodes are visited by CompactCTNode views.
+  */
+  template<class T, class IndexT>
+  class CompactCTree
+  {
+  public:
+    static_assert(std::is_integral<IndexT>::value && std::is_signed<IndexT>::value, 
+      "IndexT must be a signed integer type");
+
+    /** Type of the node views of this tree. */
+    using NodeType = CompactCTNode<T, IndexT>;
+    /** Type of the node and element ids. */
+    using IndexType = IndexT;
+
+    /** Default constructor. */
+    CompactCTree() {}
+
+    /** Construct a component tree using the parent array, an elements set and
+    *   the indices of the elements set ordered (see CTree).
+    */
+    CompactCTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+      const std::vector<IndexT>& sortedIndices, const std::vector<T>& elements);
+
+    /** Construct a component tree whose elements are the pixels of the image view 'elements'. */
+    CompactCTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+      const std::vector<IndexT>& sortedIndices, const ImageView2D<T>& elements);
+
+    /** Construct a compact copy of the component tree 'ct'. */
+    explicit CompactCTree(const CTree<T, IndexT> &ct);
+
+    /** Transverse the tree from the leaves to the root calling visit(node) for each node,
+    *   such that all children nodes are visited before their parent node.
+    */
+    template<typename F>
+    void transverse(F visit) const;
+
+    /** Get the number of nodes of the tree. */
+    inline size_t numberOfNodes() const { return _parent.size(); }
+    /** Get the number of elements of the tree. */
+    inline size_t numberOfElements() const { return _cmap.size(); }
+
+    /** Get the level of the node identified by id. */
+    inline const T& nodeLevel(IndexT id) const { return _level[id]; }
+    /** Get parent id of the node identified by the id (-1 for the root). */
+    inline IndexT nodeParent(IndexT id) const { return _parent[id]; }
+    /** Get the children node ids of the node identified by id. */
+    inline IndexRange<IndexT> nodeChildren(IndexT id) const 
+    { 
+      return IndexRange<IndexT>(_children.data() + _childOffset[id], _children.data() + _childOffset[id+1]);
+    }
+    /** Returns the identification of each element stored in this node. */
+    inline IndexRange<IndexT> nodeElementIndices(IndexT id) const 
+    {
+      return IndexRange<IndexT>(_elements.data() + _elementOffset[id], _elements.data() + _elementOffset[id+1]);
+    }
+    /** Return the id of the node which the element is stored */
+    inline IndexT nodeByElement(IndexT element) const { return _cmap[element]; }
+    /** 
+    * Get the global indices of the elements stored in the node identified by id: the indices 
+    * in the whole image for a tree of a region of interest (CTMetaImageROI2D) and the element
+    * indices otherwise. */
+    std::vector<long long> nodeGlobalElementIndices(IndexT id) const;
+    /** 
+    * Return the id of the node which stores the element with global index 'g' (see 
+    * nodeGlobalElementIndices), or -1 if it is not an element of the tree. */
+    IndexT nodeByGlobalElement(long long g) const;
+    /** Return a view of the node with the id passed by the parameter */
+    inline CompactCTNode<T, IndexT> node(IndexT id) const { return CompactCTNode<T, IndexT>(this, id); }
+
+    /** Reconstruct the full component tree node identified by id. */
+    std::vector<IndexT> reconstructNode(IndexT id) const;
+
+    /** Return the meta-information of the tree. */
+    inline std::shared_ptr<CTMeta> meta() const { return _meta; }
+
+    /** Convert the component tree to the array representation. */
+    std::vector<T> convertToVector() const;
+
+    /** Rebuild the component tree from the parent array, the elements set and the indices of
+    *   the elements set ordered (see the constructor), reusing the arrays of this tree. When
+    *   the tree had the same number of elements and nodes at least as many as the new ones,
+    *   no memory is allocated.
+    */
+    void assign(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+      const std::vector<IndexT>& sortedIndices, const std::vector<T>& elements);
+
+    /** Rebuild the component tree whose elements are the pixels of the image view 'elements'. */
+    void assign(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+      const std::vector<IndexT>& sortedIndices, const ImageView2D<T>& elements);
+
+    /** Write the array representation of the component tree into 'out', which has room for
+    *   numberOfElements() values. The elements are written in order, split in 'nthreads' chunks.
+    */
+    void convertTo(T *out, int nthreads = 1) const;
+
+    /** Write the image of the component tree of a 2D image (CTMetaImage2D) into 'out', whose rows
+    *   start 'rowStride' values apart (e.g. a region of a larger image). The rows are split among
+    *   'nthreads' threads. It throws std::invalid_argument if the tree is not of a 2D image.
+    */
+    void convertToRows(T *out, std::ptrdiff_t rowStride, int nthreads = 1) const;
+
+  private:
+    template<class Elements>
+    void createNodes(const std::vector<IndexT>& parent, const std::vector<IndexT>& sortedIndices, 
+      const Elements& elements);
+    void createChildren();
+
+  private:
+    std::vector<IndexT> _parent;
+    std::vector<T> _level;
+    std::vector<IndexT> _childOffset;
+    std::vector<IndexT> _children;
+    std::vector<IndexT> _elementOffset;
+    std::vector<IndexT> _elements;
+    std::vector<IndexT> _cmap;
+    std::shared_ptr<CTMeta> _meta;
+  };
+
+  /* ============================[ ALIASES ]====================================================== */
+  using UCCompactCTree = CompactCTree<unsigned char>;
+  using USCompactCTree = CompactCTree<unsigned short>;
+  using ICompactCTree = CompactCTree<int>;
+  using FCompactCTree = CompactCTree<float>;
+  using DCompactCTree = CompactCTree<double>;
+
+  /* ============================[ IMPLEMENTATION ]=============================================== */
+  template<class T, class IndexT>
+  CompactCTree<T, IndexT>::CompactCTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const std::vector<T>& elements): _meta{pmeta}
+  {
+    createNodes(parent, sortedIndices, elements);
+  }
+
+  template<class T, class IndexT>
+  CompactCTree<T, IndexT>::CompactCTree(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const ImageView2D<T>& elements): _meta{pmeta}
+  {
+    createNodes(parent, sortedIndices, elements);
+  }
+
+  template<class T, class IndexT>
+  void CompactCTree<T, IndexT>::assign(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const std::vector<T>& elements)
+  {
+    _meta = pmeta;
+    createNodes(parent, sortedIndices, elements);
+  }
+
+  template<class T, class IndexT>
+  void CompactCTree<T, IndexT>::assign(std::shared_ptr<CTMeta> pmeta, const std::vector<IndexT>& parent, 
+    const std::vector<IndexT>& sortedIndices, const ImageView2D<T>& elements)
+  {
+    _meta = pmeta;
+    createNodes(parent, sortedIndices, elements);
+  }
+
+  template<class T, class IndexT>
+  CompactCTree<T, IndexT>::CompactCTree(const CTree<T, IndexT> &ct): _meta{ct.meta()}
+  {
+    const size_t nnodes = ct.numberOfNodes();
+    _parent.resize(nnodes);
+    _level.resize(nnodes);
+    _elementOffset.resize(nnodes + 1);
+    _elementOffset[0] = 0;
+    for (size_t i = 0; i < nnodes; ++i) {
+      _parent[i] = ct.nodeParent(i);
+      _level[i] = ct.nodeLevel(i);
+      _elementOffset[i+1] = _elementOffset[i] + ct.nodeElementIndices(i).size();
+    }
+
+    _elements.resize(_elementOffset.back());
+    _cmap.resize(_elementOffset.back());
+    for (size_t i = 0; i < nnodes; ++i) {
+      const auto &elems = ct.nodeElementIndices(i);
+      std::copy(elems.begin(), elems.end(), _elements.begin() + _elementOffset[i]);
+      for (auto e: elems)
+        _cmap[e] = i;
+    }
+    createChildren();
+  }
+
+  template<class T, class IndexT>
+  template<class Elements>
+  void CompactCTree<T, IndexT>::createNodes(const std::vector<IndexT> &parent, const std::vector<IndexT> &sortedIndices,
+    const Elements &elements)
+  {
+    const IndexT UNDEF = -1;
+    const IndexT n = elements.size();
+    _cmap.assign(n, UNDEF);
+
+    auto isLevelRoot = [&parent, &elements](IndexT p) { 
+      return elements[parent[p]] != elements[p] || parent[p] == p; 
+    };
+
+    // The level roots in sorted order are the nodes, so the parent of a node comes before it.
+    // The levels are only compared once per element: then the level roots are the elements
+    // already mapped to a node.
+    IndexT nnodes = 0;
+    for (auto p : sortedIndices) {
+      if (isLevelRoot(p)) _cmap[p] = nnodes++;
+    }
+
+    _parent.resize(nnodes);
+    _level.resize(nnodes);
+    _elementOffset.assign(nnodes + 1, 0);
+    for (auto p : sortedIndices) {
+      auto id = _cmap[p];
+      if (id != UNDEF) {
+        _parent[id] = id == 0 ? UNDEF : _cmap[parent[p]];
+        _level[id] = elements[p];
+      }
+    }
+
+    // The elements are stored by node: the level root first and the other ones in 
+    // increasing order.
+    for (IndexT p = 0; p < n; ++p) {
+      if (_cmap[p] == UNDEF)
+        _cmap[p] = _cmap[parent[p]];
+      _elementOffset[_cmap[p] + 1]++;
+    }
+    for (IndexT i = 0; i < nnodes; ++i)
+      _elementOffset[i+1] += _elementOffset[i];
+
+    // _elementOffset[i] is used as the next position of the node i, so it ends up at the offset
+    // of the node i+1 and it is shifted back (no extra array is allocated). A level root is in 
+    // another node than its parent (or is the root).
+    auto isNodeRoot = [this, &parent](IndexT p) { return parent[p] == p || _cmap[parent[p]] != _cmap[p]; };
+    _elements.resize(n);
+    for (IndexT p = 0; p < n; ++p) {
+      if (isNodeRoot(p))
+        _elements[_elementOffset[_cmap[p]]++] = p;
+    }
+    for (IndexT p = 0; p < n; ++p) {
+      if (!isNodeRoot(p))
+        _elements[_elementOffset[_cmap[p]]++] = p;
+    }
+    for (IndexT i = nnodes; i > 0; --i)
+      _elementOffset[i] = _elementOffset[i-1];
+    _elementOffset[0] = 0;
+
+    createChildren();
+  }
+
+  template<class T, class IndexT>
+  void CompactCTree<T, IndexT>::createChildren()
+  {
+    const size_t nnodes = _parent.size();
+    _childOffset.assign(nnodes + 1, 0);
+    for (size_t i = 1; i < nnodes; ++i)
+      _childOffset[_parent[i] + 1]++;
+    for (size_t i = 0; i < nnodes; ++i)
+      _childOffset[i+1] += _childOffset[i];
+
+    // As the element offsets, _childOffset[i] is the next position of the node i until it is
+    // shifted back.
+    _children.resize(nnodes > 0 ? nnodes - 1 : 0);
+    for (size_t i = 1; i < nnodes; ++i)
+      _children[_childOffset[_parent[i]]++] = i;
+    for (size_t i = nnodes; i > 0; --i)
+      _childOffset[i] = _childOffset[i-1];
+    _childOffset[0] = 0;
+  }
+
+  template<class T, class IndexT>
+  template<typename F>
+  void CompactCTree<T, IndexT>::transverse(F visit) const
+  {
+    for (IndexT i = static_cast<IndexT>(_parent.size()) - 1; i >= 0; --i)
+      visit(CompactCTNode<T, IndexT>(this, i));
+  }
+
+  template<class T, class IndexT>
+  std::vector<IndexT> CompactCTree<T, IndexT>::reconstructNode(IndexT id) const
+  {
+    // The nodes of the subtree of 'id' are visited in depth-first order using a stack.
+    std::vector<IndexT> rec;
+    std::vector<IndexT> stack{id};
+    while (!stack.empty()) {
+      auto n = stack.back();
+      stack.pop_back();
+      auto elems = nodeElementIndices(n);
+      rec.insert(rec.end(), elems.begin(), elems.end());
+      auto children = nodeChildren(n);
+      for (auto c = children.end(); c != children.begin(); )
+        stack.push_back(*--c);
+    }
+    return rec;
+  }
+
+  template<class T, class IndexT>
+  std::vector<long long> CompactCTree<T, IndexT>::nodeGlobalElementIndices(IndexT id) const
+  {
+    const auto &elems = nodeElementIndices(id);
+    std::vector<long long> global(elems.begin(), elems.end());
+    if (auto roi = dynamic_cast<const CTMetaImageROI2D*>(_meta.get())) {
+      for (auto &p : global)
+        p = roi->globalIndex(p);
+    }
+    return global;
+  }
+
+  template<class T, class IndexT>
+  IndexT CompactCTree<T, IndexT>::nodeByGlobalElement(long long g) const
+  {
+    auto roi = dynamic_cast<const CTMetaImageROI2D*>(_meta.get());
+    auto p = roi ? roi->localIndex(g) : g;
+    return (p < 0 || p >= static_cast<long long>(_cmap.size())) ? IndexT(-1) : _cmap[p];
+  }
+
+  template<class T, class IndexT>
+  std::vector<T> CompactCTree<T, IndexT>::convertToVector() const
+  {
+    std::vector<T> v(_cmap.size());
+    convertTo(v.data());
+    return v;
+  }
+
+  template<class T, class IndexT>
+  void CompactCTree<T, IndexT>::convertTo(T *out, int nthreads) const
+  {
+    writeNodeLevels(_cmap.size(), [this](size_t p) { return _cmap[p]; },
+      [this](IndexT id) { return _level[id]; }, out, nthreads);
+  }
+
+  template<class T, class IndexT>
+  void CompactCTree<T, IndexT>::convertToRows(T *out, std::ptrdiff_t rowStride, int nthreads) const
+  {
+    auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(_meta);
+    if (!meta || static_cast<size_t>(meta->width()) * meta->height() != _cmap.size())
+      throw std::invalid_argument("the component tree is not of a 2D image");
+    writeNodeLevels(meta->width(), meta->height(), [this](size_t p) { return _cmap[p]; },
+      [this](IndexT id) { return _level[id]; }, out, rowStride, nthreads);
+  }
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#ifndef IMAGE_VIEW_HPP_INCLUDED
+#define IMAGE_VIEW_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+   * Read-only view of a 2D image stored in external memory (e.g. a camera buffer or a matrix
+   * with padded rows): the pixel (x, y) is data[y * rowStride + x], where the row stride is
+   * given in elements (not bytes) and is at least the width. The view does not copy nor own
+   * the pixels, which must outlive it.
+   *
+   * The view is a sequence of width * height values indexed as a tight image (the element
+   * i = y * width + x is the pixel (x, y)), so it can be used instead of a std::vector by the
+   * component tree builder and the sorts. The element indices of a tree built from a view
+   * are the tight indices, whatever the row stride. The row of an element of a view with padded
+   * rows is computed by a multiplication and a shift (instead of a division), and the 
+   * sequential passes of the builder and the sorts read the pixels row by row (forEachElement). */
+  template<typename T>
+  class ImageView2D
+  {
+  public:
+    using value_type = T; /**< Type of the pixel values. */
+
+    /** Construct a view of a tight image (row stride equal to the width). */
+    ImageView2D(const T *data, int width, int height);
+
+    /**
+     * Construct a view of an image whose rows start every 'rowStride' elements. It throws
+     * std::invalid_argument if 'rowStride' is smaller than the width. */
+    ImageView2D(const T *data, int width, int height, std::ptrdiff_t rowStride);
+
+    inline int width() const { return _width; }  /**< Image width. */
+    inline int height() const { return _height; } /**< Image height. */
+    inline std::ptrdiff_t rowStride() const { return _rowStride; } /**< Row stride (in elements). */
+    inline const T* data() const { return _data; } /**< Pointer to the first pixel. */
+
+    /** Get the number of pixels (width * height). */
+    inline std::size_t size() const { return static_cast<std::size_t>(_width) * _height; }
+
+    /** Check whether the rows are stored without padding. */
+    inline bool isContiguous() const { return _rowStride == _width; }
+
+    /** Get a pointer to the first pixel of the row 'y'. */
+    inline const T* row(int y) const { return _data + y * _rowStride; }
+
+    /** Get the value of the pixel (x, y). */
+    inline const T& operator()(int x, int y) const { return _data[y * _rowStride + x]; }
+
+    /**
+     * Get a view of the region of interest of size width x height whose top-left pixel is (x, y),
+     * which shares the pixels (and the row stride) of this view. It throws std::invalid_argument
+     * if the region is not inside the image. */
+    ImageView2D<T> roi(int x, int y, int width, int height) const;
+
+    /** Get the value of the element 'i' (the pixel (i % width, i / width)). */
+    inline const T& operator[](std::size_t i) const { return _data[offset(i)]; }
+
+    /** Get the position of the element 'i' from data(). */
+    inline std::ptrdiff_t offset(std::size_t i) const
+    {
+      if (isContiguous())
+        return static_cast<std::ptrdiff_t>(i);
+      // i / width is (i * _rowMultiplier) >> _rowShift for i < 2^31 (see the constructor).
+      if (i < (std::size_t(1) << 31)) {
+        auto y = static_cast<std::ptrdiff_t>((static_cast<std::uint64_t>(i) * _rowMultiplier) >> _rowShift);
+        return y * _rowStride + (static_cast<std::ptrdiff_t>(i) - y * _width);
+      }
+      return static_cast<std::ptrdiff_t>(i / _width) * _rowStride + static_cast<std::ptrdiff_t>(i % _width);
+    }
+
+  private:
+    const T *_data;
+    int _width;
+    int _height;
+    std::ptrdiff_t _rowStride;
+    std::uint64_t _rowMultiplier;
+    int _rowShift;
+
+    void initRowDivision();
+  };
+
+  /**
+   * Call f(i, v[i]) for the elements i in [begin, end) of the image view 'v' in increasing 
+   * order, reading the pixels row by row (one division per call instead of one per pixel). */
+  template<typename T, typename F>
+  void forEachElement(const ImageView2D<T> &v, std::size_t begin, std::size_t end, F f);
+
+  /* =================== [ IMPLEMENTATION ] ===================================== */
+  template<typename T>
+  ImageView2D<T>::ImageView2D(const T *data, int width, int height)
+    : _data{data}, _width{width}, _height{height}, _rowStride{width}
+  {
+    initRowDivision();
+  }
+
+  template<typename T>
+  ImageView2D<T>::ImageView2D(const T *data, int width, int height, std::ptrdiff_t rowStride)
+    : _data{data}, _width{width}, _height{height}, _rowStride{rowStride}
+  {
+    if (rowStride < width)
+      throw std::invalid_argument("the row stride of an image view must be at least its width");
+    initRowDivision();
+  }
+
+  template<typename T>
+  void ImageView2D<T>::initRowDivision()
+  {
+    // With 2^(l-1) < width <= 2^l, shift = 31 + l and multiplier = ceil(2^shift / width) <= 2^32,
+    // (i * multiplier) >> shift is i / width for every i < 2^31 (the rounding error of the 
+    // multiplier adds less than 2^-l <= 1 / width to i / width) and i * multiplier < 2^63.
+    int l = 0;
+    while (l < 31 && (std::int64_t(1) << l) < _width)
+      l++;
+    _rowShift = 31 + l;
+    const std::uint64_t w = _width > 0 ? static_cast<std::uint64_t>(_width) : 1;
+    _rowMultiplier = ((std::uint64_t(1) << _rowShift) + w - 1) / w;
+  }
+
+  template<typename T>
+  ImageView2D<T> ImageView2D<T>::roi(int x, int y, int width, int height) const
+  {
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x + width > _width || y + height > _height)
+      throw std::invalid_argument("the region of interest must be inside the image");
+    return ImageView2D<T>(_data + y * _rowStride + x, width, height, _rowStride);
+  }
+
+  template<typename T, typename F>
+  void forEachElement(const ImageView2D<T> &v, std::size_t begin, std::size_t end, F f)
+  {
+    if (begin >= end)
+      return;
+    const std::size_t width = static_cast<std::size_t>(v.width());
+    std::size_t y = begin / width, x = begin - y * width;
+    for (std::size_t i = begin; i < end; y++, x = 0) {
+      const T *row = v.data() + static_cast<std::ptrdiff_t>(y) * v.rowStride();
+      const std::size_t rowEnd = i + (width - x) < end ? i + (width - x) : end;
+      for (; i < rowEnd; i++, x++)
+        f(i, row[x]);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <cstddef>
+
+#ifndef PARALLEL_HPP_INCLUDED
+#define PARALLEL_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /* =================== [INTERFACE ] ======================================== */
+
+  /**
+   * Function which returns the number of concurrent threads supported by the
+   * hardware (at least 1). */
+  int hardwareThreads();
+
+  /**
+   * Function which splits the range [0, size) in 'nchunks' contiguous chunks with
+   * (almost) the same size. It returns the 'nchunks + 1' chunk boundaries, such that,
+   * the chunk 'i' is [boundaries[i], boundaries[i+1]). IndexT is the integer type of 
+   * the indices (e.g. int or long long). */
+  template<typename IndexT>
+  std::vector<IndexT> splitRange(IndexT size, int nchunks);
+
+  /**
+   * Pool of worker threads which run the tasks of parallelFor. The workers are created the 
+   * first time they are needed and reused by the next calls, so an algorithm run once per 
+   * frame does not create and join threads for each frame. The thread which calls run() 
+   * also runs tasks and only waits for the tasks already started by the workers, so a task
+   * can call run() again (nested parallelism) without deadlocking the pool. */
+  class ThreadPool
+  {
+  public:
+    /** Construct a pool with 'nworkers' worker threads. */
+    explicit ThreadPool(int nworkers = 0);
+
+    /** Wait for the workers to finish their current task and join them. */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool& operator=(const ThreadPool &other) = delete;
+
+    /** Get the number of worker threads. */
+    int numberOfWorkers();
+
+    /** Create worker threads until the pool has at least 'nworkers' of them. */
+    void reserve(int nworkers);
+
+    /**
+     * Call 'task(t)' for each t in [0, ntasks) using the calling thread and the workers 
+     * which are idle. It returns when all tasks have finished and rethrows the exception 
+     * thrown by the task with the lowest t, if any. */
+    void run(int ntasks, const std::function<void(int)> &task);
+
+    /** Get the pool shared by the parallel algorithms of the library. */
+    static ThreadPool& shared();
+
+  private:
+    struct Job;
+
+    void work();
+    static void runTasks(Job &job);
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::deque<std::shared_ptr<Job>> _jobs;
+    std::vector<std::thread> _workers;
+    bool _stop;
+  };
+
+  /**
+   * Function which calls 'task(t)' for each t in [0, ntasks) using the shared ThreadPool
+   * (see ThreadPool::run): the tasks run concurrently on the calling thread and the idle
+   * workers, with no guarantee about which thread runs which task nor in which order. The 
+   * pool grows to 'ntasks - 1' workers and keeps them for the next calls. It returns when all
+   * tasks have finished and rethrows the exception thrown by the task with the lowest t, if any. */
+  template<typename F>
+  void parallelFor(int ntasks, F task);
+
+  /* =================== [ IMPLEMENTATION ] ===================================== */
+  template<typename IndexT>
+  std::vector<IndexT> splitRange(IndexT size, int nchunks)
+  {
+    if (nchunks < 1) nchunks = 1;
+    std::vector<IndexT> boundaries(nchunks + 1);
+    for (int i = 0; i <= nchunks; ++i)
+      boundaries[i] = static_cast<IndexT>((static_cast<long long>(size) * i) / nchunks);
+    return boundaries;
+  }
+
+  template<typename F>
+  void parallelFor(int ntasks, F task)
+  {
+    if (ntasks <= 1) {
+      if (ntasks == 1)
+        task(0);
+      return;
+    }
+
+    auto &pool = ThreadPool::shared();
+    pool.reserve(ntasks - 1);
+    pool.run(ntasks, [&task](int t) { task(t); });
+  }
+}
+
+#endif
@@ -114,5 +114,61 @@ namespace pomar
     */
     int index(int px, int py) const;
   };
+
+  /**
+  * Base class to classes which provide indexing voxels support (3D images). The voxel 
+  * (x, y, z) has index (z * height + y) * width + x.
+  */
+  class VoxelIndexer
+  {
+  public:
+    VoxelIndexer() = delete;
+    /** Constructor which takes the volume width, height and depth. */
+    VoxelIndexer(int pwidth, int pheight, int pdepth);
+
+    /** Interface to methods which take x, y and z coordinates and transform them in theirs index. */
+    virtual int index(int px, int py, int pz) const = 0;
+    /** Interface to methods which take a 3D point and transform it in its index. */
+    virtual inline int index(const IPoint3D &p) const { return index(p.x(), p.y(), p.z()); }
+    /** Transform a valid index into a Point3D. */
+    virtual IPoint3D voxel(int p) const;
+
+    virtual ~VoxelIndexer() {}
+
+  protected:
+    int _width; /*< Volume's width. */
+    int _height; /*< Volume's height. */
+    int _depth; /*< Volume's depth. */
+  };
+
+  /** Class which takes the nearest border voxel for out of bounds voxels. */
+  class VoxelIndexerNearestBorder : public virtual VoxelIndexer
+  {
+  public:
+    VoxelIndexerNearestBorder() = delete;
+    /** Constructor. */
+    VoxelIndexerNearestBorder(int pwidth, int pheight, int pdepth);
+
+    /** Transform point (px, py, pz) into an index using the nearest border voxel 
+    *   for out of bounds voxels.
+    */
+    int index(int px, int py, int pz) const;
+  };
+
+  /** Class which returns a default value (provided by the user) for out of bounds voxels. */
+  class VoxelIndexerDefaultValue : public virtual VoxelIndexer
+  {
+  public:
+    VoxelIndexerDefaultValue() = delete;
+    /** Constructor which needs width, height, depth and a default value (default=-1). */
+    VoxelIndexerDefaultValue(int pwidth, int pheight, int pdepth, int pdefaultValue = -1);
+
+    /** Transform point (px, py, pz) into an index using a default value for out of 
+     * bounds voxels.
+    */
+    int index(int px, int py, int pz) const;
+  private:
+    int _defaultValue;
+  };
 }
 #endif
\ No newline at end of file
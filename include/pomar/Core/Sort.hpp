@@ -4,6 +4,11 @@
 #include <limits>
 #include <type_traits>
 #include <functional>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#include <pomar/Core/Parallel.hpp>
 
 #ifndef SORT_HPP_INCLUDED
 #define SORT_HPP_INCLUDED
@@ -13,6 +18,9 @@
 namespace pomar
 {
     /* =================== [INTERFACE ] ======================================== */
+
+    /* The index sorts return indices of the type IndexT (int by default), a signed integer
+       type wide enough to index 'v' (e.g. long long for images of more than 2^31 pixels). */
     
     /**
      * Function which returns 'true' if the type T is unsigned char, unsigned short,
@@ -22,22 +30,247 @@ namespace pomar
 
     /**
      * Function which returns the indices of a vector 'v' sorted by the 
-     * function 'cmp' using the STL sorting algorithm.   */
-    template<typename T>
-    std::vector<int> STLsortIndex(const std::vector<T> &v, 
+     * function 'cmp' using the STL (stable) sorting algorithm.   */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> STLsortIndex(const std::vector<T> &v, 
       std::function<bool(const T&, const T&)> cmp);
 
     /**
      * Function which returns the indices of a vector 'v' sorted in the
      * increasing order using counting sort. */
-    template<typename T>
-    std::vector<int> incresingCountingSortIndex(const std::vector<T> &v);
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> incresingCountingSortIndex(const std::vector<T> &v);
 
     /**
      * Function which returns the indices of a vector 'v' sorted in the
      * decreasing order using decreasing sort. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingCountingSortIndex(const std::vector<T> &v);                     
+
+    /**
+     * Call f(i, v[i]) for the elements i in [begin, end) of a sequence 'v' in increasing order.
+     * The sorts read their values through it, and ImageView2D overloads it to read its pixels
+     * row by row. */
+    template<typename V, typename F>
+    void forEachElement(const V &v, std::size_t begin, std::size_t end, F f);
+
+    /**
+     * Stable counting pass over the elements of the sequence 'values' split in 'nthreads' 
+     * contiguous chunks: each thread counts the bucket 'bucket(values[i])' (in [0, nbuckets)) 
+     * of its elements, the counters are prefix-summed by bucket and then by thread, and each 
+     * thread calls 'scatter(i, pos)' for its elements in order, where 'pos' is the final 
+     * position of i. The counters of all threads are stored in the scratch array 'counter' 
+     * (resized to nthreads * nbuckets). */
+    template<typename IndexT, typename V, typename Bucket, typename Scatter>
+    void parallelCountingPass(const V &values, int nbuckets, int nthreads, std::vector<IndexT> &counter,
+      Bucket bucket, Scatter scatter);
+
+    /**
+     * Number of threads used by the parallel sorts for 'n' elements: each thread gets at 
+     * least 'MinElementsPerSortThread' elements. */
+    const int MinElementsPerSortThread = 1 << 16;
+    int sortThreads(std::size_t n, int nthreads);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the
+     * increasing order using a counting sort with 'nthreads' threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> incresingCountingSortIndex(const std::vector<T> &v, int nthreads);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the
+     * decreasing order using a counting sort with 'nthreads' threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingCountingSortIndex(const std::vector<T> &v, int nthreads);
+
+    /** Unsigned integer type with 'N' bytes. */
+    template<std::size_t N> struct UnsignedOfSize;
+    template<> struct UnsignedOfSize<1> { using type = std::uint8_t; };
+    template<> struct UnsignedOfSize<2> { using type = std::uint16_t; };
+    template<> struct UnsignedOfSize<4> { using type = std::uint32_t; };
+    template<> struct UnsignedOfSize<8> { using type = std::uint64_t; };
+
+    /**
+     * Transformation of a value of type T into an unsigned integer key, such that, the 
+     * order of the keys is the order of the values. It is defined for integer types, 
+     * float and double (-0.0 and 0.0 have the same key). */
+    template<typename T, typename Enable = void>
+    struct RadixKey;
+
+    /** Trait which is true if the type T has a RadixKey, that is, it can be radix sorted. */
+    template<typename T>
+    struct hasRadixKey : std::integral_constant<bool, std::is_integral<T>::value || 
+      std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the increasing
+     * (or decreasing if 'decreasing' is true) order using a stable LSD radix sort of 
+     * one byte per pass. Passes in which all keys have the same byte are skipped. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> radixSortIndex(const std::vector<T> &v, bool decreasing);
+
+    /** 
+     * Same as radixSortIndex(v, decreasing) using 'nthreads' threads for each pass. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> radixSortIndex(const std::vector<T> &v, bool decreasing, int nthreads);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the increasing
+     * order using radix sort. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> increasingRadixSortIndex(const std::vector<T> &v);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the decreasing
+     * order using radix sort. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingRadixSortIndex(const std::vector<T> &v);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the increasing
+     * order using radix sort with 'nthreads' threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> increasingRadixSortIndex(const std::vector<T> &v, int nthreads);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the decreasing
+     * order using radix sort with 'nthreads' threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingRadixSortIndex(const std::vector<T> &v, int nthreads);
+
+    /** Type of the radix keys of T (unsigned char for the types which have no RadixKey). */
+    template<typename T, bool = hasRadixKey<T>::value>
+    struct RadixKeyTypeOf { using type = typename RadixKey<T>::type; };
+    template<typename T>
+    struct RadixKeyTypeOf<T, false> { using type = unsigned char; };
+
+    /** 
+     * Scratch arrays of the sorts which write their result into a given vector (e.g. 
+     * sortIndexInto). They keep their capacity between calls, so sorting vectors of the same
+     * size again does not allocate memory. */
+    template<typename T, typename IndexT = int>
+    struct SortBuffers
+    {
+      std::vector<IndexT> counter;
+      std::vector<IndexT> tmpIdx;
+      std::vector<typename RadixKeyTypeOf<T>::type> keys;
+      std::vector<typename RadixKeyTypeOf<T>::type> tmpKeys;
+    };
+
+    /* The sorts which write into a given vector accept any sequence 'v' of values with 
+       v.size(), v[i] and value_type (e.g. std::vector or ImageView2D). */
+
+    /**
+     * Write into 'idx' the indices of a sequence 'v' sorted in the increasing (or decreasing if
+     * 'decreasing' is true) order using a counting sort, with the scratch array 'counter'. */
+    template<typename V, typename IndexT>
+    void countingSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      std::vector<IndexT> &counter);
+
+    /**
+     * Write into 'idx' the indices of a sequence 'v' sorted in the increasing (or decreasing if
+     * 'decreasing' is true) order using radix sort, with the scratch arrays of 'buffers'. */
+    template<typename V, typename T, typename IndexT>
+    void radixSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      SortBuffers<T, IndexT> &buffers);
+
+    /** 
+     * Same as countingSortIndexInto(v, decreasing, idx, counter) using 'nthreads' threads, whose
+     * histograms are stored in 'counter' (nthreads times the size of the sequential one). */
+    template<typename V, typename IndexT>
+    void countingSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      std::vector<IndexT> &counter, int nthreads);
+
+    /** Same as radixSortIndexInto(v, decreasing, idx, buffers) using 'nthreads' threads for each pass. */
+    template<typename V, typename T, typename IndexT>
+    void radixSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      SortBuffers<T, IndexT> &buffers, int nthreads);
+
+    /** Tags which identify the sorting algorithm used by increasingSortIndex and decreasingSortIndex. */
+    struct CountingSortTag {};
+    struct RadixSortTag {};
+    struct ComparisonSortTag {};
+
+    /**
+     * Sorting algorithm chosen at compile time for the type T: counting sort for unsigned
+     * types of up to two bytes (and bool), whose single pass beats the two radix passes,
+     * radix sort for the others types with RadixKey and STL sort for the remaining types. */
+    template<typename T>
+    struct SortStrategy
+    {
+      using type = typename std::conditional<
+        std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) <= 2, CountingSortTag,
+        typename std::conditional<hasRadixKey<T>::value, RadixSortTag, ComparisonSortTag>::type>::type;
+    };
+
+    /** Tag which selects the sorting algorithm SortStrategy<T> of the sorted type T. */
+    struct DefaultSortTag {};
+
+    /**
+     * Sorting algorithm identified by the tag 'Tag' for the type T (SortStrategy<T> for 
+     * DefaultSortTag). It does not compile when the algorithm cannot sort T: counting sort 
+     * needs an unsigned integer type of up to two bytes and radix sort needs a RadixKey. */
+    template<typename Tag, typename T>
+    struct SortAlgorithm
+    {
+      static_assert(!std::is_same<Tag, CountingSortTag>::value || (std::is_integral<T>::value && 
+        std::is_unsigned<T>::value && sizeof(T) <= 2), "counting sort needs an unsigned type of up to 16 bits");
+      static_assert(!std::is_same<Tag, RadixSortTag>::value || hasRadixKey<T>::value, 
+        "radix sort needs a type with RadixKey");
+      using type = Tag;
+    };
+
     template<typename T>
-    std::vector<int> decreasingCountingSortIndex(const std::vector<T> &v);                     
+    struct SortAlgorithm<DefaultSortTag, T> { using type = typename SortStrategy<T>::type; };
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the increasing order
+     * (ties in the increasing order of index) using the algorithm SortStrategy<T>. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v);
+
+    /**
+     * Function which returns the indices of a vector 'v' sorted in the decreasing order
+     * (ties in the increasing order of index) using the algorithm SortStrategy<T>. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v);
+
+    /**
+     * Same as increasingSortIndex(v) using 'nthreads' threads when SortStrategy<T> is
+     * counting or radix sort (the comparison sort is sequential). The result does not 
+     * depend on the number of threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, int nthreads);
+
+    /**
+     * Same as decreasingSortIndex(v) using 'nthreads' threads when SortStrategy<T> is
+     * counting or radix sort (the comparison sort is sequential). The result does not
+     * depend on the number of threads. */
+    template<typename T, typename IndexT = int>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, int nthreads);
+
+    /**
+     * Write into 'idx' the indices of a sequence 'v' of values of type T in the order of 
+     * increasingSortIndex(v) (or decreasingSortIndex(v) if 'decreasing' is true) using the 
+     * scratch arrays of 'buffers'. When 'idx' and 'buffers' were used to sort a sequence of the
+     * same size before, the counting and radix sorts do not allocate memory (the comparison 
+     * sort may). */
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers);
+
+    /** Same as sortIndexInto(v, decreasing, idx, buffers) using the sorting algorithm 'Tag'. */
+    template<typename V, typename T, typename IndexT, typename Tag>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, Tag);
+
+    /** 
+     * Same as sortIndexInto(v, decreasing, idx, buffers, Tag) using 'nthreads' threads for the 
+     * counting and radix sorts (the comparison sort is sequential). The result does not depend 
+     * on the number of threads. */
+    template<typename V, typename T, typename IndexT, typename Tag>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, int nthreads, Tag);
 
     /* =================== [ IMPLEMENTATION ] ===================================== */
     template<typename T>
@@ -49,57 +282,473 @@ namespace pomar
         || std::is_same<T, bool>::value;
     }
 
-    template<typename T>
-    std::vector<int> STLsortIndex(const std::vector<T> &v, 
+    template<typename T, typename IndexT>
+    std::vector<IndexT> STLsortIndex(const std::vector<T> &v, 
       std::function<bool(const T&, const T&)> cmp)
     {
-      std::vector<int> idx(v.size());
+      std::vector<IndexT> idx(v.size());
       std::iota(idx.begin(), idx.end(), 0);
-      std::sort(idx.begin(), idx.end(), [&v, cmp](int i1, int i2) { 
+      std::stable_sort(idx.begin(), idx.end(), [&v, cmp](IndexT i1, IndexT i2) { 
         return cmp(v[i1], v[i2]);
       });
       return idx;
     }
 
-    template<typename T>
-    std::vector<int> incresingCountingSortIndex(const std::vector<T> &v)
+    template<typename T, typename IndexT>
+    std::vector<IndexT> incresingCountingSortIndex(const std::vector<T> &v)
     {
-      T maxValue = std::numeric_limits<T>::max();
-      std::vector<int> counter(maxValue+1, 0);
-      std::vector<int> idx(v.size());      
+      std::vector<IndexT> idx, counter;
+      countingSortIndexInto(v, false, idx, counter);
+      return idx;
+    }
 
-      for (size_t i = 0; i < v.size(); i++)
-        counter[v[i]]++;      
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingCountingSortIndex(const std::vector<T> &v)
+    {
+      std::vector<IndexT> idx, counter;
+      countingSortIndexInto(v, true, idx, counter);
+      return idx;
+    }
+
+    template<typename V, typename IndexT>
+    void countingSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      std::vector<IndexT> &counter)
+    {
+      using T = typename V::value_type;
+      static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) <= 2,
+        "counting sort needs an unsigned type of up to 16 bits");
+      // The buckets of the decreasing order are the values counted from the maximum value.
+      const T maxValue = std::numeric_limits<T>::max();
+      auto bucket = [maxValue, decreasing](T value) { return decreasing ? maxValue - value : value; };
+      counter.assign(static_cast<std::size_t>(maxValue) + 1, 0);
+      idx.resize(v.size());
 
-      for (T i = 1; i < maxValue; i++)
-        counter[i] += counter[i-1];
-      counter[maxValue] += counter[maxValue-1];
-           
-      for (int i = v.size()-1; i >= 0; --i)
-        idx[--counter[v[i]]] = i;
+      forEachElement(v, 0, v.size(), [&](std::size_t, T value) { counter[bucket(value)]++; });
+
+      // Each bucket starts at the count of the lower ones and is filled in increasing index order.
+      IndexT offset = 0;
+      for (auto &c : counter) {
+        auto count = c;
+        c = offset;
+        offset += count;
+      }
+
+      forEachElement(v, 0, v.size(), [&](std::size_t i, T value) { 
+        idx[counter[bucket(value)]++] = static_cast<IndexT>(i); 
+      });
+    }
+
+    template<typename V, typename IndexT>
+    void countingSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      std::vector<IndexT> &counter, int nthreads)
+    {
+      using T = typename V::value_type;
+      static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) <= 2,
+        "counting sort needs an unsigned type of up to 16 bits");
+      nthreads = sortThreads(v.size(), nthreads);
+      if (nthreads == 1) {
+        countingSortIndexInto(v, decreasing, idx, counter);
+        return;
+      }
 
+      const int maxValue = static_cast<int>(std::numeric_limits<T>::max());
+      idx.resize(v.size());
+      parallelCountingPass<IndexT>(v, maxValue + 1, nthreads, counter,
+        [maxValue, decreasing](T value) { return decreasing ? maxValue - static_cast<int>(value) : static_cast<int>(value); },
+        [&idx](IndexT i, IndexT pos) { idx[pos] = i; });
+    }
+
+    template<typename V, typename F>
+    void forEachElement(const V &v, std::size_t begin, std::size_t end, F f)
+    {
+      for (std::size_t i = begin; i < end; i++)
+        f(i, v[i]);
+    }
+
+    template<typename IndexT, typename V, typename Bucket, typename Scatter>
+    void parallelCountingPass(const V &values, int nbuckets, int nthreads, std::vector<IndexT> &counter,
+      Bucket bucket, Scatter scatter)
+    {
+      using T = typename V::value_type;
+      auto chunks = splitRange(values.size(), nthreads);
+      counter.assign(static_cast<std::size_t>(nthreads) * nbuckets, 0);
+
+      parallelFor(nthreads, [&](int t) {
+        auto tcounter = counter.data() + static_cast<std::size_t>(t) * nbuckets;
+        forEachElement(values, chunks[t], chunks[t+1], [&](std::size_t, T value) { tcounter[bucket(value)]++; });
+      });
+
+      IndexT offset = 0;
+      for (int d = 0; d < nbuckets; d++) {
+        for (int t = 0; t < nthreads; t++) {
+          auto &c = counter[static_cast<std::size_t>(t) * nbuckets + d];
+          auto count = c;
+          c = offset;
+          offset += count;
+        }
+      }
+
+      parallelFor(nthreads, [&](int t) {
+        auto tcounter = counter.data() + static_cast<std::size_t>(t) * nbuckets;
+        forEachElement(values, chunks[t], chunks[t+1], [&](std::size_t i, T value) { 
+          scatter(static_cast<IndexT>(i), tcounter[bucket(value)]++); 
+        });
+      });
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> incresingCountingSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      std::vector<IndexT> idx, counter;
+      countingSortIndexInto(v, false, idx, counter, nthreads);
+      return idx;
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingCountingSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      std::vector<IndexT> idx, counter;
+      countingSortIndexInto(v, true, idx, counter, nthreads);
       return idx;
     }
 
     template<typename T>
-    std::vector<int> decreasingCountingSortIndex(const std::vector<T> &v)
+    struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value>::type>
+    {
+      using type = typename UnsignedOfSize<sizeof(T)>::type;
+
+      static inline type key(T value)
+      {
+        auto k = static_cast<type>(value);
+        if (std::is_signed<T>::value)
+          k ^= static_cast<type>(type(1) << (8*sizeof(T) - 1));
+        return k;
+      }
+    };
+
+    template<typename T>
+    struct RadixKey<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+      using type = typename UnsignedOfSize<sizeof(T)>::type;
+
+      static inline type key(T value)
+      {
+        if (value == T(0)) value = T(0);
+        type k;
+        std::memcpy(&k, &value, sizeof(T));
+        const type sign = type(1) << (8*sizeof(T) - 1);
+        return (k & sign) ? static_cast<type>(~k) : static_cast<type>(k | sign);
+      }
+    };
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> radixSortIndex(const std::vector<T> &v, bool decreasing)
+    {
+      std::vector<IndexT> idx;
+      SortBuffers<T, IndexT> buffers;
+      radixSortIndexInto(v, decreasing, idx, buffers);
+      return idx;
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void radixSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      SortBuffers<T, IndexT> &buffers)
     {
-      T maxValue = std::numeric_limits<T>::max();
-      std::vector<int> counter(maxValue + 1, 0);
-      std::vector<int> idx(v.size());
+      static_assert(std::is_same<typename V::value_type, T>::value, "the buffers must have the type of the values");
+      using Key = typename RadixKey<T>::type;
+      const int NBUCKETS = 256;
+      const int nbytes = sizeof(Key);
+      const size_t n = v.size();
 
-      for (size_t i = 0; i < v.size(); i++)
-        counter[maxValue - v[i]]++;
+      auto &keys = buffers.keys, &tmpKeys = buffers.tmpKeys;
+      auto &tmpIdx = buffers.tmpIdx, &counter = buffers.counter;
+      keys.resize(n); tmpKeys.resize(n);
+      idx.resize(n); tmpIdx.resize(n);
+      counter.assign(nbytes * NBUCKETS, 0);
 
-      for (T i = 1; i < maxValue; i++)
-        counter[i] += counter[i - 1];
-      counter[maxValue] += counter[maxValue - 1];
+      forEachElement(v, 0, n, [&](std::size_t i, T value) {
+        auto k = RadixKey<T>::key(value);
+        if (decreasing) k = static_cast<Key>(~k);
+        keys[i] = k;
+        idx[i] = i;
+        for (int b = 0; b < nbytes; b++)
+          counter[b*NBUCKETS + ((k >> (8*b)) & 0xFF)]++;
+      });
 
-      for (int i = v.size() - 1; i >= 0; --i)
-        idx[--counter[maxValue - v[i]]] = i;
+      for (int b = 0; b < nbytes && n > 0; b++) {
+        auto bcounter = counter.data() + b*NBUCKETS;
+        if (static_cast<size_t>(bcounter[(keys[0] >> (8*b)) & 0xFF]) == n)
+          continue;
+
+        IndexT offset = 0;
+        for (int d = 0; d < NBUCKETS; d++) {
+          auto c = bcounter[d];
+          bcounter[d] = offset;
+          offset += c;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+          auto pos = bcounter[(keys[i] >> (8*b)) & 0xFF]++;
+          tmpKeys[pos] = keys[i];
+          tmpIdx[pos] = idx[i];
+        }
+        keys.swap(tmpKeys);
+        idx.swap(tmpIdx);
+      }
+    }
 
+    template<typename T, typename IndexT>
+    std::vector<IndexT> radixSortIndex(const std::vector<T> &v, bool decreasing, int nthreads)
+    {
+      std::vector<IndexT> idx;
+      SortBuffers<T, IndexT> buffers;
+      radixSortIndexInto(v, decreasing, idx, buffers, nthreads);
       return idx;
     }
+
+    template<typename V, typename T, typename IndexT>
+    void radixSortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx,
+      SortBuffers<T, IndexT> &buffers, int nthreads)
+    {
+      static_assert(std::is_same<typename V::value_type, T>::value, "the buffers must have the type of the values");
+      nthreads = sortThreads(v.size(), nthreads);
+      if (nthreads == 1) {
+        radixSortIndexInto(v, decreasing, idx, buffers);
+        return;
+      }
+
+      using Key = typename RadixKey<T>::type;
+      const int NBUCKETS = 256;
+      const int nbytes = sizeof(Key);
+      const std::size_t n = v.size();
+
+      auto &keys = buffers.keys, &tmpKeys = buffers.tmpKeys;
+      auto &tmpIdx = buffers.tmpIdx, &counter = buffers.counter;
+      keys.resize(n); tmpKeys.resize(n);
+      idx.resize(n); tmpIdx.resize(n);
+
+      // Keys and a histogram of each byte per thread, used to skip the uniform passes.
+      auto chunks = splitRange(n, nthreads);
+      counter.assign(static_cast<std::size_t>(nthreads) * nbytes * NBUCKETS, 0);
+      parallelFor(nthreads, [&](int t) {
+        auto tcounter = counter.data() + static_cast<std::size_t>(t) * nbytes * NBUCKETS;
+        forEachElement(v, chunks[t], chunks[t+1], [&](std::size_t i, T value) {
+          auto k = RadixKey<T>::key(value);
+          if (decreasing) k = static_cast<Key>(~k);
+          keys[i] = k;
+          idx[i] = static_cast<IndexT>(i);
+          for (int b = 0; b < nbytes; b++)
+            tcounter[b*NBUCKETS + ((k >> (8*b)) & 0xFF)]++;
+        });
+      });
+
+      // The uniform passes are found first, so the passes reuse 'counter' for their histograms.
+      bool uniform[nbytes];
+      for (int b = 0; b < nbytes; b++) {
+        int d0 = (keys[0] >> (8*b)) & 0xFF;
+        std::size_t count = 0;
+        for (int t = 0; t < nthreads; t++)
+          count += counter[(static_cast<std::size_t>(t) * nbytes + b) * NBUCKETS + d0];
+        uniform[b] = count == n;
+      }
+
+      for (int b = 0; b < nbytes; b++) {
+        if (uniform[b])
+          continue;
+
+        parallelCountingPass<IndexT>(keys, NBUCKETS, nthreads, counter,
+          [b](Key k) { return static_cast<int>((k >> (8*b)) & 0xFF); },
+          [&](IndexT i, IndexT pos) { tmpKeys[pos] = keys[i]; tmpIdx[pos] = idx[i]; });
+        keys.swap(tmpKeys);
+        idx.swap(tmpIdx);
+      }
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingRadixSortIndex(const std::vector<T> &v)
+    {
+      return radixSortIndex<T, IndexT>(v, false);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingRadixSortIndex(const std::vector<T> &v)
+    {
+      return radixSortIndex<T, IndexT>(v, true);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingRadixSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      return radixSortIndex<T, IndexT>(v, false, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingRadixSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      return radixSortIndex<T, IndexT>(v, true, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, CountingSortTag)
+    {
+      return incresingCountingSortIndex<T, IndexT>(v);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, RadixSortTag)
+    {
+      return increasingRadixSortIndex<T, IndexT>(v);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, ComparisonSortTag)
+    {
+      return STLsortIndex<T, IndexT>(v, [](const T& v1, const T& v2) { return v1 < v2; });
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v)
+    {
+      return increasingSortIndex<T, IndexT>(v, typename SortStrategy<T>::type());
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, CountingSortTag)
+    {
+      return decreasingCountingSortIndex<T, IndexT>(v);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, RadixSortTag)
+    {
+      return decreasingRadixSortIndex<T, IndexT>(v);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, ComparisonSortTag)
+    {
+      return STLsortIndex<T, IndexT>(v, [](const T& v1, const T& v2) { return v1 > v2; });
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v)
+    {
+      return decreasingSortIndex<T, IndexT>(v, typename SortStrategy<T>::type());
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, int nthreads, CountingSortTag)
+    {
+      return incresingCountingSortIndex<T, IndexT>(v, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, int nthreads, RadixSortTag)
+    {
+      return increasingRadixSortIndex<T, IndexT>(v, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, int, ComparisonSortTag tag)
+    {
+      return increasingSortIndex<T, IndexT>(v, tag);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> increasingSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      return increasingSortIndex<T, IndexT>(v, nthreads, typename SortStrategy<T>::type());
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, int nthreads, CountingSortTag)
+    {
+      return decreasingCountingSortIndex<T, IndexT>(v, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, int nthreads, RadixSortTag)
+    {
+      return decreasingRadixSortIndex<T, IndexT>(v, nthreads);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, int, ComparisonSortTag tag)
+    {
+      return decreasingSortIndex<T, IndexT>(v, tag);
+    }
+
+    template<typename T, typename IndexT>
+    std::vector<IndexT> decreasingSortIndex(const std::vector<T> &v, int nthreads)
+    {
+      return decreasingSortIndex<T, IndexT>(v, nthreads, typename SortStrategy<T>::type());
+    }
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, CountingSortTag)
+    {
+      countingSortIndexInto(v, decreasing, idx, buffers.counter);
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, RadixSortTag)
+    {
+      radixSortIndexInto(v, decreasing, idx, buffers);
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &, ComparisonSortTag)
+    {
+      idx.resize(v.size());
+      std::iota(idx.begin(), idx.end(), 0);
+      std::stable_sort(idx.begin(), idx.end(), [&v, decreasing](IndexT i1, IndexT i2) { 
+        return decreasing ? v[i1] > v[i2] : v[i1] < v[i2];
+      });
+    }
+
+    template<typename V, typename T, typename IndexT, typename Tag>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, Tag)
+    {
+      sortIndexInto(v, decreasing, idx, buffers, typename SortAlgorithm<Tag, T>::type());
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, int nthreads, CountingSortTag)
+    {
+      countingSortIndexInto(v, decreasing, idx, buffers.counter, nthreads);
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, int nthreads, RadixSortTag)
+    {
+      radixSortIndexInto(v, decreasing, idx, buffers, nthreads);
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, int, ComparisonSortTag tag)
+    {
+      sortIndexInto(v, decreasing, idx, buffers, tag);
+    }
+
+    template<typename V, typename T, typename IndexT, typename Tag>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers, int nthreads, Tag)
+    {
+      sortIndexInto(v, decreasing, idx, buffers, nthreads, typename SortAlgorithm<Tag, T>::type());
+    }
+
+    template<typename V, typename T, typename IndexT>
+    void sortIndexInto(const V &v, bool decreasing, std::vector<IndexT> &idx, 
+      SortBuffers<T, IndexT> &buffers)
+    {
+      sortIndexInto(v, decreasing, idx, buffers, typename SortStrategy<T>::type());
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <pomar/Attribute/AttributeCollection.hpp>
+#include <pomar/ComponentTree/CTree.hpp>
+
+#include <vector>
+#include <cstddef>
+
+#ifndef ATTRIBUTE_FILTER_HPP_INCLUDED
+#define ATTRIBUTE_FILTER_HPP_INCLUDED
+
+/** @file */
+
+namespace pomar
+{
+  /**
+   * Decision rule of an attribute filter, which decides from the criterion of each node (e.g.
+   * area >= threshold) whether the node is kept:
+   *  - Direct: a node is kept when its criterion is true (its descendants are decided on their own);
+   *  - Min: a node is kept when its criterion and the ones of all its ancestors are true
+   *    (i.e. the tree is pruned at the first node whose criterion is false);
+   *  - Max: a node is kept when the criterion of the node or of one of its descendants is true;
+   *  - Subtractive: as Direct, but the kept descendants of a removed node are lowered (raised in a
+   *    min-tree) by the contrast of the removed node, so the contrast between a kept node and its
+   *    kept ancestor is the one it had with its parent. */
+  enum class FilterRule { Direct, Min, Max, Subtractive };
+
+  /**
+   * Class which filters an image through its component tree (CTree or CompactCTree): the pixels of
+   * a removed node are given the level of its nearest kept ancestor (the root is always kept). The
+   * filtered image is written directly from the nodes, so the tree is not modified, and the whole
+   * filter takes time linear in the number of nodes and pixels. */
+  template<class T, class Tree = CTree<T>>
+  class AttributeFilter
+  {
+  public:
+    /** Type of the node and element ids. */
+    using IndexType = typename Tree::IndexType;
+
+    /** Construct a filter with the decision rule 'rule'. */
+    explicit AttributeFilter(FilterRule rule = FilterRule::Direct);
+
+    /** Get the decision rule of this filter. */
+    inline FilterRule rule() const { return _rule; }
+    /** Set the decision rule of this filter. */
+    inline void rule(FilterRule rule) { _rule = rule; }
+
+    /**
+     * Filter the image of 'ct' keeping the nodes whose attribute value 'attr' (e.g.
+     * attrs[attrs.attrIndex(AttrType::AREA)]) is greater than or equal to 'threshold'. */
+    std::vector<T> filter(const Tree &ct, const AttributeValues &attr, double threshold) const;
+
+    /**
+     * Filter the image of 'ct' with the criterion 'keep', which is called once per node id
+     * ('keep(id)' is true if the node should be kept). */
+    template<class Criterion>
+    std::vector<T> filter(const Tree &ct, Criterion keep) const;
+
+    /**
+     * Filter the image of 'ct' keeping the nodes whose attribute value 'attr' is greater than or
+     * equal to 'threshold' and write it into 'out' (room for ct.numberOfElements() values), with
+     * 'nthreads' threads. No memory is allocated for the image. */
+    void filter(const Tree &ct, const AttributeValues &attr, double threshold, T *out, 
+      int nthreads = 1) const;
+
+    /**
+     * Filter the image of 'ct' with the criterion 'keep' and write it into 'out' (room for
+     * ct.numberOfElements() values), with 'nthreads' threads. */
+    template<class Criterion>
+    void filter(const Tree &ct, Criterion keep, T *out, int nthreads = 1) const;
+
+    /**
+     * Compute the level of each node of 'ct' in the filtered image, with the criterion 'keep'
+     * (one level per node id). */
+    template<class Criterion>
+    std::vector<T> filteredLevels(const Tree &ct, Criterion keep) const;
+
+  private:
+    FilterRule _rule;
+  };
+
+  /* ===================== [IMPLEMENTATION ] ================================================= */
+  template<class T, class Tree>
+  AttributeFilter<T, Tree>::AttributeFilter(FilterRule rule)
+    :_rule{rule}
+  {}
+
+  template<class T, class Tree>
+  std::vector<T> AttributeFilter<T, Tree>::filter(const Tree &ct, const AttributeValues &attr, 
+    double threshold) const
+  {
+    return filter(ct, [&attr, threshold](IndexType id) { return attr[id] >= threshold; });
+  }
+
+  template<class T, class Tree>
+  template<class Criterion>
+  std::vector<T> AttributeFilter<T, Tree>::filter(const Tree &ct, Criterion keep) const
+  {
+    std::vector<T> out(ct.numberOfElements());
+    filter(ct, keep, out.data());
+    return out;
+  }
+
+  template<class T, class Tree>
+  void AttributeFilter<T, Tree>::filter(const Tree &ct, const AttributeValues &attr, double threshold,
+    T *out, int nthreads) const
+  {
+    filter(ct, [&attr, threshold](IndexType id) { return attr[id] >= threshold; }, out, nthreads);
+  }
+
+  template<class T, class Tree>
+  template<class Criterion>
+  void AttributeFilter<T, Tree>::filter(const Tree &ct, Criterion keep, T *out, int nthreads) const
+  {
+    // The image is written in pixel order (sequential writes), reading the level of the node of
+    // each pixel.
+    auto levels = filteredLevels(ct, keep);
+    writeNodeLevels(ct.numberOfElements(), [&ct](std::size_t p) { return ct.nodeByElement(p); },
+      [&levels](IndexType id) { return levels[id]; }, out, nthreads);
+  }
+
+  template<class T, class Tree>
+  template<class Criterion>
+  std::vector<T> AttributeFilter<T, Tree>::filteredLevels(const Tree &ct, Criterion keep) const
+  {
+    // Parents come before their children: the ids are visited forwards to decide top-down and
+    // backwards to decide bottom-up.
+    const IndexType n = static_cast<IndexType>(ct.numberOfNodes());
+    std::vector<char> kept(n);
+    for (IndexType id = 0; id < n; ++id)
+      kept[id] = keep(id) ? 1 : 0;
+
+    if (_rule == FilterRule::Max) {
+      for (IndexType id = n - 1; id > 0; --id)
+        if (kept[id]) kept[ct.nodeParent(id)] = 1;
+    }
+    else if (_rule == FilterRule::Min) {
+      for (IndexType id = 1; id < n; ++id)
+        if (!kept[ct.nodeParent(id)]) kept[id] = 0;
+    }
+
+    std::vector<T> levels(n);
+    if (n == 0) return levels;
+    levels[0] = ct.nodeLevel(0);
+    for (IndexType id = 1; id < n; ++id) {
+      const IndexType parent = ct.nodeParent(id);
+      if (!kept[id])
+        levels[id] = levels[parent];
+      else if (_rule == FilterRule::Subtractive)
+        levels[id] = static_cast<T>(levels[parent] + (ct.nodeLevel(id) - ct.nodeLevel(parent)));
+      else
+        levels[id] = ct.nodeLevel(id);
+    }
+    return levels;
+  }
+}
+#endif
@@ -177,6 +177,121 @@ namespace pomar
   {
     return isEqual(q);
   }
+
+  /**
+  * Class to represent 3D points of any type (e.g. voxels of volumes).
+  */
+  template<class T>
+  class Point3D
+  {
+  public:
+    /** Construct a point from 3 values of a type T. */
+    Point3D(T px, T py, T pz);
+
+    /** Get the value of the coordinate x. */
+    inline T x() const { return _x; }
+
+    /** Set a value of the coordinate x. */
+    inline void x(T px) { _x = px; }
+
+    /** Get the value of the coordinate y. */
+    inline T y() const { return _y; }
+
+    /** Set a value of the coordinate y. */
+    inline void y(T py) { _y = py; }
+
+    /** Get the value of the coordinate z. */
+    inline T z() const { return _z; }
+
+    /** Set a value of the coordinate z. */
+    inline void z(T pz) { _z = pz; }
+
+    /** Sum this point with a point q using + operator of the type T */
+    Point3D<T> sum(const Point3D<T>& q) const;
+
+    /** Subtract point q from this point using - operator of the type T */
+    Point3D<T> sub(const Point3D<T>& q) const;
+
+    /** Check whether this point is equal to a point q or not. */
+    bool isEqual(const Point3D<T> &q) const;
+
+    /** Multiplicate this point by a value of type V. */
+    template<typename V> Point3D<T> mult(const V& value) const;
+
+    /** Divide this point by a value of type V. */
+    template<typename V> Point3D<T> div(const V& value) const;
+
+    /** Shortcut for sum(). */
+    Point3D<T> operator+(const Point3D<T> &q) const { return sum(q); }
+    /** Update this point by summing it with q. */
+    void operator+=(const Point3D<T> &q) { _x += q._x; _y += q._y; _z += q._z; }
+
+    /** Shortcut for sub().*/
+    Point3D<T> operator-(const Point3D<T> &q) const { return sub(q); }
+    /** Update this point by subtracting q from it */
+    void operator-=(const Point3D<T> &q) { _x -= q._x; _y -= q._y; _z -= q._z; }
+
+    /** Shortcut for isEqual() */
+    bool operator==(const Point3D<T>& q) const { return isEqual(q); }
+
+    /** Shortcut for mult() */
+    template<typename V> Point3D<T> operator*(const V& value) const { return mult(value); }
+    /** Update this point by multiplying it by value. */
+    template<typename V> void operator*=(const V& value) { _x *= value; _y *= value; _z *= value; }
+    /** Shortcut by div() */
+    template<typename V> Point3D<T> operator/(const V& value) const { return div(value); }
+    /** Update this point by dividing it by value. */
+    template<typename V> void operator/=(const V& value) { _x /= value; _y /= value; _z /= value; }
+
+  private:
+    T _x;
+    T _y;
+    T _z;
+  };
+
+  using ULPoint3D = Point3D<unsigned long>;
+  using LPoint3D = Point3D<long>;
+  using IPoint3D = Point3D<int>;
+  using UIPoint3D = Point3D<unsigned int>;
+  using FPoint3D = Point3D<float>;
+  using DPoint3D = Point3D<double>;
+
+  template<class T>
+  Point3D<T>::Point3D(T px, T py, T pz)
+    :_x(px), _y(py), _z(pz)
+  {}
+
+  template<class T>
+  Point3D<T> Point3D<T>::sum(const Point3D<T>& q) const
+  {
+    return Point3D<T>(_x + q._x, _y + q._y, _z + q._z);
+  }
+
+  template<class T>
+  Point3D<T> Point3D<T>::sub(const Point3D<T>& q) const
+  {
+    return Point3D<T>(_x - q._x, _y - q._y, _z - q._z);
+  }
+
+  template<class T>
+  bool Point3D<T>::isEqual(const Point3D<T> &q) const
+  {
+    return _x == q._x && _y == q._y && _z == q._z;
+  }
+
+  template<class T>
+  template<typename V>
+  Point3D<T> Point3D<T>::mult(const V& value) const
+  {
+    return Point3D<T>(_x * value, _y * value, _z * value);
+  }
+
+  template<class T>
+  template<typename V>
+  Point3D<T> Point3D<T>::div(const V& value) const
+  {
+    return Point3D<T>(_x / value, _y / value, _z / value);
+  }
 }
 
-#endif
+#endif
\ No newline at end of file
@@ -1,39 +1,68 @@
 #include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <algorithm>
 
 namespace pomar
 {
   AdjacencyByTranslating2D::
   AdjacencyByTranslating2D(int width, int height, const std::vector<IPoint2D>& t)
     :_width(width), _height(height), _t(t), _neighbours(t.size())
-  {}
+  {
+    computeOffsets();
+  }
 
   AdjacencyByTranslating2D::
   AdjacencyByTranslating2D(int width, int height, std::initializer_list<IPoint2D>& t)
     :_width(width), _height(height), _t(t), _neighbours(t.size())
-  {}
+  {
+    computeOffsets();
+  }
+
+  void AdjacencyByTranslating2D::computeOffsets()
+  {
+    // The interior region [_xbegin, _xend) x [_ybegin, _yend) is the grid without a frame 
+    // as wide as the largest translation on each side.
+    int minx = 0, maxx = 0, miny = 0, maxy = 0;
+    _offsets.resize(_t.size());
+    for (size_t i = 0; i < _t.size(); ++i) {
+      _offsets[i] = _t[i].y() * _width + _t[i].x();
+      minx = std::min(minx, _t[i].x()); maxx = std::max(maxx, _t[i].x());
+      miny = std::min(miny, _t[i].y()); maxy = std::max(maxy, _t[i].y());
+    }
+    _xbegin = -minx; _xend = _width - maxx;
+    _ybegin = -miny; _yend = _height - maxy;
+  }
 
   const std::vector<int>&
   AdjacencyByTranslating2D::neighbours(int id)
   {
-    auto px = id % _width;
-    auto py = id / _width;
-    IPoint2D currElem(px, py);
+    const int py = id / _width;
+    const int px = id - py * _width;
 
-    for (auto& n: _neighbours)
-      n = Adjacency::NoAdjacentIndex;
+    if (isInterior(px, py)) {
+      for (size_t i = 0; i < _neighbours.size(); ++i)
+        _neighbours[i] = id + _offsets[i];
+      return _neighbours;
+    }
 
     auto j = 0;
     for (size_t i = 0; i < _neighbours.size(); ++i) {
-      auto q = currElem + _t[i];
-
-      if (q.x() >= 0 && q.x() < _width && q.y() >= 0 && q.y() < _height)
-	      _neighbours[j++] = q.y() * _width + q.x();
-
+      const int qx = px + _t[i].x(), qy = py + _t[i].y();
+      if (qx >= 0 && qx < _width && qy >= 0 && qy < _height)
+	      _neighbours[j++] = id + _offsets[i];
     }
 
+    for (size_t i = j; i < _neighbours.size(); ++i)
+      _neighbours[i] = Adjacency::NoAdjacentIndex;
+
     return _neighbours;
   }
 
+  std::unique_ptr<Adjacency>
+  AdjacencyByTranslating2D::clone() const
+  {
+    return std::unique_ptr<AdjacencyByTranslating2D>(new AdjacencyByTranslating2D(_width, _height, _t));
+  }
+
   std::unique_ptr<Adjacency>
   AdjacencyByTranslating2D::createAdjacency4(int width, int height)
   {
@@ -50,5 +79,77 @@ namespace pomar
 
   AdjacencyByTranslating2D::~AdjacencyByTranslating2D()
   {}
-  
+
+  /* ========================================[ 3D ]=============================================== */
+  AdjacencyByTranslating3D::
+  AdjacencyByTranslating3D(int width, int height, int depth, const std::vector<IPoint3D>& t)
+    :_width(width), _height(height), _depth(depth), _t(t), _offsets(t.size()), _neighbours(t.size())
+  {
+    int minx = 0, maxx = 0, miny = 0, maxy = 0, minz = 0, maxz = 0;
+    for (size_t i = 0; i < _t.size(); ++i) {
+      _offsets[i] = (_t[i].z() * _height + _t[i].y()) * _width + _t[i].x();
+      minx = std::min(minx, _t[i].x()); maxx = std::max(maxx, _t[i].x());
+      miny = std::min(miny, _t[i].y()); maxy = std::max(maxy, _t[i].y());
+      minz = std::min(minz, _t[i].z()); maxz = std::max(maxz, _t[i].z());
+    }
+    _xbegin = -minx; _xend = _width - maxx;
+    _ybegin = -miny; _yend = _height - maxy;
+    _zbegin = -minz; _zend = _depth - maxz;
+  }
+
+  const std::vector<int>&
+  AdjacencyByTranslating3D::neighbours(int id)
+  {
+    int j = 0;
+    forEachNeighbour(id, [this, &j](int q) { _neighbours[j++] = q; });
+    for (size_t i = j; i < _neighbours.size(); ++i)
+      _neighbours[i] = Adjacency::NoAdjacentIndex;
+    return _neighbours;
+  }
+
+  std::unique_ptr<Adjacency>
+  AdjacencyByTranslating3D::clone() const
+  {
+    return std::unique_ptr<AdjacencyByTranslating3D>(new AdjacencyByTranslating3D(_width, _height, _depth, _t));
+  }
+
+  std::vector<IPoint3D>
+  AdjacencyByTranslating3D::translations(int connectivity)
+  {
+    // A translation is in the neighbourhood when the number of its non-zero coordinates is
+    // at most 1 (6-connectivity), 2 (18-connectivity) or 3 (26-connectivity).
+    const int maxNonZero = connectivity == 6 ? 1 : connectivity == 18 ? 2 : 3;
+    std::vector<IPoint3D> t;
+    for (int dz = -1; dz <= 1; ++dz) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          const int nonZero = (dx != 0) + (dy != 0) + (dz != 0);
+          if (nonZero > 0 && nonZero <= maxNonZero)
+            t.emplace_back(dx, dy, dz);
+        }
+      }
+    }
+    return t;
+  }
+
+  std::unique_ptr<Adjacency>
+  AdjacencyByTranslating3D::createAdjacency6(int width, int height, int depth)
+  {
+    return std::unique_ptr<AdjacencyByTranslating3D>(
+      new AdjacencyByTranslating3D(width, height, depth, translations(6)));
+  }
+
+  std::unique_ptr<Adjacency>
+  AdjacencyByTranslating3D::createAdjacency18(int width, int height, int depth)
+  {
+    return std::unique_ptr<AdjacencyByTranslating3D>(
+      new AdjacencyByTranslating3D(width, height, depth, translations(18)));
+  }
+
+  std::unique_ptr<Adjacency>
+  AdjacencyByTranslating3D::createAdjacency26(int width, int height, int depth)
+  {
+    return std::unique_ptr<AdjacencyByTranslating3D>(
+      new AdjacencyByTranslating3D(width, height, depth, translations(26)));
+  }
 }
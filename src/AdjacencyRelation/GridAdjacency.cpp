@@ -0,0 +1,19 @@
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+
+namespace pomar
+{
+  constexpr int GridOffsets2D<4>::dx[4];
+  constexpr int GridOffsets2D<4>::dy[4];
+  constexpr int GridOffsets2D<8>::dx[8];
+  constexpr int GridOffsets2D<8>::dy[8];
+
+  constexpr int GridOffsets3D<6>::dx[6];
+  constexpr int GridOffsets3D<6>::dy[6];
+  constexpr int GridOffsets3D<6>::dz[6];
+  constexpr int GridOffsets3D<18>::dx[18];
+  constexpr int GridOffsets3D<18>::dy[18];
+  constexpr int GridOffsets3D<18>::dz[18];
+  constexpr int GridOffsets3D<26>::dx[26];
+  constexpr int GridOffsets3D<26>::dy[26];
+  constexpr int GridOffsets3D<26>::dz[26];
+}
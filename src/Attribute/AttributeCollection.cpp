@@ -1,37 +1,144 @@
 #include <pomar/Attribute/AttributeCollection.hpp>
 
+#include <stdexcept>
+#include <memory>
+#include <cstring>
+#include <type_traits>
+
 namespace pomar
 {
+  std::size_t attrValueSize(AttrValueType type)
+  {
+    switch (type) {
+      case AttrValueType::Int32: return sizeof(std::int32_t);
+      case AttrValueType::Int64: return sizeof(std::int64_t);
+      case AttrValueType::Float: return sizeof(float);
+      default: return sizeof(double);
+    }
+  }
+
+  /* ----------------------------- [ ATTRIBUTE VALUES ] ------------------------------------ */
+  std::vector<double> AttributeValues::toVector() const
+  {
+    std::vector<double> v(_size);
+    for (std::size_t i = 0; i < _size; ++i)
+      v[i] = (*this)[i];
+    return v;
+  }
+
+  bool operator==(const AttributeValues &values, const std::vector<double> &v)
+  {
+    if (values.size() != v.size()) return false;
+    for (std::size_t i = 0; i < v.size(); ++i) {
+      if (values[i] != v[i]) return false;
+    }
+    return true;
+  }
+
+  bool operator==(const std::vector<double> &v, const AttributeValues &values)
+  {
+    return values == v;
+  }
+
+  bool operator==(const AttributeValues &v1, const AttributeValues &v2)
+  {
+    if (v1.size() != v2.size()) return false;
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+      if (static_cast<double>(v1[i]) != static_cast<double>(v2[i])) return false;
+    }
+    return true;
+  }
+
+  /* ---------------------------- [ ATTRIBUTE COLLECTION ] --------------------------------- */
+  namespace
+  {
+    /* Create 'size' zero values of type V in the untyped 'storage'. */
+    template<typename V>
+    void createValues(unsigned char *storage, std::size_t size)
+    {
+      std::uninitialized_fill_n(reinterpret_cast<V*>(storage), size, V(0));
+    }
+  }
+
+  AttributeCollection::Column::Column(AttrValueType pvalueType, std::size_t psize)
+    :valueType{pvalueType}, size{psize}, storage{new unsigned char[psize * attrValueSize(pvalueType)]}
+  {
+    // new unsigned char[] storage is aligned for any fundamental type.
+    switch (valueType) {
+      case AttrValueType::Int32: createValues<std::int32_t>(storage.get(), size); break;
+      case AttrValueType::Int64: createValues<std::int64_t>(storage.get(), size); break;
+      case AttrValueType::Float: createValues<float>(storage.get(), size); break;
+      default: createValues<double>(storage.get(), size); break;
+    }
+  }
+
+  AttributeCollection::Column::Column(const Column &other)
+    :Column(other.valueType, other.size)
+  {
+    std::memcpy(storage.get(), other.storage.get(), size * attrValueSize(valueType));
+  }
+
+  AttributeCollection::Column& AttributeCollection::Column::operator=(Column other)
+  {
+    valueType = other.valueType;
+    size = other.size;
+    storage = std::move(other.storage);
+    return *this;
+  }
+
   AttributeCollection::AttributeCollection()
-    :_nextIndex{0}
   {}
 
-  std::vector<double>& AttributeCollection::operator[](int attrIndex)
+  AttributeValues AttributeCollection::operator[](int attrIndex)
   {
-    return _values[attrIndex];
+    auto &c = _columns[attrIndex];
+    return AttributeValues(c.valueType, c.storage.get(), c.size);
   }
 
-  double AttributeCollection::get(int attrIndex, int nodeId)
+  double AttributeCollection::get(int attrIndex, std::size_t nodeId)
   {
-    return _values[attrIndex][nodeId];
+    return (*this)[attrIndex][nodeId];
   }
 
-  void AttributeCollection::push(AttrType type, int nNodes)
+  void AttributeCollection::push(AttrType type, std::size_t nNodes)
   {
-    _attrIndex[type] = _nextIndex;
-    _values.push_back(std::vector<double>(nNodes, 0.0));
-    _nextIndex++;
+    push(type, nNodes, AttrValueType::Double);
   }
 
-  void AttributeCollection::set(int attrIndex, int nodeId, double value)
+  void AttributeCollection::push(AttrType type, std::size_t nNodes, AttrValueType valueType)
   {
-    _values[attrIndex][nodeId] = value;
+    auto t = static_cast<std::size_t>(type);
+    if (t >= _attrIndex.size())
+      _attrIndex.resize(t + 1, -1);
+    _attrIndex[t] = static_cast<int>(_columns.size());
+
+    // The columns are moved (not copied) when _columns grows, so their values do not move.
+    static_assert(std::is_nothrow_move_constructible<Column>::value, "columns must be moved without exceptions");
+    _columns.emplace_back(valueType, nNodes);
+  }
+
+  void AttributeCollection::set(int attrIndex, std::size_t nodeId, double value)
+  {
+    (*this)[attrIndex][nodeId] = value;
+  }
+
+  std::size_t AttributeCollection::memoryUsage() const
+  {
+    std::size_t bytes = 0;
+    for (const auto &c : _columns)
+      bytes += c.size * attrValueSize(c.valueType);
+    return bytes;
   }
 
   void AttributeCollection::clear()
   {
     _attrIndex.clear();
-    _values.clear();
-    _nextIndex = 0;
+    _columns.clear();
+  }
+
+  void AttributeCollection::checkValueType(int attrIndex, AttrValueType valueType) const
+  {
+    if (_columns[attrIndex].valueType != valueType)
+      throw std::invalid_argument("the value type does not match the value type of the attribute");
   }
-}
\ No newline at end of file
+}
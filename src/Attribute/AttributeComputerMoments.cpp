@@ -0,0 +1,79 @@
+#include <pomar/Attribute/AttributeComputerMoments.hpp>
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace pomar
+{
+  CentralMoments centralMoments(const MomentSums &s)
+  {
+    const double n = static_cast<double>(s.n);
+    const double mx = s.x / n, my = s.y / n;
+    CentralMoments mu;
+    mu.mu20 = s.xx - mx*s.x;
+    mu.mu02 = s.yy - my*s.y;
+    mu.mu11 = s.xy - mx*s.y;
+    mu.mu30 = s.xxx - 3*mx*s.xx + 2*mx*mx*s.x;
+    mu.mu03 = s.yyy - 3*my*s.yy + 2*my*my*s.y;
+    mu.mu21 = s.xxy - 2*mx*s.xy - my*s.xx + 2*mx*mx*s.y;
+    mu.mu12 = s.xyy - 2*my*s.xy - mx*s.yy + 2*my*my*s.x;
+    return mu;
+  }
+
+  CentralMoments centralMoments(const SecondOrderMomentSums &s)
+  {
+    const double n = static_cast<double>(s.n);
+    const double mx = s.x / n, my = s.y / n;
+    CentralMoments mu{0, 0, 0, 0, 0, 0, 0};
+    mu.mu20 = s.xx - mx*s.x;
+    mu.mu02 = s.yy - my*s.y;
+    mu.mu11 = s.xy - mx*s.y;
+    return mu;
+  }
+
+  void checkMomentSumsRange(int width, int height, int order)
+  {
+    // Every partial sum is bounded by the sum of |x|^i |y|^j (i + j = order) over all the pixels,
+    // where |x| <= width/2 and |y| <= height/2 are the coordinates relative to the centre.
+    const double maxCoordinate = std::max(width / 2, height / 2);
+    const double bound = static_cast<double>(width) * height * std::pow(maxCoordinate, order);
+    if (bound >= 9.2e18)
+      throw std::invalid_argument("the image is too large to accumulate the moment sums exactly in 64-bit integers");
+  }
+
+  double eccentricity(const CentralMoments &mu)
+  {
+    const double mean = (mu.mu20 + mu.mu02) / 2, diff = (mu.mu20 - mu.mu02) / 2;
+    const double r = std::sqrt(diff*diff + mu.mu11*mu.mu11);
+    const double l1 = mean + r, l2 = mean - r;
+    if (l1 <= 0) return 0;
+    return std::sqrt(std::max(0.0, 1 - l2 / l1));
+  }
+
+  double orientation(const CentralMoments &mu)
+  {
+    return 0.5 * std::atan2(2*mu.mu11, mu.mu20 - mu.mu02);
+  }
+
+  std::array<double, 7> huMoments(const CentralMoments &mu, std::int64_t n)
+  {
+    /* Normalised central moments: eta_pq = mu_pq / n^(1 + (p+q)/2). */
+    const double n2 = static_cast<double>(n) * n, n25 = n2 * std::sqrt(static_cast<double>(n));
+    const double e20 = mu.mu20 / n2, e02 = mu.mu02 / n2, e11 = mu.mu11 / n2;
+    const double e30 = mu.mu30 / n25, e03 = mu.mu03 / n25, e21 = mu.mu21 / n25, e12 = mu.mu12 / n25;
+
+    const double a = e30 + e12, b = e21 + e03;
+    const double c = e30 - 3*e12, d = 3*e21 - e03;
+
+    std::array<double, 7> hu;
+    hu[0] = e20 + e02;
+    hu[1] = (e20 - e02)*(e20 - e02) + 4*e11*e11;
+    hu[2] = c*c + d*d;
+    hu[3] = a*a + b*b;
+    hu[4] = c*a*(a*a - 3*b*b) + d*b*(3*a*a - b*b);
+    hu[5] = (e20 - e02)*(a*a - b*b) + 4*e11*a*b;
+    hu[6] = d*a*(a*a - 3*b*b) - c*b*(3*a*a - b*b);
+    return hu;
+  }
+}
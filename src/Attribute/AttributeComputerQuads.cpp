@@ -0,0 +1,65 @@
+#include <pomar/Attribute/AttributeComputerQuads.hpp>
+
+
+namespace pomar
+{
+  /* --------------------- [ AttibuteFromQuadsComputers ] ---------------------------------- */
+  void AttributeFromQuadsComputer::setUp(AttributeCollection &attrs, QConnectivity con)
+  {
+    _p1 = attrs.attrIndex(AttrType::QUADS_Q1);
+    _p2 = attrs.attrIndex(AttrType::QUADS_Q2);
+    _pd = attrs.attrIndex(AttrType::QUADS_QD); 
+    _p3 = attrs.attrIndex(AttrType::QUADS_Q3); 
+    _p4 = attrs.attrIndex(AttrType::QUADS_Q4);
+    _con = con;
+    _attrIdx = attrs.attrIndex(attrType());
+
+    const int counts[5] = {_p1, _p2, _pd, _p3, _p4};
+    for (int i = 0; i < 5; ++i) {
+      const bool wide = attrs.valueType(counts[i]) == AttrValueType::Int64;
+      _counts32[i] = wide ? nullptr : attrs.column<std::int32_t>(counts[i]).data();
+      _counts64[i] = wide ? attrs.column<std::int64_t>(counts[i]).data() : nullptr;
+    }
+    _valueType = attrs.valueType(_attrIdx);
+    _valueSize = attrValueSize(_valueType);
+    _values = attrs[_attrIdx].data();
+  }
+
+  /* ------------------- [ AttibuteFromQuadsComputers subclasses ] ------------------------------- */
+  // The counts are accumulated in 64-bit integers, so the areas of trees of any size are exact.
+  void QArea::compute(size_t nodeId, AttributeCollection &)
+  {
+    auto q = counts(nodeId);
+    setValue(nodeId, static_cast<double>((q.q1 + 2*q.q2 + 2*q.qd + 3*q.q3 + 4*q.q4) / 4));
+  }
+
+  void QCArea::compute(size_t nodeId, AttributeCollection &)
+  {
+    auto q = counts(nodeId);
+    setValue(nodeId, 0.25*((q.q1/2.0) + q.q2 + q.qd + ((7.0/2.0)*q.q3) + (4.0*q.q4)));
+  }
+
+  void QPerimeter::compute(size_t nodeId, AttributeCollection &)
+  {
+    auto q = counts(nodeId);
+    setValue(nodeId, static_cast<double>(q.q1 + q.q2 + 2*q.qd + q.q3));
+  }
+
+  void QCPerimeter::compute(size_t nodeId, AttributeCollection &)
+  {
+    auto q = counts(nodeId);
+    setValue(nodeId, q.q2 + ((q.q1 + q.q3) / 1.41));
+  }
+
+  void QEulerNumber::compute(size_t nodeId, AttributeCollection &)
+  {
+    auto q = counts(nodeId);
+    std::int64_t e = 0;
+    if (_con == Four)
+      e = (q.q1 - q.q3 + 2*q.qd) / 4;
+    else
+      e = (q.q1 - q.q3 - 2*q.qd) / 4;
+    
+    setValue(nodeId, static_cast<double>(e));
+  }
+}
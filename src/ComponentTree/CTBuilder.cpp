@@ -1,12 +1,38 @@
 #include <pomar/ComponentTree/CTBuilder.hpp>
 
-namespace pomar 
+namespace pomar
 {
-  /* ========================================[ FIND ROOT ]========================================================= */
-  int CTBuilder::findRoot(std::vector<int>& zpar, int p) const
+  /* ========================================[ CONSTRUCTORS ]====================================================== */
+  CTBuilder::CTBuilder()
+    :_nthreads{1}, _algorithm{Algorithm::UnionFind}
+  {}
+
+  CTBuilder::CTBuilder(int nthreads)
+    :_nthreads{nthreads}, _algorithm{Algorithm::UnionFind}
+  {}
+
+  CTBuilder::CTBuilder(Algorithm algorithm, int nthreads)
+    :_nthreads{nthreads}, _algorithm{algorithm}
+  {}
+
+  /* ======================================[ CHUNK BOUNDARIES ]==================================================== */
+  std::vector<long long> CTBuilder::chunkBoundaries(std::shared_ptr<CTMeta> pmeta, long long size, int nchunks) const
   {
-    if (zpar[p] != p)
-      zpar[p] = findRoot(zpar, zpar[p]);
-    return zpar[p];
+    auto meta = std::dynamic_pointer_cast<CTMetaImage2D>(pmeta);
+    if (meta && static_cast<long long>(meta->width()) * meta->height() == size) {
+      auto boundaries = splitRange<long long>(meta->height(), std::max(1, std::min(nchunks, meta->height())));
+      for (auto& b: boundaries)
+        b *= meta->width();
+      return boundaries;
+    }
+
+    auto meta3D = std::dynamic_pointer_cast<CTMetaImage3D>(pmeta);
+    if (meta3D && static_cast<long long>(meta3D->width()) * meta3D->height() * meta3D->depth() == size) {
+      auto boundaries = splitRange<long long>(meta3D->depth(), std::max(1, std::min(nchunks, meta3D->depth())));
+      for (auto& b: boundaries)
+        b *= static_cast<long long>(meta3D->width()) * meta3D->height();
+      return boundaries;
+    }
+    return splitRange(size, static_cast<int>(std::max(1LL, std::min<long long>(nchunks, size))));
   }
-}
\ No newline at end of file
+}
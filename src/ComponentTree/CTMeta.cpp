@@ -1,5 +1,7 @@
 #include <pomar/ComponentTree/CTMeta.hpp>
 
+#include <stdexcept>
+
 namespace pomar
 {
   CTMetaImage2D::CTMetaImage2D(int pwidth, int pheight, int pnchannel)
@@ -8,4 +10,27 @@ namespace pomar
 
   CTMetaImage2D::~CTMetaImage2D()
   {}
+
+  CTMetaImageROI2D::CTMetaImageROI2D(int pimageWidth, int pimageHeight, int px, int py, int pwidth, int pheight, 
+    int pnchannel)
+    :CTMetaImage2D(pwidth, pheight, pnchannel), _imageWidth{pimageWidth}, _imageHeight{pimageHeight}, _x{px}, _y{py}
+  {
+    if (px < 0 || py < 0 || pwidth < 0 || pheight < 0 || px + pwidth > pimageWidth || py + pheight > pimageHeight)
+      throw std::invalid_argument("the region of interest must be inside the image");
+  }
+
+  long long CTMetaImageROI2D::localIndex(long long g) const
+  {
+    long long gx = g % _imageWidth - _x, gy = g / _imageWidth - _y;
+    if (g < 0 || gx < 0 || gy < 0 || gx >= width() || gy >= height())
+      return -1;
+    return gy * width() + gx;
+  }
+
+  CTMetaImage3D::CTMetaImage3D(int pwidth, int pheight, int pdepth, int pnchannel)
+    :_width{pwidth}, _height{pheight}, _depth{pdepth}, _nchannel{pnchannel}
+  {}
+
+  CTMetaImage3D::~CTMetaImage3D()
+  {}
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <pomar/Core/Parallel.hpp>
+
+#include <atomic>
+#include <algorithm>
+
+namespace pomar
+{
+  int hardwareThreads()
+  {
+    auto n = static_cast<int>(std::thread::hardware_concurrency());
+    return n > 0 ? n : 1;
+  }
+
+  /* A call of ThreadPool::run: the tasks are claimed through 'next' by the caller and the 
+     workers, and 'finished' counts the tasks which have returned. */
+  struct ThreadPool::Job
+  {
+    Job(int pntasks, const std::function<void(int)> *ptask)
+      :task{ptask}, ntasks{pntasks}, next{0}, finished{0}, errors(pntasks)
+    {}
+
+    const std::function<void(int)> *task;
+    int ntasks;
+    std::atomic<int> next;
+    int finished;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<std::exception_ptr> errors;
+  };
+
+  ThreadPool::ThreadPool(int nworkers)
+    :_stop{false}
+  {
+    reserve(nworkers);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wakeUp.notify_all();
+    for (auto &worker : _workers)
+      worker.join();
+  }
+
+  int ThreadPool::numberOfWorkers()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<int>(_workers.size());
+  }
+
+  void ThreadPool::reserve(int nworkers)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (static_cast<int>(_workers.size()) < nworkers)
+      _workers.emplace_back(&ThreadPool::work, this);
+  }
+
+  void ThreadPool::run(int ntasks, const std::function<void(int)> &task)
+  {
+    if (ntasks <= 0)
+      return;
+
+    auto job = std::make_shared<Job>(ntasks, &task);
+    if (ntasks > 1) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(job);
+      }
+      _wakeUp.notify_all();
+    }
+
+    runTasks(*job);
+    {
+      std::unique_lock<std::mutex> lock(job->mutex);
+      job->done.wait(lock, [&job]() { return job->finished == job->ntasks; });
+    }
+    if (ntasks > 1) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = std::find(_jobs.begin(), _jobs.end(), job);
+      if (it != _jobs.end())
+        _jobs.erase(it);
+    }
+
+    for (auto &e : job->errors) {
+      if (e) std::rethrow_exception(e);
+    }
+  }
+
+  ThreadPool& ThreadPool::shared()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  void ThreadPool::work()
+  {
+    for (;;) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeUp.wait(lock, [this]() { return _stop || !_jobs.empty(); });
+        if (_stop)
+          return;
+        job = _jobs.front();
+        if (job->next.load() >= job->ntasks) {
+          // Every task of the job has been claimed: the caller waits for them and removes it.
+          _jobs.pop_front();
+          continue;
+        }
+      }
+      runTasks(*job);
+    }
+  }
+
+  void ThreadPool::runTasks(Job &job)
+  {
+    for (int t = job.next++; t < job.ntasks; t = job.next++) {
+      try { (*job.task)(t); }
+      catch (...) { job.errors[t] = std::current_exception(); }
+
+      std::lock_guard<std::mutex> lock(job.mutex);
+      if (++job.finished == job.ntasks)
+        job.done.notify_all();
+    }
+  }
+}
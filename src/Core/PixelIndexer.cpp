@@ -1,5 +1,6 @@
 #include <pomar/Core/PixelIndexer.hpp>
 #include <sstream>
+#include <algorithm>
 
 namespace pomar
 {
@@ -11,7 +12,7 @@ namespace pomar
   IPoint2D PixelIndexer::pixel(int p) const
   {
     auto i = index(p);
-    return IPoint2D(i % _width, i / _height);
+    return IPoint2D(i % _width, i / _width);
   }
 
   /*------------------------ [ PIXEL INDEXER NEAREST BORDER ] ---------------------- */
@@ -44,9 +45,9 @@ namespace pomar
   }
 
   IPoint2D PixelIndexerDefaultValue::pixel(int p) const {
-    auto r = index(p%_width, p/_height);
+    auto r = index(p%_width, p/_width);
     if (r == _defaultValue) return IPoint2D(r, r);
-    return IPoint2D{r%_width, r/_height};
+    return IPoint2D{r%_width, r/_width};
   }
 
   /*--------------------------- [PIXEL INDEXER MIRROR IMAGE ] ----------------------------- */
@@ -82,4 +83,41 @@ namespace pomar
     }
     return (_width * py) + px;
   }
-}
\ No newline at end of file
+
+  /*-------------------------- [ VOXEL INDEXER ] ---------------------------------------------- */
+  VoxelIndexer::VoxelIndexer(int pwidth, int pheight, int pdepth)
+    : _width{pwidth}, _height{pheight}, _depth{pdepth}
+  {}
+
+  IPoint3D VoxelIndexer::voxel(int p) const
+  {
+    const int plane = _width * _height;
+    const int z = p / plane, r = p - z * plane;
+    return IPoint3D(r % _width, r / _width, z);
+  }
+
+  /*------------------------ [ VOXEL INDEXER NEAREST BORDER ] --------------------------------- */
+  VoxelIndexerNearestBorder::VoxelIndexerNearestBorder(int pwidth, int pheight, int pdepth)
+    :VoxelIndexer(pwidth, pheight, pdepth)
+  {}
+
+  int VoxelIndexerNearestBorder::index(int px, int py, int pz) const
+  {
+    px = std::min(std::max(px, 0), _width - 1);
+    py = std::min(std::max(py, 0), _height - 1);
+    pz = std::min(std::max(pz, 0), _depth - 1);
+    return (pz * _height + py) * _width + px;
+  }
+
+  /*------------------------- [ VOXEL INDEXER DEFAULT VALUE ] --------------------------------- */
+  VoxelIndexerDefaultValue::VoxelIndexerDefaultValue(int pwidth, int pheight, int pdepth,
+    int pdefaultValue): VoxelIndexer{pwidth, pheight, pdepth}, _defaultValue{pdefaultValue}
+  {}
+
+  int VoxelIndexerDefaultValue::index(int px, int py, int pz) const
+  {
+    if (px < 0 || px >= _width || py < 0 || py >= _height || pz < 0 || pz >= _depth)
+      return _defaultValue;
+    return (pz * _height + py) * _width + px;
+  }
+}
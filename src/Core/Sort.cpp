@@ -0,0 +1,11 @@
+#include <pomar/Core/Sort.hpp>
+
+namespace pomar
+{
+  int sortThreads(std::size_t n, int nthreads)
+  {
+    auto maxThreads = static_cast<int>(std::min<std::size_t>(n / MinElementsPerSortThread, 
+      std::numeric_limits<int>::max()));
+    return std::max(1, std::min(nthreads, maxThreads));
+  }
+}
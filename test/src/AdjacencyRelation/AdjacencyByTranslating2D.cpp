@@ -124,3 +124,33 @@ SCENARIO("AdjacencyByTranslating2D initialise 8 and 4 connectivity correctly") {
     }
   }
 }
+
+SCENARIO("AdjacencyByTranslating2D should compute the same neighbours in the interior and border paths") {
+  GIVEN("An adjacency relation defined by the translations { (-2,1), (1,0), (0,-1), (1,1) } and an image of size (6,5)") {
+    int width = 6, height = 5;
+    std::vector<IPoint2D> dt{{-2,1}, {1,0}, {0,-1}, {1,1}};
+    AdjacencyByTranslating2D adj(width, height, dt);
+
+    WHEN("The neighbours of each pixel are computed.") {
+      THEN("They should be the translated pixels inside the image (in the order of the translations).") {
+        for (int y = 0; y < height; ++y) {
+          for (int x = 0; x < width; ++x) {
+            std::vector<int> expected, visited;
+            for (const auto& t: dt) {
+              auto q = IPoint2D(x, y) + t;
+              if (q.x() >= 0 && q.x() < width && q.y() >= 0 && q.y() < height)
+                expected.push_back(q.y() * width + q.x());
+            }
+            REQUIRE(adj.isInterior(y * width + x) == (expected.size() == dt.size()));
+            adj.forEachNeighbour(y * width + x, [&visited](int q) { visited.push_back(q); });
+            REQUIRE(visited == expected);
+            
+            while (expected.size() < dt.size())
+              expected.push_back(Adjacency::NoAdjacentIndex);
+            REQUIRE(adj.neighbours(y * width + x) == expected);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#include "../../catch.hpp"
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <algorithm>
+
+using namespace pomar;
+
+SCENARIO("AdjacencyByTranslating3D initialise 6 18 and 26 connectivity correctly") {
+  GIVEN("6, 18 and 26-connected adjacency relations for a volume of size (3,3,3)") {
+    auto adj6 = AdjacencyByTranslating3D::createAdjacency6(3, 3, 3);
+    auto adj18 = AdjacencyByTranslating3D::createAdjacency18(3, 3, 3);
+    auto adj26 = AdjacencyByTranslating3D::createAdjacency26(3, 3, 3);
+    auto count = [](const std::vector<int> &n) {
+      return std::count_if(n.begin(), n.end(), [](int q) { return q != Adjacency::NoAdjacentIndex; });
+    };
+
+    WHEN("compute the adjacent voxels of the centre (1,1,1)") {
+      THEN("It should have 6, 18 and 26 neighbours") {
+        REQUIRE(count(adj6->neighbours(13)) == 6);
+        REQUIRE(count(adj18->neighbours(13)) == 18);
+        REQUIRE(count(adj26->neighbours(13)) == 26);
+      }
+      THEN("The 6 neighbours should be { 4, 10, 12, 14, 16, 22 }") {
+        REQUIRE(adj6->neighbours(13) == std::vector<int>({4, 10, 12, 14, 16, 22}));
+      }
+    }
+    WHEN("compute the adjacent voxels of the corner (0,0,0)") {
+      THEN("It should have 3, 6 and 7 neighbours") {
+        REQUIRE(count(adj6->neighbours(0)) == 3);
+        REQUIRE(count(adj18->neighbours(0)) == 6);
+        REQUIRE(count(adj26->neighbours(0)) == 7);
+      }
+    }
+  }
+}
+
+SCENARIO("GridAdjacency3D should visit the same neighbours as AdjacencyByTranslating3D.") {
+  GIVEN("6, 18 and 26-connected adjacency relations for a volume of size (5,4,3)") {
+    int width = 5, height = 4, depth = 3;
+    GridAdjacency6 grid6(width, height, depth);
+    GridAdjacency18 grid18(width, height, depth);
+    GridAdjacency26 grid26(width, height, depth);
+    auto adj6 = AdjacencyByTranslating3D::createAdjacency6(width, height, depth);
+    auto adj18 = AdjacencyByTranslating3D::createAdjacency18(width, height, depth);
+    auto adj26 = AdjacencyByTranslating3D::createAdjacency26(width, height, depth);
+
+    WHEN("The neighbours of each voxel are computed.") {
+      THEN("They should be the same.") {
+        for (int p = 0; p < width * height * depth; ++p) {
+          REQUIRE(grid6.neighbours(p) == adj6->neighbours(p));
+          REQUIRE(grid18.neighbours(p) == adj18->neighbours(p));
+          REQUIRE(grid26.neighbours(p) == adj26->neighbours(p));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#include "../../catch.hpp"
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+
+using namespace pomar;
+
+SCENARIO("GridAdjacency2D should visit the same neighbours as AdjacencyByTranslating2D.") {
+  GIVEN("4 and 8-connected grid adjacencies for an image of size (5,4)") {
+    int width = 5, height = 4;
+    GridAdjacency4 grid4(width, height);
+    GridAdjacency8 grid8(width, height);
+    auto adj4 = AdjacencyByTranslating2D::createAdjacency4(width, height);
+    auto adj8 = AdjacencyByTranslating2D::createAdjacency8(width, height);
+
+    WHEN("The neighbours of each pixel are visited by forEachNeighbour.") {
+      THEN("They should be the valid neighbours of AdjacencyByTranslating2D in the same order.") {
+        for (int p = 0; p < width * height; ++p) {
+          std::vector<int> n4, n8, e4, e8;
+          grid4.forEachNeighbour(p, [&n4](int q) { n4.push_back(q); });
+          grid8.forEachNeighbour(p, [&n8](int q) { n8.push_back(q); });
+          for (auto q: adj4->neighbours(p)) if (q != Adjacency::NoAdjacentIndex) e4.push_back(q);
+          for (auto q: adj8->neighbours(p)) if (q != Adjacency::NoAdjacentIndex) e8.push_back(q);
+          REQUIRE(n4 == e4);
+          REQUIRE(n8 == e8);
+        }
+      }
+    }
+    WHEN("The neighbours of each pixel are computed by the Adjacency interface.") {
+      THEN("They should be the same of AdjacencyByTranslating2D.") {
+        auto clone = grid8.clone();
+        for (int p = 0; p < width * height; ++p) {
+          REQUIRE(grid4.neighbours(p) == adj4->neighbours(p));
+          REQUIRE(clone->neighbours(p) == adj8->neighbours(p));
+        }
+      }
+    }
+  }
+}
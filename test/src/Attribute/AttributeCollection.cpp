@@ -1,5 +1,6 @@
 #include "../../catch.hpp"
 #include <pomar/Attribute/AttributeCollection.hpp>
+#include <stdexcept>
 
 using namespace pomar;
 
@@ -34,4 +35,55 @@ SCENARIO("AttributeCollection stores a collection of attributes for a component
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("AttributeCollection stores the values of each attribute with its own value type.") {
+  GIVEN("An AttributeCollection with an int32, a float and a double attribute for 10 nodes.") {
+    AttributeCollection attrs;
+    attrs.push<std::int32_t>(AttrType::QUADS_Q1, 10);
+    attrs.push<float>(AttrType::QUADS_CONTINUOUS_AREA, 10);
+    attrs.push(AttrType::AREA, 10);
+    WHEN("The value types and indices of the attributes are queried.") {
+      THEN("They should be the pushed types and an attribute not pushed should have index -1.") {
+        REQUIRE(attrs.valueType(attrs.attrIndex(AttrType::QUADS_Q1)) == AttrValueType::Int32);
+        REQUIRE(attrs.valueType(attrs.attrIndex(AttrType::QUADS_CONTINUOUS_AREA)) == AttrValueType::Float);
+        REQUIRE(attrs.valueType(attrs.attrIndex(AttrType::AREA)) == AttrValueType::Double);
+        REQUIRE(attrs.attrIndex(AttrType::PERIMETER) == -1);
+        REQUIRE(attrs.numberOfAttributes() == 3);
+      }
+    }
+    WHEN("Values are written with the typed columns.") {
+      auto q1 = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::QUADS_Q1));
+      q1[3] = 7; q1[3] += 2;
+      attrs.column<float>(attrs.attrIndex(AttrType::QUADS_CONTINUOUS_AREA))[4] = 2.5f;
+      THEN("They should be read as double by operator [] and get.") {
+        REQUIRE(q1.size() == 10);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::QUADS_Q1)][3] == 9.0);
+        REQUIRE(attrs.get(attrs.attrIndex(AttrType::QUADS_CONTINUOUS_AREA), 4) == 2.5);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::QUADS_Q1)][0] == 0.0);
+      }
+    }
+    WHEN("A typed column is requested with a type which is not the attribute's value type.") {
+      THEN("It should throw an invalid argument exception.") {
+        REQUIRE_THROWS_AS(attrs.column<double>(attrs.attrIndex(AttrType::QUADS_Q1)), std::invalid_argument);
+      }
+    }
+    WHEN("The memory usage is queried.") {
+      THEN("It should be 4 bytes per node for the int32 and float attributes and 8 for the double one.") {
+        REQUIRE(attrs.memoryUsage() == 10 * 4 + 10 * 4 + 10 * 8);
+      }
+    }
+    WHEN("More attributes are pushed after a typed column was taken and the collection is copied.") {
+      auto q1 = attrs.column<std::int32_t>(attrs.attrIndex(AttrType::QUADS_Q1));
+      for (int i = 0; i < 20; i++)
+        attrs.push<std::int64_t>(static_cast<AttrType>(static_cast<int>(AttrType::BOUNDING_BOX_MIN_X) + i), 10);
+      q1[2] = 5;
+      AttributeCollection copy = attrs;
+      q1[2] = 6;
+      THEN("The column should still view the values and the copy should own its values.") {
+        REQUIRE(attrs.get(attrs.attrIndex(AttrType::QUADS_Q1), 2) == 6.0);
+        REQUIRE(copy.get(copy.attrIndex(AttrType::QUADS_Q1), 2) == 5.0);
+        REQUIRE(copy.memoryUsage() == attrs.memoryUsage());
+      }
+    }
+  }
+}
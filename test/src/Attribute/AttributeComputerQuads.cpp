@@ -1,6 +1,9 @@
 #include "../../catch.hpp"
+#include "../ComponentTree/CTreeCompare.hpp"
 #include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
 #include <pomar/Attribute/AttributeComputerQuads.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
 #include <pomar/ComponentTree/CTBuilder.hpp>
 #include <numeric>
 #include <algorithm>
@@ -223,4 +226,71 @@ SCENARIO("AttributeComputerQuads should compute area, perimeter (also continuous
       }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("AttributeComputerQuads should compute the area of every node of non-square images and thin images.") {
+  GIVEN("Random images whose sizes are 7x5, 5x2, 2x6 and 1x4.") {
+    std::vector<std::pair<int, int>> sizes = {{7,5}, {5,2}, {2,6}, {1,4}};
+    std::vector<std::shared_ptr<AttributeFromQuadsComputer>> comps = {std::make_shared<QArea>(), 
+      std::make_shared<QEulerNumber>()};
+
+    WHEN("the quads of their max-trees and min-trees with 4 and 8-connectivity are counted") {
+      THEN("The quads area should be the number of pixels of each node and the Euler number of the root 1") {
+        unsigned seed = 7;
+        for (const auto &size : sizes) {
+          int width = size.first, height = size.second;
+          auto f = randomImage<unsigned char>(width, height, 3, seed++);
+          auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+          for (auto treeType : {QTreeType::MaxTree, QTreeType::MinTree}) {
+            for (auto con : {QConnectivity::Four, QConnectivity::Eight}) {
+              CTBuilder builder;
+              auto adj = con == QConnectivity::Four ? AdjacencyByTranslating2D::createAdjacency4(width, height) : 
+                AdjacencyByTranslating2D::createAdjacency8(width, height);
+              auto ct = builder.build(meta, f, std::move(adj), treeType == QTreeType::MaxTree ? 
+                CTBuilder::TreeType::MaxTree : CTBuilder::TreeType::MinTree);
+
+              AttributeComputerQuads<unsigned char> quads{treeType, con, comps};
+              auto attrs = quads.compute(ct);
+              auto areas = AreaAttributeComputer<unsigned char>().compute(ct);
+              auto qarea = attrs.attrIndex(AttrType::QUADS_AREA);
+              auto area = areas.attrIndex(AttrType::AREA);
+              for (size_t id = 0; id < ct.numberOfNodes(); ++id)
+                REQUIRE(attrs[qarea][id] == areas[area][id]);
+              REQUIRE(attrs[attrs.attrIndex(AttrType::QUADS_EULER_NUMBER)][0] == 1.0);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("AttributeComputerQuads should use 64-bit counts for trees with 64-bit indices.") {
+  GIVEN("The max-trees with int and long long indices of a random image of size 23x17.") {
+    int width = 23, height = 17;
+    auto f = randomImage<unsigned char>(width, height, 5, 11);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder builder;
+    auto ct = builder.build(meta, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    auto ct64 = builder.build<long long>(meta, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    std::vector<std::shared_ptr<AttributeFromQuadsComputer>> comps = {std::make_shared<QArea>(), 
+      std::make_shared<QCArea>(), std::make_shared<QPerimeter>(), std::make_shared<QEulerNumber>()};
+
+    WHEN("The quads attributes of both trees are computed") {
+      auto attrs = AttributeComputerQuads<unsigned char>(QTreeType::MaxTree, QConnectivity::Eight, comps).compute(ct);
+      auto attrs64 = AttributeComputerQuads<unsigned char, CTree<unsigned char, long long>>(QTreeType::MaxTree, 
+        QConnectivity::Eight, comps).compute(ct64);
+      THEN("The counts and the integer attributes should be 64-bit integers with the same values") {
+        for (auto type : {AttrType::QUADS_Q1, AttrType::QUADS_Q4, AttrType::QUADS_AREA, AttrType::QUADS_PERIMETER, 
+          AttrType::QUADS_EULER_NUMBER}) {
+          REQUIRE(attrs.valueType(attrs.attrIndex(type)) == AttrValueType::Int32);
+          REQUIRE(attrs64.valueType(attrs64.attrIndex(type)) == AttrValueType::Int64);
+          REQUIRE(attrs[attrs.attrIndex(type)] == attrs64[attrs64.attrIndex(type)]);
+        }
+        REQUIRE(attrs64.valueType(attrs64.attrIndex(AttrType::QUADS_CONTINUOUS_AREA)) == AttrValueType::Float);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::QUADS_CONTINUOUS_AREA)] == 
+          attrs64[attrs64.attrIndex(AttrType::QUADS_CONTINUOUS_AREA)]);
+      }
+    }
+  }
+}
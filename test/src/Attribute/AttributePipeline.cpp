@@ -0,0 +1,121 @@
+#include "../../catch.hpp"
+#include "../ComponentTree/CTreeCompare.hpp"
+#include <pomar/Attribute/AttributePipeline.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/Attribute/AttributeComputerQuads.hpp>
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <numeric>
+#include <algorithm>
+
+using namespace pomar;
+
+SCENARIO("AttributePipeline should compute attributes in order.") {
+  GIVEN("A component tree 'ct' and an area attribute computer.") {
+    std::vector<unsigned char> elements = { 2,0,3,2,1,3,7,0,3 };
+    std::vector<int> parent = { 4,1,4,0,1,2,0,1,2 };
+    std::vector<int> sortedIndices(elements.size());
+    std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+    std::sort(sortedIndices.begin(), sortedIndices.end(), [&elements](int i1, int i2) { 
+      return elements[i1] < elements[i2]; });
+
+    CTree<unsigned char> ct(std::make_shared<CTMeta>(), parent, sortedIndices, elements);
+    WHEN("an attribute pipeline with the area attribute computer computes the attributes of 'ct'") {
+      auto pipeline = makeAttributePipeline(AreaAttributeComputer<unsigned char>());
+      auto attrs = pipeline.compute(ct);
+      THEN("attrs should contain the area of each node at the first position") {
+        REQUIRE(attrs.attrIndex(AttrType::AREA) == 0);
+        REQUIRE(attrs[0] == std::vector<double>{9.0, 7.0, 3.0, 3.0, 1.0});
+      }
+    }
+  }
+}
+
+SCENARIO("AttributePipeline should compute the same attributes as IncrementalAttributeComputerCollection.") {
+  GIVEN("The max-tree of a random image and area and quads attribute computers") {
+    const int width = 31, height = 17;
+    auto f = randomImage<unsigned char>(width, height, 15, 11);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder builder;
+    auto ct = builder.build(meta, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    std::vector<std::shared_ptr<AttributeFromQuadsComputer>> qattrs = {std::make_shared<QArea>(), 
+      std::make_shared<QPerimeter>(), std::make_shared<QEulerNumber>()};
+
+    AreaAttributeComputer<unsigned char> area;
+    AttributeComputerQuads<unsigned char> quads{QTreeType::MaxTree, QConnectivity::Eight, qattrs};
+    IncrementalAttributeComputerCollection<unsigned char> collection;
+    collection.push(area.toIncrementalAttributeComputer());
+    collection.push(quads.toIncrementalAttributeComputer());
+    auto expected = collection.compute(ct);
+
+    WHEN("an attribute pipeline computes the attributes of the CTree") {
+      auto attrs = makeAttributePipeline(area, quads).compute(ct);
+      THEN("All attributes should be the same") {
+        for (auto type : {AttrType::AREA, AttrType::QUADS_AREA, AttrType::QUADS_PERIMETER, 
+          AttrType::QUADS_EULER_NUMBER}) {
+          REQUIRE(attrs.attrIndex(type) == expected.attrIndex(type));
+          REQUIRE(attrs[attrs.attrIndex(type)] == expected[expected.attrIndex(type)]);
+        }
+      }
+    }
+
+    WHEN("an attribute pipeline computes the attributes of the CompactCTree") {
+      CompactCTree<unsigned char> cct(ct);
+      AttributePipeline<AreaAttributeComputer<unsigned char, CompactCTree<unsigned char>>, 
+        AttributeComputerQuads<unsigned char, CompactCTree<unsigned char>>> pipeline{
+          AreaAttributeComputer<unsigned char, CompactCTree<unsigned char>>(), 
+          AttributeComputerQuads<unsigned char, CompactCTree<unsigned char>>{QTreeType::MaxTree, 
+            QConnectivity::Eight, qattrs}};
+      auto attrs = pipeline.compute(cct);
+      THEN("All attributes should be the same") {
+        for (auto type : {AttrType::AREA, AttrType::QUADS_AREA, AttrType::QUADS_PERIMETER, 
+          AttrType::QUADS_EULER_NUMBER}) {
+          REQUIRE(attrs[attrs.attrIndex(type)] == expected[expected.attrIndex(type)]);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Parallel attribute computation should give the same attributes as the sequential one.") {
+  GIVEN("The max-tree and the compact max-tree of a random image and area and quads attribute computers") {
+    const int width = 211, height = 157;
+    auto f = randomImage<unsigned char>(width, height, 63, 5);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder builder;
+    auto ct = builder.build(meta, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    CompactCTree<unsigned char> cct(ct);
+    std::vector<std::shared_ptr<AttributeFromQuadsComputer>> qattrs = {std::make_shared<QArea>(), 
+      std::make_shared<QCArea>(), std::make_shared<QPerimeter>(), std::make_shared<QEulerNumber>()};
+    std::vector<AttrType> types = {AttrType::AREA, AttrType::QUADS_Q1, AttrType::QUADS_Q2, AttrType::QUADS_Q3, 
+      AttrType::QUADS_Q4, AttrType::QUADS_QD, AttrType::QUADS_AREA, AttrType::QUADS_CONTINUOUS_AREA, 
+      AttrType::QUADS_PERIMETER, AttrType::QUADS_EULER_NUMBER};
+
+    AreaAttributeComputer<unsigned char> area;
+    AttributeComputerQuads<unsigned char> quads{QTreeType::MaxTree, QConnectivity::Eight, qattrs};
+    IncrementalAttributeComputerCollection<unsigned char> collection;
+    collection.push(area.toIncrementalAttributeComputer());
+    collection.push(quads.toIncrementalAttributeComputer());
+    auto expected = collection.compute(ct);
+
+    WHEN("the attributes are computed with 2 to 8 threads") {
+      THEN("The collection and the pipelines of both trees should compute the same attributes") {
+        auto pipeline = makeAttributePipeline(area, quads);
+        auto cpipeline = makeAttributePipeline(AreaAttributeComputer<unsigned char, CompactCTree<unsigned char>>(),
+          AttributeComputerQuads<unsigned char, CompactCTree<unsigned char>>{QTreeType::MaxTree, 
+            QConnectivity::Eight, qattrs});
+        for (int nthreads : {2, 3, 4, 8}) {
+          auto attrs = collection.compute(ct, nthreads);
+          auto pattrs = pipeline.compute(ct, nthreads);
+          auto cattrs = cpipeline.compute(cct, nthreads);
+          for (auto type : types) {
+            REQUIRE(attrs[attrs.attrIndex(type)] == expected[expected.attrIndex(type)]);
+            REQUIRE(pattrs[pattrs.attrIndex(type)] == expected[expected.attrIndex(type)]);
+            REQUIRE(cattrs[cattrs.attrIndex(type)] == expected[expected.attrIndex(type)]);
+          }
+        }
+      }
+    }
+  }
+}
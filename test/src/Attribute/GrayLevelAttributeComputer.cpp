@@ -0,0 +1,99 @@
+#include "../../catch.hpp"
+#include "../ComponentTree/CTreeCompare.hpp"
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/Attribute/AttributeComputerGrayLevel.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("GrayLevelAttributeComputer should compute the gray-level attributes of a small max-tree.") {
+  GIVEN("The max-tree of the 7x1 image (0 2 1 2 0 3 0)") {
+    std::vector<unsigned char> f = { 0, 2, 1, 2, 0, 3, 0 };
+    CTBuilder builder;
+    auto ct = builder.build(std::make_shared<CTMetaImage2D>(7, 1, 1), f,
+      AdjacencyByTranslating2D::createAdjacency4(7, 1), CTBuilder::TreeType::MaxTree);
+
+    WHEN("the gray-level attributes are computed") {
+      auto attrs = GrayLevelAttributeComputer<unsigned char>().compute(ct);
+      int root = ct.nodeByElement(0), plateau = ct.nodeByElement(2), peak = ct.nodeByElement(5);
+      THEN("the root has the levels of the whole image") {
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MIN_LEVEL)][root] == 0.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MAX_LEVEL)][root] == 3.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::HEIGHT)][root] == 3.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::VOLUME)][root] == 8.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MEAN_LEVEL)][root] == Approx(8.0 / 7.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::LEVEL_VARIANCE)][root] == Approx(18.0 / 7.0 - 64.0 / 49.0));
+      }
+      THEN("the node (2 1 2) has height 1 and volume 2 and the peak has height 0") {
+        REQUIRE(attrs[attrs.attrIndex(AttrType::HEIGHT)][plateau] == 1.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::VOLUME)][plateau] == 2.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MEAN_LEVEL)][plateau] == Approx(5.0 / 3.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::HEIGHT)][peak] == 0.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::VOLUME)][peak] == 0.0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::LEVEL_VARIANCE)][peak] == 0.0);
+      }
+    }
+
+    WHEN("the area extinction values are computed") {
+      auto areas = AreaAttributeComputer<unsigned char>().compute(ct);
+      auto ext = extinctionValues(ct, areas[areas.attrIndex(AttrType::AREA)]);
+      THEN("one maximum of the largest branch survives up to the root area and the others die at area 1") {
+        std::vector<double> leaves = { ext[ct.nodeByElement(1)], ext[ct.nodeByElement(3)], 
+          ext[ct.nodeByElement(5)] };
+        std::sort(leaves.begin(), leaves.end());
+        REQUIRE(leaves == std::vector<double>{1.0, 1.0, 7.0});
+        REQUIRE(ext[ct.nodeByElement(5)] == 1.0);
+        REQUIRE(ext[ct.nodeByElement(2)] == 7.0);
+        REQUIRE(ext[0] == 7.0);
+      }
+    }
+  }
+}
+
+SCENARIO("GrayLevelAttributeComputer should match the attributes computed from the reconstructed nodes.") {
+  GIVEN("The max-tree and the min-tree of a random 11x8 image") {
+    const int width = 11, height = 8;
+    auto f = randomImage<unsigned char>(width, height, 9, 3);
+
+    for (auto treeType : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+      CTBuilder builder;
+      auto ct = builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+        AdjacencyByTranslating2D::createAdjacency8(width, height), treeType);
+      CompactCTree<unsigned char> cct(ct);
+
+      auto attrs = GrayLevelAttributeComputer<unsigned char>().compute(ct);
+      auto compact = GrayLevelAttributeComputer<unsigned char, CompactCTree<unsigned char>>().compute(cct, 2);
+      for (std::size_t id = 0; id < ct.numberOfNodes(); ++id) {
+        auto pixels = ct.reconstructNode(id);
+        double level = ct.nodeLevel(id), minLevel = 255, maxLevel = 0, volume = 0, sum = 0;
+        for (auto p : pixels) {
+          minLevel = std::min<double>(minLevel, f[p]);
+          maxLevel = std::max<double>(maxLevel, f[p]);
+          volume += std::abs(f[p] - level);
+          sum += f[p];
+        }
+        double mean = sum / pixels.size(), variance = 0;
+        for (auto p : pixels)
+          variance += (f[p] - mean) * (f[p] - mean);
+        variance /= pixels.size();
+
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MIN_LEVEL)][id] == minLevel);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MAX_LEVEL)][id] == maxLevel);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::HEIGHT)][id] == maxLevel - minLevel);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::VOLUME)][id] == volume);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::MEAN_LEVEL)][id] == Approx(mean));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::LEVEL_VARIANCE)][id] == Approx(variance).margin(1e-9));
+      }
+      for (std::size_t i = 0; i < attrs.numberOfAttributes(); ++i)
+        REQUIRE(attrs[i] == compact[i]);
+
+      auto ext = extinctionValues(cct, attrs[attrs.attrIndex(AttrType::HEIGHT)]);
+      REQUIRE(ext[0] == attrs[attrs.attrIndex(AttrType::HEIGHT)][0]);
+    }
+  }
+}
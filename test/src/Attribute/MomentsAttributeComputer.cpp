@@ -0,0 +1,159 @@
+#include "../../catch.hpp"
+#include "../ComponentTree/CTreeCompare.hpp"
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/Attribute/AttributeComputerMoments.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/Attribute/AttributePipeline.hpp>
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <cmath>
+#include <memory>
+
+using namespace pomar;
+
+namespace
+{
+  /* Max-tree of a 'width' x 'height' image whose pixels are 0, but the ones of the rectangle
+     [x0, x1] x [y0, y1], which are 1. */
+  CTree<unsigned char> rectangleMaxTree(int width, int height, int x0, int y0, int x1, int y1)
+  {
+    std::vector<unsigned char> f(width * height, 0);
+    for (int y = y0; y <= y1; ++y)
+      for (int x = x0; x <= x1; ++x)
+        f[y * width + x] = 1;
+    CTBuilder builder;
+    return builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+      AdjacencyByTranslating2D::createAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+  }
+}
+
+SCENARIO("Moments attribute computers should compute the bounding box and moments of a rectangle.") {
+  GIVEN("The max-tree of a 7x5 image with a 4x2 rectangle from (1 1) to (4 2)") {
+    auto ct = rectangleMaxTree(7, 5, 1, 1, 4, 2);
+    REQUIRE(ct.numberOfNodes() == 2);
+
+    WHEN("the bounding box is computed") {
+      auto attrs = BoundingBoxAttributeComputer<unsigned char>().compute(ct);
+      THEN("the bounding box of the rectangle node is (1 1)-(4 2) and the root's is the whole image") {
+        REQUIRE(attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_X))[1] == 1);
+        REQUIRE(attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_Y))[1] == 1);
+        REQUIRE(attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_X))[1] == 4);
+        REQUIRE(attrs.column<std::int32_t>(attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_Y))[1] == 2);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_X)][0] == 0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_Y)][0] == 0);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_X)][0] == 6);
+        REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_Y)][0] == 4);
+      }
+    }
+
+    WHEN("the central moments are computed") {
+      auto attrs = CentralMomentsAttributeComputer<unsigned char>().compute(ct);
+      THEN("the centroid is (2.5 1.5) and the moments are the ones of the rectangle") {
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_X)][1] == Approx(2.5));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_Y)][1] == Approx(1.5));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_20)][1] == Approx(10.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_02)][1] == Approx(2.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_11)][1] == Approx(0.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::ECCENTRICITY)][1] == Approx(std::sqrt(0.8)));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::ORIENTATION)][1] == Approx(0.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_X)][0] == Approx(3.0));
+        REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_Y)][0] == Approx(2.0));
+      }
+    }
+
+    WHEN("the Hu moments of the rectangle and of its transpose are computed") {
+      auto hu = HuMomentsAttributeComputer<unsigned char>().compute(ct);
+      auto ctT = rectangleMaxTree(5, 7, 1, 1, 2, 4);
+      auto huT = HuMomentsAttributeComputer<unsigned char>().compute(ctT);
+      auto orientT = CentralMomentsAttributeComputer<unsigned char>().compute(ctT);
+      THEN("the first Hu moment is (mu20 + mu02) / n^2 and all Hu moments are the same") {
+        REQUIRE(hu[hu.attrIndex(AttrType::HU_MOMENT_1)][1] == Approx(12.0 / 64.0));
+        REQUIRE(hu[hu.attrIndex(AttrType::HU_MOMENT_2)][1] == Approx(64.0 / 4096.0));
+        for (int i = 0; i < 7; ++i) {
+          auto type = static_cast<AttrType>(static_cast<int>(AttrType::HU_MOMENT_1) + i);
+          REQUIRE(hu[hu.attrIndex(type)][1] == Approx(huT[huT.attrIndex(type)][1]));
+        }
+        REQUIRE(orientT[orientT.attrIndex(AttrType::ORIENTATION)][1] == Approx(std::acos(-1.0) / 2));
+      }
+    }
+  }
+}
+
+SCENARIO("Moments attribute computers should match the moments computed from the reconstructed nodes.") {
+  GIVEN("The min-tree of a random 13x9 image") {
+    const int width = 13, height = 9;
+    auto f = randomImage<unsigned char>(width, height, 5, 11);
+    CTBuilder builder;
+    auto ct = builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+      AdjacencyByTranslating2D::createAdjacency4(width, height), CTBuilder::TreeType::MinTree);
+
+    WHEN("the bounding box and the central moments are computed in a pipeline") {
+      auto pipeline = makeAttributePipeline(BoundingBoxAttributeComputer<unsigned char>(),
+        CentralMomentsAttributeComputer<unsigned char>(), HuMomentsAttributeComputer<unsigned char>());
+      auto attrs = pipeline.compute(ct);
+      auto par = pipeline.compute(ct, 3);
+      THEN("they should be the ones computed directly from the pixels of each node") {
+        for (std::size_t id = 0; id < ct.numberOfNodes(); ++id) {
+          auto pixels = ct.reconstructNode(id);
+          double n = pixels.size(), sx = 0, sy = 0;
+          int xmin = width, ymin = height, xmax = -1, ymax = -1;
+          for (auto p : pixels) {
+            int x = p % width, y = p / width;
+            sx += x; sy += y;
+            xmin = std::min(xmin, x); ymin = std::min(ymin, y);
+            xmax = std::max(xmax, x); ymax = std::max(ymax, y);
+          }
+          double cx = sx / n, cy = sy / n, mu20 = 0, mu02 = 0, mu11 = 0;
+          for (auto p : pixels) {
+            double dx = p % width - cx, dy = p / width - cy;
+            mu20 += dx*dx; mu02 += dy*dy; mu11 += dx*dy;
+          }
+          REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_X)][id] == xmin);
+          REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MIN_Y)][id] == ymin);
+          REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_X)][id] == xmax);
+          REQUIRE(attrs[attrs.attrIndex(AttrType::BOUNDING_BOX_MAX_Y)][id] == ymax);
+          REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_X)][id] == Approx(cx));
+          REQUIRE(attrs[attrs.attrIndex(AttrType::CENTROID_Y)][id] == Approx(cy));
+          REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_20)][id] == Approx(mu20).margin(1e-9));
+          REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_02)][id] == Approx(mu02).margin(1e-9));
+          REQUIRE(attrs[attrs.attrIndex(AttrType::CENTRAL_MOMENT_11)][id] == Approx(mu11).margin(1e-9));
+          REQUIRE(attrs[attrs.attrIndex(AttrType::HU_MOMENT_1)][id] == Approx((mu20 + mu02) / (n*n)).margin(1e-12));
+        }
+        for (std::size_t i = 0; i < attrs.numberOfAttributes(); ++i)
+          REQUIRE(attrs[i] == par[i]);
+      }
+    }
+  }
+}
+
+SCENARIO("Moments attribute computers should require the component tree of a 2D image.") {
+  GIVEN("A component tree without image meta-information") {
+    std::vector<unsigned char> elements = { 0, 1 };
+    CTree<unsigned char> ct(std::make_shared<CTMeta>(), std::vector<int>{0, 0}, std::vector<int>{0, 1}, elements);
+    THEN("the computers should throw std::invalid_argument") {
+      REQUIRE_THROWS_AS(BoundingBoxAttributeComputer<unsigned char>().compute(ct), std::invalid_argument);
+      REQUIRE_THROWS_AS(CentralMomentsAttributeComputer<unsigned char>().compute(ct), std::invalid_argument);
+      REQUIRE_THROWS_AS(HuMomentsAttributeComputer<unsigned char>().compute(ct), std::invalid_argument);
+    }
+  }
+}
+
+SCENARIO("Moment sums should only be accumulated for images where they are exact in 64-bit integers.") {
+  GIVEN("The limits of the second and third-order sums") {
+    THEN("checkMomentSumsRange should accept the images below them and reject the ones above") {
+      REQUIRE_NOTHROW(checkMomentSumsRange(9000, 9000, 3));
+      REQUIRE_THROWS_AS(checkMomentSumsRange(10000, 10000, 3), std::invalid_argument);
+      REQUIRE_NOTHROW(checkMomentSumsRange(10000, 10000, 2));
+      REQUIRE_NOTHROW(checkMomentSumsRange(70000, 70000, 2));
+      REQUIRE_THROWS_AS(checkMomentSumsRange(80000, 80000, 2), std::invalid_argument);
+    }
+  }
+  GIVEN("A component tree whose meta-information is a 10000x10000 image") {
+    std::vector<unsigned char> elements = { 0, 1 };
+    CTree<unsigned char> ct(std::make_shared<CTMetaImage2D>(10000, 10000, 1), std::vector<int>{0, 0}, 
+      std::vector<int>{0, 1}, elements);
+    THEN("the Hu moments should throw std::invalid_argument and the central moments should be computed") {
+      REQUIRE_THROWS_AS(HuMomentsAttributeComputer<unsigned char>().compute(ct), std::invalid_argument);
+      REQUIRE_NOTHROW(CentralMomentsAttributeComputer<unsigned char>().compute(ct));
+    }
+  }
+}
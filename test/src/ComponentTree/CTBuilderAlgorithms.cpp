@@ -0,0 +1,192 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("Union by rank builder should build the same tree as the union-find builder.") {
+  GIVEN("A random 8-bit image, a ramp image and a builder using union by rank.") {
+    int width = 41, height = 29;
+    auto noise = randomImage<unsigned char>(width, height, 15, 3);
+    std::vector<unsigned short> ramp(width * height);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = i / 3;
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder unionFind(CTBuilder::Algorithm::UnionFind);
+    CTBuilder unionByRank(CTBuilder::Algorithm::UnionByRank);
+
+    WHEN("The max-tree and min-tree of the random image are built.") {
+      THEN("They should be equal to the ones built by the union-find builder.") {
+        for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+          auto expected = unionFind.build(meta, noise, AdjacencyByTranslating2D::createAdjacency8(width, height), type);
+          auto ct = unionByRank.build(meta, noise, AdjacencyByTranslating2D::createAdjacency8(width, height), type);
+          REQUIRE(sameTree(ct, expected));
+        }
+      }
+    }
+    WHEN("The max-tree of the ramp image is built.") {
+      auto expected = unionFind.build(meta, ramp, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      auto ct = unionByRank.build(meta, ramp, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      THEN("It should be equal to the one built by the union-find builder.") {
+        REQUIRE(sameTree(ct, expected));
+      }
+    }
+    WHEN("The max-tree of the random image is built by union by rank with 4 threads.") {
+      auto expected = unionFind.build(meta, noise, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      auto ct = CTBuilder(CTBuilder::Algorithm::UnionByRank, 4).build(meta, noise, 
+        AdjacencyByTranslating2D::createAdjacency4(width, height), CTBuilder::TreeType::MaxTree);
+      THEN("It should be equal to the one built sequentially by the union-find builder.") {
+        REQUIRE(sameTree(ct, expected));
+      }
+    }
+  }
+}
+
+SCENARIO("Hierarchical queue builder should build the same tree as the union-find builder.") {
+  GIVEN("Random 8-bit and 12-bit images and a builder using a hierarchical queue.") {
+    int width = 33, height = 47;
+    auto f8 = randomImage<unsigned char>(width, height, 255, 4);
+    auto f8few = randomImage<unsigned char>(width, height, 3, 5);
+    auto f12 = randomImage<unsigned short>(width, height, 4095, 6);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder unionFind;
+    CTBuilder flooding(CTBuilder::Algorithm::HierarchicalQueue);
+
+    WHEN("The max-trees and min-trees are built with 4 and 8-connectivity.") {
+      THEN("They should be equal to the ones built by the union-find builder.") {
+        for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+          REQUIRE(sameTree(flooding.build(meta, f8, AdjacencyByTranslating2D::createAdjacency8(width, height), type),
+            unionFind.build(meta, f8, AdjacencyByTranslating2D::createAdjacency8(width, height), type)));
+          REQUIRE(sameTree(flooding.build(meta, f8few, AdjacencyByTranslating2D::createAdjacency4(width, height), type),
+            unionFind.build(meta, f8few, AdjacencyByTranslating2D::createAdjacency4(width, height), type)));
+          REQUIRE(sameTree(flooding.build(meta, f12, AdjacencyByTranslating2D::createAdjacency4(width, height), type),
+            unionFind.build(meta, f12, AdjacencyByTranslating2D::createAdjacency4(width, height), type)));
+        }
+      }
+    }
+  }
+  GIVEN("A flat image and a float image.") {
+    int width = 5, height = 4;
+    std::vector<unsigned char> flat(width * height, 7);
+    std::vector<float> ffloat = {0.5f,1.5f,0.5f,2.5f,0.f, 3.f,3.f,1.f,0.5f,2.f, 1.f,1.f,1.f,0.f,0.f, 2.f,2.f,0.5f,0.f,3.f};
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder flooding(CTBuilder::Algorithm::HierarchicalQueue);
+
+    WHEN("The max-tree of the flat image is built.") {
+      auto ct = flooding.build(meta, flat, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      THEN("It should have a single node with all elements.") {
+        REQUIRE(ct.numberOfNodes() == 1);
+        REQUIRE(ct.nodeElementIndices(0).size() == flat.size());
+      }
+    }
+    WHEN("The max-tree of the float image is built.") {
+      auto ct = flooding.build(meta, ffloat, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      THEN("It should be built by union by rank and equal to the union-find max-tree.") {
+        REQUIRE(sameTree(ct, CTBuilder().build(meta, ffloat, AdjacencyByTranslating2D::createAdjacency4(width, height), 
+          CTBuilder::TreeType::MaxTree)));
+      }
+    }
+  }
+  GIVEN("An empty image.") {
+    std::vector<unsigned char> empty;
+    auto meta = std::make_shared<CTMetaImage2D>(0, 0, 1);
+    CTBuilder flooding(CTBuilder::Algorithm::HierarchicalQueue);
+
+    WHEN("Its max-tree and min-tree are built.") {
+      THEN("They should have no nodes as the union-find trees.") {
+        for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+          auto ct = flooding.build(meta, empty, AdjacencyByTranslating2D::createAdjacency4(0, 0), type);
+          REQUIRE(ct.numberOfNodes() == 0);
+          REQUIRE(sameTree(ct, CTBuilder().build(meta, empty, AdjacencyByTranslating2D::createAdjacency4(0, 0), type)));
+          REQUIRE(flooding.buildCompact(meta, empty, AdjacencyByTranslating2D::createAdjacency4(0, 0), type)
+            .numberOfNodes() == 0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Builders using a grid adjacency should build the same tree as the ones using an Adjacency.") {
+  GIVEN("A random 8-bit image and a random float image.") {
+    int width = 37, height = 31;
+    std::vector<IPoint2D> cross{{-1,0}, {0,-1}, {1,0}, {0,1}};
+    auto f8 = randomImage<unsigned char>(width, height, 31, 8);
+    auto ffloat = randomImage<float>(width, height, 63, 9);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder unionFind;
+
+    WHEN("The trees are built by each algorithm using GridAdjacency4, GridAdjacency8 and AdjacencyByTranslating2D by value.") {
+      THEN("They should be equal to the ones built using AdjacencyByTranslating2D.") {
+        for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+                               CTBuilder::Algorithm::HierarchicalQueue}) {
+          for (int nthreads : {1, 3}) {
+            CTBuilder builder(algorithm, nthreads);
+            for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+              REQUIRE(sameTree(builder.build(meta, f8, GridAdjacency4(width, height), type),
+                unionFind.build(meta, f8, AdjacencyByTranslating2D::createAdjacency4(width, height), type)));
+              REQUIRE(sameTree(builder.build(meta, f8, GridAdjacency8(width, height), type),
+                unionFind.build(meta, f8, AdjacencyByTranslating2D::createAdjacency8(width, height), type)));
+              REQUIRE(sameTree(builder.build(meta, ffloat, GridAdjacency8(width, height), type),
+                unionFind.build(meta, ffloat, AdjacencyByTranslating2D::createAdjacency8(width, height), type)));
+              REQUIRE(sameTree(builder.build(meta, f8, AdjacencyByTranslating2D(width, height, cross), type),
+                unionFind.build(meta, f8, AdjacencyByTranslating2D::createAdjacency4(width, height), type)));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Builders using 16 and 64-bit indices should build the same tree as the ones using int indices.") {
+  GIVEN("A random 8-bit image, a random float image and a 3D volume.") {
+    int width = 43, height = 27, depth = 5;
+    auto f8 = randomImage<unsigned char>(width, height, 31, 12);
+    auto ffloat = randomImage<float>(width, height, 63, 13);
+    auto fvol = randomImage<unsigned char>(width, height * depth, 7, 14);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    auto meta3D = std::make_shared<CTMetaImage3D>(width, height, depth, 1);
+
+    WHEN("The trees are built by each algorithm with short and long long indices.") {
+      THEN("They should be equal to the ones built with int indices.") {
+        for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+                               CTBuilder::Algorithm::HierarchicalQueue}) {
+          for (int nthreads : {1, 3}) {
+            CTBuilder builder(algorithm, nthreads);
+            for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+              auto expected = builder.build(meta, f8, GridAdjacency8(width, height), type);
+              REQUIRE(sameTree(builder.build<short>(meta, f8, GridAdjacency8(width, height), type), expected));
+              REQUIRE(sameTree(builder.build<long long>(meta, f8, GridAdjacency8(width, height), type), expected));
+              REQUIRE(sameTree(builder.build<long long>(meta, ffloat, GridAdjacency4(width, height), type),
+                builder.build(meta, ffloat, GridAdjacency4(width, height), type)));
+              REQUIRE(sameTree(builder.build<long long>(meta3D, fvol, GridAdjacency26(width, height, depth), type),
+                builder.build(meta3D, fvol, GridAdjacency26(width, height, depth), type)));
+
+              auto compact = builder.buildCompact<long long>(meta, f8, GridAdjacency8(width, height), type);
+              REQUIRE(compact.numberOfNodes() == expected.numberOfNodes());
+              for (size_t i = 0; i < expected.numberOfNodes(); ++i) {
+                REQUIRE(compact.nodeParent(i) == expected.nodeParent(i));
+                REQUIRE(sameIndices(compact.nodeElementIndices(i), expected.nodeElementIndices(i)));
+              }
+            }
+          }
+        }
+      }
+    }
+
+    WHEN("An image with more elements than a short can index is built with short indices.") {
+      std::vector<unsigned char> f(200 * 200, 0);
+      auto bigMeta = std::make_shared<CTMetaImage2D>(200, 200, 1);
+      THEN("The builder should throw std::invalid_argument.") {
+        REQUIRE_THROWS_AS(CTBuilder().build<short>(bigMeta, f, GridAdjacency4(200, 200), CTBuilder::TreeType::MaxTree),
+          std::invalid_argument);
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("CTBuilder should build the same tree with the tree type and the sort as template parameters.") {
+  GIVEN("A random 8-bit image of size 29x31 with few gray levels.") {
+    int width = 29, height = 31;
+    auto f = randomImage<unsigned char>(width, height, 9, 5);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency8 adj(width, height);
+
+    for (auto algorithm : {CTBuilder::Algorithm::UnionByRank, CTBuilder::Algorithm::HierarchicalQueue}) {
+      for (int nthreads : {1, 3}) {
+        CTBuilder builder(algorithm, nthreads);
+        auto maxTree = builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree);
+        auto minTree = builder.build(meta, f, adj, CTBuilder::TreeType::MinTree);
+        WHEN("The trees are built with the default sort using " + std::to_string(nthreads) + " threads.") {
+          THEN("They should be equal to the trees built with a TreeType argument.") {
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MaxTree>(meta, f, adj), maxTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MinTree>(meta, f, adj), minTree));
+          }
+        }
+        WHEN("The trees are built with counting sort and radix sort and comparison sort.") {
+          THEN("They should be equal to the trees built with a TreeType argument.") {
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MaxTree, CountingSortTag>(meta, f, adj), maxTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MinTree, CountingSortTag>(meta, f, adj), minTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MaxTree, RadixSortTag>(meta, f, adj), maxTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MinTree, RadixSortTag>(meta, f, adj), minTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MaxTree, ComparisonSortTag>(meta, f, adj), maxTree));
+            REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MinTree, ComparisonSortTag>(meta, f, adj), minTree));
+          }
+        }
+        WHEN("The compact trees are built with 16-bit indices.") {
+          auto expected = builder.buildCompact<short>(meta, f, adj, CTBuilder::TreeType::MinTree);
+          auto ct = builder.buildCompact<CTBuilder::TreeType::MinTree, RadixSortTag, short>(meta, f, adj);
+          THEN("They should be equal to the compact trees built with a TreeType argument.") {
+            REQUIRE(sameTree(ct, expected));
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A random double image of size 33x20 with repeated values.") {
+    int width = 33, height = 20;
+    auto g = randomImage<int>(width, height, 12, 6);
+    std::vector<double> f(g.begin(), g.end());
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency4 adj(width, height);
+    CTBuilder builder;
+    WHEN("The trees are built with radix sort and comparison sort.") {
+      THEN("They should be equal to the trees built with a TreeType argument.") {
+        auto maxTree = builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree);
+        auto minTree = builder.build(meta, f, adj, CTBuilder::TreeType::MinTree);
+        REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MaxTree, RadixSortTag>(meta, f, adj), maxTree));
+        REQUIRE(sameTree(builder.build<CTBuilder::TreeType::MinTree, ComparisonSortTag>(meta, f, adj), minTree));
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+#include "../../catch.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CTBuilderWorkspace.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <random>
+
+using namespace pomar;
+
+namespace
+{
+  template<class T, class IndexT>
+  void requireSameCompactTree(const CompactCTree<T, IndexT> &expected, const CompactCTree<T, IndexT> &tree)
+  {
+    REQUIRE(tree.numberOfNodes() == expected.numberOfNodes());
+    REQUIRE(tree.numberOfElements() == expected.numberOfElements());
+    for (IndexT i = 0; i < static_cast<IndexT>(expected.numberOfNodes()); i++) {
+      REQUIRE(tree.nodeLevel(i) == expected.nodeLevel(i));
+      REQUIRE(tree.nodeParent(i) == expected.nodeParent(i));
+      REQUIRE(tree.nodeChildren(i).toVector() == expected.nodeChildren(i).toVector());
+      REQUIRE(tree.nodeElementIndices(i).toVector() == expected.nodeElementIndices(i).toVector());
+    }
+    REQUIRE(tree.convertToVector() == expected.convertToVector());
+  }
+
+  template<class T>
+  std::vector<T> randomFrame(int width, int height, int maxValue, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, maxValue);
+    std::vector<T> f(width * height);
+    for (auto &v : f) v = static_cast<T>(dist(gen));
+    return f;
+  }
+}
+
+SCENARIO("CTBuilder should build the same trees with a reused workspace.") {
+  GIVEN("A sequence of random frames of the same size and of different sizes") {
+    std::vector<std::pair<int, int>> sizes = {{31, 17}, {31, 17}, {31, 17}, {8, 40}, {50, 3}, {31, 17}};
+
+    for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+      CTBuilder::Algorithm::HierarchicalQueue}) {
+      for (auto treeType : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+        CTBuilder builder(algorithm);
+        CTBuilderWorkspace<unsigned char> workspace;
+        CompactCTree<unsigned char> tree;
+        CTBuilderWorkspace<float> fworkspace;
+        CompactCTree<float> ftree;
+        unsigned seed = 1;
+        for (const auto &size : sizes) {
+          auto meta = std::make_shared<CTMetaImage2D>(size.first, size.second, 1);
+          GridAdjacency8 adj(size.first, size.second);
+
+          auto f = randomFrame<unsigned char>(size.first, size.second, 20, seed++);
+          builder.buildCompact(meta, f, adj, treeType, workspace, tree);
+          requireSameCompactTree(builder.buildCompact(meta, f, adj, treeType), tree);
+          REQUIRE(tree.convertToVector() == f);
+
+          auto ff = randomFrame<float>(size.first, size.second, 1000, seed++);
+          builder.buildCompact(meta, ff, adj, treeType, fworkspace, ftree);
+          requireSameCompactTree(builder.buildCompact(meta, ff, adj, treeType), ftree);
+        }
+        REQUIRE(workspace.memoryUsage() > 0);
+        workspace.clear();
+        REQUIRE(workspace.memoryUsage() == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("CTBuilder should reuse the arrays of the workspace and of the tree.") {
+  GIVEN("A workspace and a tree used to build a frame") {
+    const int width = 64, height = 48;
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency4 adj(width, height);
+    CTBuilder builder;
+    CTBuilderWorkspace<unsigned short> workspace;
+    CompactCTree<unsigned short> tree;
+    builder.buildCompact(meta, randomFrame<unsigned short>(width, height, 3, 1), adj, 
+      CTBuilder::TreeType::MaxTree, workspace, tree);
+
+    WHEN("another frame of the same size with fewer nodes is built") {
+      auto memory = workspace.memoryUsage();
+      const int *elements = tree.nodeElementIndices(0).begin();
+      builder.buildCompact(meta, randomFrame<unsigned short>(width, height, 1, 2), adj, 
+        CTBuilder::TreeType::MaxTree, workspace, tree);
+      THEN("the workspace should not grow and the tree should keep its element array") {
+        REQUIRE(workspace.memoryUsage() == memory);
+        REQUIRE(tree.nodeElementIndices(0).begin() == elements);
+        REQUIRE(tree.numberOfElements() == static_cast<size_t>(width * height));
+      }
+    }
+  }
+
+  GIVEN("A builder which floods the frames with a workspace") {
+    const int width = 64, height = 48;
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency4 adj(width, height);
+    CTBuilder builder(CTBuilder::Algorithm::HierarchicalQueue);
+    CTBuilderWorkspace<unsigned short> workspace;
+    CompactCTree<unsigned short> tree;
+    builder.buildCompact(meta, randomFrame<unsigned short>(width, height, 300, 1), adj, 
+      CTBuilder::TreeType::MinTree, workspace, tree);
+
+    WHEN("another frame of the same size with fewer levels is built") {
+      auto memory = workspace.memoryUsage();
+      auto f = randomFrame<unsigned short>(width, height, 100, 2);
+      builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MinTree, workspace, tree);
+      THEN("the workspace should not grow and the tree should be the flooded one") {
+        REQUIRE(workspace.memoryUsage() == memory);
+        requireSameCompactTree(builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MinTree), tree);
+      }
+    }
+  }
+}
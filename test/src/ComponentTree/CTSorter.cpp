@@ -43,4 +43,30 @@ SCENARIO("mintree sorter should sort in decreasing order.") {
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("dualTreeSort should reverse a tree order keeping the order of equal elements.") {
+  GIVEN("An unsigned char vector with values (2,5,3,0,2,3,0,3).") {
+    std::vector<unsigned char> v = {2,5,3,0,2,3,0,3};
+    WHEN("dualTreeSort is called with the max-tree order.") {
+      auto idx = dualTreeSort(v, maxTreeSort(v));
+      THEN("The result should be the min-tree order (1,2,5,7,0,4,3,6).") {
+        REQUIRE(idx == minTreeSort(v));
+      }
+    }
+    WHEN("dualTreeSort is called with the min-tree order.") {
+      auto idx = dualTreeSort(v, minTreeSort(v));
+      THEN("The result should be the max-tree order (3,6,0,4,2,5,7,1).") {
+        REQUIRE(idx == maxTreeSort(v));
+      }
+    }
+  }
+  GIVEN("A float vector with -0.0 and 0.0.") {
+    std::vector<float> v = {0.5f, -0.0f, 0.0f, -1.0f, 0.5f, 0.0f, -0.0f};
+    WHEN("dualTreeSort is called with the max-tree order.") {
+      auto idx = dualTreeSort(v, maxTreeSort(v));
+      THEN("The result should be the min-tree order.") {
+        REQUIRE(idx == minTreeSort(v));
+      }
+    }
+  }
+}
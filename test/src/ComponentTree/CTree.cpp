@@ -149,3 +149,42 @@ SCENARIO("The Component class Should run the algorithms correctly") {
     }
   }
 }
+
+SCENARIO("CTree should reconstruct and prune the nodes of very deep trees.") {
+  GIVEN("A chain of 10^6 nodes (element i has level i and its parent is the element i-1)") {
+    const int n = 1000000;
+    std::vector<int> elements(n), parent(n), sortedIndices(n);
+    std::iota(elements.begin(), elements.end(), 0);
+    std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+    for (int i = 0; i < n; ++i)
+      parent[i] = i == 0 ? 0 : i - 1;
+
+    CTree<int> tree(std::make_shared<CTMeta>(), parent, sortedIndices, elements);
+    REQUIRE(tree.numberOfNodes() == static_cast<size_t>(n));
+
+    WHEN("the nodes are reconstructed") {
+      THEN("the root should contain every element and the node i the elements from i to n-1") {
+        auto rec = tree.reconstructNode(0);
+        REQUIRE(rec.size() == static_cast<size_t>(n));
+        std::sort(rec.begin(), rec.end());
+        REQUIRE(rec == elements);
+        REQUIRE(tree.reconstructNode(n / 2).size() == static_cast<size_t>(n - n / 2));
+        REQUIRE(tree.reconstructNode(n - 1) == std::vector<int>{n - 1});
+      }
+    }
+
+    WHEN("the nodes with level greater or equal to n/2 are pruned") {
+      tree.prune([n](const CTNode<int>& node) { return node.level() >= n / 2; });
+      THEN("the last kept node should contain the elements of the pruned nodes") {
+        REQUIRE(tree.numberOfNodes() == static_cast<size_t>(n / 2));
+        REQUIRE(tree.nodeElementIndices(n / 2 - 1).size() == static_cast<size_t>(n - n / 2 + 1));
+        REQUIRE(tree.nodeChildren(n / 2 - 1).empty());
+        REQUIRE(tree.nodeByElement(n - 1) == n / 2 - 1);
+        REQUIRE(tree.reconstructNode(0).size() == static_cast<size_t>(n));
+        auto v = tree.convertToVector();
+        REQUIRE(v[n / 2 - 1] == n / 2 - 1);
+        REQUIRE(v[n - 1] == n / 2 - 1);
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#include <pomar/ComponentTree/CTree.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#ifndef TEST_CTREE_COMPARE_HPP_INCLUDED
+#define TEST_CTREE_COMPARE_HPP_INCLUDED
+
+/* Helpers shared by the component tree builder tests. */
+
+/* Check whether two ranges of indices (of possibly different types) are equal. */
+template<class R1, class R2>
+bool sameIndices(const R1 &r1, const R2 &r2)
+{
+  return r1.size() == r2.size() && std::equal(r1.begin(), r1.end(), r2.begin());
+}
+
+/* 
+ * Check whether two component trees (of possibly different index types) have the same nodes 
+ * (id, level, parent, children and elements). */
+template<class T, class I1, class I2>
+bool sameTree(const pomar::CTree<T, I1> &t1, const pomar::CTree<T, I2> &t2)
+{
+  if (t1.numberOfNodes() != t2.numberOfNodes())
+    return false;
+
+  for (size_t i = 0; i < t1.numberOfNodes(); ++i) {
+    if (t1.nodeLevel(i) != t2.nodeLevel(i) || t1.nodeParent(i) != t2.nodeParent(i) ||
+        !sameIndices(t1.nodeChildren(i), t2.nodeChildren(i)) || 
+        !sameIndices(t1.nodeElementIndices(i), t2.nodeElementIndices(i)))
+      return false;
+  }
+  return true;
+}
+
+/* Check whether two compact component trees have the same nodes. */
+template<class T, class I1, class I2>
+bool sameTree(const pomar::CompactCTree<T, I1> &t1, const pomar::CompactCTree<T, I2> &t2)
+{
+  if (t1.numberOfNodes() != t2.numberOfNodes())
+    return false;
+
+  for (size_t i = 0; i < t1.numberOfNodes(); ++i) {
+    if (t1.nodeLevel(i) != t2.nodeLevel(i) || t1.nodeParent(i) != t2.nodeParent(i) ||
+        !sameIndices(t1.nodeChildren(i), t2.nodeChildren(i)) || 
+        !sameIndices(t1.nodeElementIndices(i), t2.nodeElementIndices(i)))
+      return false;
+  }
+  return true;
+}
+
+/* Random image with values in [0, maxValue]. */
+template<class T>
+std::vector<T> randomImage(int width, int height, int maxValue, unsigned seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(0, maxValue);
+  std::vector<T> f(width * height);
+  for (auto &v : f)
+    v = static_cast<T>(dist(gen));
+  return f;
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include "../../catch.hpp"
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/Attribute/AttributeComputerQuads.hpp>
+#include <numeric>
+#include <algorithm>
+#include <random>
+
+using namespace pomar;
+
+template<class T>
+void requireSameTree(const CTree<T> &tree, const CompactCTree<T> &ctree)
+{
+  REQUIRE(ctree.numberOfNodes() == tree.numberOfNodes());
+  for (size_t i = 0; i < tree.numberOfNodes(); i++) {
+    REQUIRE(ctree.nodeLevel(i) == tree.nodeLevel(i));
+    REQUIRE(ctree.nodeParent(i) == tree.nodeParent(i));
+    REQUIRE(ctree.nodeChildren(i).toVector() == tree.nodeChildren(i));
+    REQUIRE(ctree.nodeElementIndices(i).toVector() == tree.nodeElementIndices(i));
+  }
+  auto f = tree.convertToVector();
+  for (size_t p = 0; p < f.size(); p++)
+    REQUIRE(ctree.nodeByElement(p) == tree.nodeByElement(p));
+  REQUIRE(ctree.convertToVector() == f);
+}
+
+SCENARIO("Compact component tree initialize correctly") {
+  GIVEN("An parent vector with 5 nodes generated by a set of vertices and by a order (increase)") {
+    std::vector<unsigned char> elements {
+        2,0,3,
+        2,1,3,
+        7,0,3
+    };
+
+    std::vector<int> parent {
+        4,1,4,
+        0,1,2,
+        0,1,2
+    };
+
+    std::vector<int> sortedIndices(elements.size());
+    std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+    std::sort(sortedIndices.begin(), sortedIndices.end(), [&elements](int i1, int i2) { return elements[i1] < elements[i2]; });
+    auto meta = std::make_shared<CTMeta>();
+
+    WHEN("A compact component tree is initialized") {
+      CompactCTree<unsigned char> ctree(meta, parent, sortedIndices, elements);
+
+      THEN("it should contains 5 nodes") {
+        REQUIRE(ctree.numberOfNodes() == 5);
+      }
+      THEN("It should return children equals to ({1},{2,3},{4},{},{}) for the nodes (0,1,2,3,4)") {
+        REQUIRE(ctree.nodeChildren(0).toVector() == std::vector<int>({1}));
+        REQUIRE(ctree.nodeChildren(1).toVector() == std::vector<int>({2,3}));
+        REQUIRE(ctree.nodeChildren(2).toVector() == std::vector<int>({4}));
+        REQUIRE(ctree.nodeChildren(3).empty());
+        REQUIRE(ctree.nodeChildren(4).empty());
+      }
+      THEN("it should navigate the nodes in the following (level, number of CNPs) order: (7,1), (3,3), (2,2), (1,1), (0,2)") {
+        std::vector<int> levels {7,3,2,1,0};
+        std::vector<size_t> nCNPs {1,3,2,1,2};
+        int i = 0;
+        ctree.transverse([&levels, &nCNPs, &i](const CompactCTNode<unsigned char> &node) {
+          REQUIRE(levels[i] == node.level());
+          REQUIRE(nCNPs[i++] == node.elementIndices().size());
+        });
+      }
+      THEN("It should be the same tree as the CTree built from the same arrays") {
+        CTree<unsigned char> tree(meta, parent, sortedIndices, elements);
+        requireSameTree(tree, ctree);
+        for (size_t i = 0; i < tree.numberOfNodes(); i++)
+          REQUIRE(ctree.reconstructNode(i) == tree.reconstructNode(i));
+        requireSameTree(tree, CompactCTree<unsigned char>(tree));
+      }
+    }
+  }
+}
+
+SCENARIO("CTBuilder buildCompact should build the same tree as build") {
+  GIVEN("A random image with few levels") {
+    int width = 23, height = 17;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 5);
+    std::vector<unsigned char> f(width * height);
+    for (auto &v : f)
+      v = static_cast<unsigned char>(dist(gen));
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+
+    WHEN("the max-tree and the min-tree are built by each algorithm") {
+      THEN("the compact trees should be equal to the trees") {
+        std::vector<CTBuilder::Algorithm> algorithms { CTBuilder::Algorithm::UnionFind,
+          CTBuilder::Algorithm::UnionByRank, CTBuilder::Algorithm::HierarchicalQueue };
+        for (auto algorithm : algorithms) {
+          for (int nthreads : {1, 3}) {
+            CTBuilder builder(algorithm, nthreads);
+            for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+              auto tree = builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height), type);
+              auto ctree = builder.buildCompact(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height), type);
+              requireSameTree(tree, ctree);
+              requireSameTree(tree, builder.buildCompact(meta, f, GridAdjacency8(width, height), type));
+            }
+          }
+        }
+      }
+    }
+
+    WHEN("the area and the quads are computed on both trees") {
+      CTBuilder builder;
+      auto tree = builder.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height), 
+        CTBuilder::TreeType::MaxTree);
+      auto ctree = builder.buildCompact(meta, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+
+      THEN("the attributes should be equal") {
+        AreaAttributeComputer<unsigned char> area;
+        AreaAttributeComputer<unsigned char, UCCompactCTree> carea;
+        REQUIRE(carea.compute(ctree)[0] == area.compute(tree)[0]);
+
+        AttributeComputerQuads<unsigned char> quads{QTreeType::MaxTree, QConnectivity::Eight, "../../resource/pomar"};
+        AttributeComputerQuads<unsigned char, UCCompactCTree> cquads{QTreeType::MaxTree, QConnectivity::Eight, 
+          "../../resource/pomar"};
+        auto attrs = quads.compute(tree);
+        auto cattrs = cquads.compute(ctree);
+        for (auto type : {AttrType::QUADS_Q1, AttrType::QUADS_Q2, AttrType::QUADS_Q3, AttrType::QUADS_Q4, AttrType::QUADS_QD})
+          REQUIRE(cattrs[cattrs.attrIndex(type)] == attrs[attrs.attrIndex(type)]);
+      }
+    }
+  }
+}
+
+SCENARIO("Component trees should reconstruct their image into a caller buffer.") {
+  GIVEN("The max-tree (CTree and CompactCTree) of a random 37x23 image") {
+    const int width = 37, height = 23;
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<int> dist(0, 15);
+    std::vector<unsigned char> f(width * height);
+    for (auto &v : f) v = static_cast<unsigned char>(dist(gen));
+    CTBuilder builder;
+    auto tree = builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+      AdjacencyByTranslating2D::createAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    CompactCTree<unsigned char> ctree(tree);
+
+    WHEN("the image is written into a buffer with 1 and 3 threads") {
+      THEN("the buffer should be the input image") {
+        for (int nthreads : {1, 3}) {
+          std::vector<unsigned char> out(f.size());
+          tree.convertTo(out.data(), nthreads);
+          REQUIRE(out == f);
+          std::fill(out.begin(), out.end(), 0);
+          ctree.convertTo(out.data(), nthreads);
+          REQUIRE(out == f);
+        }
+      }
+    }
+    WHEN("the image is written into a region of a larger buffer") {
+      const int stride = width + 5;
+      THEN("the region should be the input image and the rest of the buffer untouched") {
+        for (int nthreads : {1, 4}) {
+          std::vector<unsigned char> out(stride * (height + 1), 255), ctreeOut(out);
+          tree.convertToRows(out.data() + stride + 2, stride, nthreads);
+          ctree.convertToRows(ctreeOut.data() + stride + 2, stride, nthreads);
+          REQUIRE(ctreeOut == out);
+          for (int y = 0; y < height + 1; ++y) {
+            for (int x = 0; x < stride; ++x) {
+              bool inside = y >= 1 && x >= 2 && x < width + 2;
+              REQUIRE(out[y * stride + x] == (inside ? f[(y - 1) * width + x - 2] : 255));
+            }
+          }
+        }
+      }
+    }
+    WHEN("the tree has no 2D image meta-information") {
+      std::vector<int> parent(f.size()), sortedIndices(f.size());
+      std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
+      CTree<unsigned char> noImage(std::make_shared<CTMeta>(), parent, sortedIndices, 
+        std::vector<unsigned char>(f.size(), 0));
+      THEN("convertToRows should throw std::invalid_argument") {
+        std::vector<unsigned char> out(f.size());
+        REQUIRE_THROWS_AS(noImage.convertToRows(out.data(), width), std::invalid_argument);
+      }
+    }
+  }
+}
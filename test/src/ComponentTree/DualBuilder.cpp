@@ -0,0 +1,57 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("CTBuilder should build the max-tree and the min-tree from a single sort.") {
+  GIVEN("A random 8-bit image of size 37x23 with few gray levels.") {
+    int width = 37, height = 23;
+    auto f = randomImage<unsigned char>(width, height, 7, 3);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency8 adj(width, height);
+
+    for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+      CTBuilder::Algorithm::HierarchicalQueue}) {
+      for (int nthreads : {1, 2, 5}) {
+        CTBuilder builder(algorithm, nthreads);
+        WHEN("Both trees are built with " + std::to_string(nthreads) + " threads.") {
+          auto trees = builder.buildDual(meta, f, adj);
+          THEN("They should be equal to the max-tree and the min-tree built separately.") {
+            REQUIRE(sameTree(trees.maxTree, builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree)));
+            REQUIRE(sameTree(trees.minTree, builder.build(meta, f, adj, CTBuilder::TreeType::MinTree)));
+          }
+        }
+        WHEN("Both compact trees are built with " + std::to_string(nthreads) + " threads.") {
+          auto trees = builder.buildCompactDual(meta, f, adj);
+          THEN("They should be equal to the compact trees built separately.") {
+            REQUIRE(sameTree(trees.maxTree, builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MaxTree)));
+            REQUIRE(sameTree(trees.minTree, builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MinTree)));
+          }
+        }
+      }
+    }
+  }
+  GIVEN("A random float image of size 40x30 with repeated values.") {
+    int width = 40, height = 30;
+    auto g = randomImage<int>(width, height, 20, 4);
+    std::vector<float> f(g.begin(), g.end());
+    for (auto &v : f) v = (v - 10.0f) / 4.0f;
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    std::shared_ptr<Adjacency> adj = AdjacencyByTranslating2D::createAdjacency4(width, height);
+
+    for (int nthreads : {1, 4}) {
+      CTBuilder builder(nthreads);
+      WHEN("Both trees are built with a dynamic adjacency and " + std::to_string(nthreads) + " threads.") {
+        auto trees = builder.buildDual(meta, f, adj);
+        THEN("They should be equal to the max-tree and the min-tree built separately.") {
+          REQUIRE(sameTree(trees.maxTree, builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree)));
+          REQUIRE(sameTree(trees.minTree, builder.build(meta, f, adj, CTBuilder::TreeType::MinTree)));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/Core/ImageView.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+using namespace pomar;
+
+namespace
+{
+  /* Copy the tight image 'f' into rows of 'rowStride' values whose padding is filled with 'pad'. */
+  template<class T>
+  std::vector<T> padRows(const std::vector<T> &f, int width, int height, int rowStride, T pad)
+  {
+    std::vector<T> buffer(rowStride * height, pad);
+    for (int y = 0; y < height; y++)
+      std::copy(f.begin() + y * width, f.begin() + (y + 1) * width, buffer.begin() + y * rowStride);
+    return buffer;
+  }
+}
+
+SCENARIO("ImageView2D should index the pixels of an image with padded rows as a tight image.") {
+  GIVEN("A 3x2 image stored in rows of 5 values.") {
+    std::vector<int> buffer = {1, 2, 3, -1, -1, 4, 5, 6, -1, -1};
+    ImageView2D<int> view(buffer.data(), 3, 2, 5);
+    THEN("The elements and the pixels should skip the padding.") {
+      REQUIRE(view.size() == 6);
+      REQUIRE(!view.isContiguous());
+      for (int i = 0; i < 6; i++)
+        REQUIRE(view[i] == i + 1);
+      REQUIRE(view(2, 1) == 6);
+      REQUIRE(view.row(1)[0] == 4);
+    }
+    THEN("A row stride smaller than the width should throw std::invalid_argument.") {
+      REQUIRE_THROWS_AS(ImageView2D<int>(buffer.data(), 3, 2, 2), std::invalid_argument);
+    }
+    THEN("The sort of the view should be the sort of the tight image.") {
+      std::vector<int> idx;
+      SortBuffers<int, int> buffers;
+      sortIndexInto(view, true, idx, buffers);
+      REQUIRE(idx == decreasingSortIndex(std::vector<int>({1, 2, 3, 4, 5, 6})));
+    }
+  }
+}
+
+SCENARIO("ImageView2D should locate the elements of padded rows without division.") {
+  GIVEN("Views of up to 2^31 pixels of different widths") {
+    THEN("The offset of each element should be its row times the row stride plus its column.") {
+      for (long long width : {1LL, 2LL, 3LL, 7LL, 640LL, 641LL, 1920LL, 4097LL, 65537LL, 1000003LL, 2147483647LL}) {
+        long long height = ((1LL << 31) - 1) / width, stride = width + 3, n = width * height;
+        ImageView2D<unsigned char> view(nullptr, static_cast<int>(width), static_cast<int>(height), stride);
+        std::vector<long long> indices = {0, width - 1, n - width, std::max(0LL, n - width - 1), n - 1};
+        if (height > 1) indices.push_back(width);
+        for (long long k = 1; k < 1000; k++)
+          indices.push_back((k * 2654435761LL) % n);
+        for (auto i : indices)
+          REQUIRE(view.offset(i) == (i / width) * stride + i % width);
+      }
+    }
+  }
+  GIVEN("A random image of size 500x400 stored in rows of 509 values") {
+    int width = 500, height = 400, rowStride = 509;
+    auto f = randomImage<unsigned char>(width, height, 255, 3);
+    auto buffer = padRows<unsigned char>(f, width, height, rowStride, 0);
+    ImageView2D<unsigned char> view(buffer.data(), width, height, rowStride);
+    std::vector<float> ff(f.begin(), f.end());
+    auto fbuffer = padRows<float>(ff, width, height, rowStride, 0.0f);
+    ImageView2D<float> fview(fbuffer.data(), width, height, rowStride);
+
+    THEN("forEachElement should visit the elements of a range in order") {
+      std::vector<unsigned char> visited;
+      forEachElement(view, 499, 1501, [&](std::size_t i, unsigned char value) { 
+        REQUIRE(i == 499 + visited.size());
+        visited.push_back(value); 
+      });
+      REQUIRE(visited == std::vector<unsigned char>(f.begin() + 499, f.begin() + 1501));
+    }
+    THEN("The sorts of the view with 1 and 3 threads should be the sorts of the tight image") {
+      for (int nthreads : {1, 3}) {
+        REQUIRE(TreeSorter<false>::sort(view, nthreads) == maxTreeSort(f));
+        REQUIRE(TreeSorter<true>::sort(view, nthreads) == minTreeSort(f));
+        REQUIRE(TreeSorter<false>::sort(fview, nthreads) == maxTreeSort(ff));
+        REQUIRE(TreeSorter<true>::sort(fview, nthreads) == minTreeSort(ff));
+      }
+    }
+  }
+}
+
+SCENARIO("CTBuilder should build the same tree from an image view as from a tight copy of the image.") {
+  GIVEN("A random 8-bit image of size 37x23 stored in rows of 40 values.") {
+    int width = 37, height = 23, rowStride = 40;
+    auto f = randomImage<unsigned char>(width, height, 9, 7);
+    auto buffer = padRows<unsigned char>(f, width, height, rowStride, 255);
+    ImageView2D<unsigned char> view(buffer.data(), width, height, rowStride);
+    auto meta = std::make_shared<CTMetaImage2D>(view);
+    GridAdjacency8 adj(width, height);
+
+    for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+      CTBuilder::Algorithm::HierarchicalQueue}) {
+      for (int nthreads : {1, 3}) {
+        CTBuilder builder(algorithm, nthreads);
+        WHEN("The trees are built from the view with " + std::to_string(nthreads) + " threads.") {
+          THEN("They should be equal to the trees of the tight image.") {
+            for (auto treeType : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+              REQUIRE(sameTree(builder.build(meta, view, adj, treeType), builder.build(meta, f, adj, treeType)));
+              REQUIRE(sameTree(builder.buildCompact(meta, view, adj, treeType), 
+                builder.buildCompact(meta, f, adj, treeType)));
+            }
+          }
+        }
+      }
+    }
+
+    WHEN("The compact trees are built from the view with a workspace.") {
+      CTBuilder builder;
+      CTBuilderWorkspace<unsigned char> ws;
+      CompactCTree<unsigned char> tree;
+      builder.buildCompact(meta, view, adj, CTBuilder::TreeType::MinTree, ws, tree);
+      THEN("They should be equal to the compact trees of the tight image.") {
+        REQUIRE(sameTree(tree, builder.buildCompact(meta, f, adj, CTBuilder::TreeType::MinTree)));
+        REQUIRE(tree.convertToVector() == f);
+      }
+    }
+  }
+  GIVEN("A random float image of size 30x20 stored in rows of 32 values.") {
+    int width = 30, height = 20, rowStride = 32;
+    auto g = randomImage<int>(width, height, 15, 8);
+    std::vector<float> f(g.begin(), g.end());
+    auto buffer = padRows<float>(f, width, height, rowStride, -1.0f);
+    ImageView2D<float> view(buffer.data(), width, height, rowStride);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    GridAdjacency4 adj(width, height);
+    CTBuilder builder(2);
+    WHEN("The max-tree is built from the view.") {
+      auto ct = builder.build(meta, view, adj, CTBuilder::TreeType::MaxTree);
+      THEN("It should be equal to the max-tree of the tight image.") {
+        REQUIRE(sameTree(ct, builder.build(meta, f, adj, CTBuilder::TreeType::MaxTree)));
+        REQUIRE(ct.convertToVector() == f);
+      }
+    }
+  }
+}
@@ -0,0 +1,91 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("Parallel component tree builder should build the same tree as the sequential builder.") {
+  GIVEN("A random 8-bit image of size 37x23 with few gray levels.") {
+    int width = 37, height = 23;
+    auto f = randomImage<unsigned char>(width, height, 7, 1);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    CTBuilder sequential;
+
+    for (int nthreads : {2, 3, 4, 8, 64}) {
+      CTBuilder parallel(nthreads);
+      WHEN("The max-tree is built with 8-connectivity using " + std::to_string(nthreads) + " threads.") {
+        auto expected = sequential.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height),
+          CTBuilder::TreeType::MaxTree);
+        auto ct = parallel.build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height),
+          CTBuilder::TreeType::MaxTree);
+        THEN("It should be equal to the sequential max-tree.") {
+          REQUIRE(sameTree(ct, expected));
+        }
+      }
+      WHEN("The min-tree is built with 4-connectivity using " + std::to_string(nthreads) + " threads.") {
+        auto expected = sequential.build(meta, f, AdjacencyByTranslating2D::createAdjacency4(width, height),
+          CTBuilder::TreeType::MinTree);
+        auto ct = parallel.build(meta, f, AdjacencyByTranslating2D::createAdjacency4(width, height),
+          CTBuilder::TreeType::MinTree);
+        THEN("It should be equal to the sequential min-tree.") {
+          REQUIRE(sameTree(ct, expected));
+        }
+      }
+    }
+  }
+  GIVEN("A random 16-bit image of size 64x64 without meta information about its grid.") {
+    int width = 64, height = 64;
+    auto f = randomImage<unsigned short>(width, height, 65535, 2);
+    auto meta = std::make_shared<CTMeta>();
+    WHEN("The max-tree is built with 5 threads.") {
+      auto expected = CTBuilder().build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height),
+        CTBuilder::TreeType::MaxTree);
+      auto ct = CTBuilder(5).build(meta, f, AdjacencyByTranslating2D::createAdjacency8(width, height),
+        CTBuilder::TreeType::MaxTree);
+      THEN("It should be equal to the sequential max-tree.") {
+        REQUIRE(sameTree(ct, expected));
+      }
+    }
+  }
+}
+
+namespace
+{
+  /* Adjacency relation of a user which does not implement clone(). */
+  class NonCloneableAdjacency : public Adjacency
+  {
+  public:
+    NonCloneableAdjacency(int width, int height)
+      :_adj{AdjacencyByTranslating2D::createAdjacency4(width, height)}
+    {}
+
+    const std::vector<int>& neighbours(int id) { return _adj->neighbours(id); }
+
+  private:
+    std::unique_ptr<Adjacency> _adj;
+  };
+}
+
+SCENARIO("Component tree builder should accept adjacency relations which do not implement clone.") {
+  GIVEN("A random 8-bit image of size 20x10 and an adjacency relation without clone.") {
+    int width = 20, height = 10;
+    auto f = randomImage<unsigned char>(width, height, 15, 3);
+    auto meta = std::make_shared<CTMetaImage2D>(width, height, 1);
+    auto adj = std::make_shared<NonCloneableAdjacency>(width, height);
+    WHEN("The max-tree is built with one thread.") {
+      auto ct = CTBuilder().build(meta, f, adj, CTBuilder::TreeType::MaxTree);
+      THEN("It should be equal to the tree built with a cloneable adjacency relation.") {
+        REQUIRE(sameTree(ct, CTBuilder().build(meta, f, AdjacencyByTranslating2D::createAdjacency4(width, height),
+          CTBuilder::TreeType::MaxTree)));
+        REQUIRE(CTBuilder().buildDual(meta, f, adj).minTree.numberOfNodes() > 0);
+      }
+    }
+    WHEN("The max-tree is built with several threads.") {
+      THEN("The builder should throw std::logic_error.") {
+        REQUIRE_THROWS_AS(CTBuilder(2).build(meta, f, adj, CTBuilder::TreeType::MaxTree), std::logic_error);
+      }
+    }
+  }
+}
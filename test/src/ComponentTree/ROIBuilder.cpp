@@ -0,0 +1,90 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/Core/ImageView.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <memory>
+#include <stdexcept>
+
+using namespace pomar;
+
+namespace
+{
+  /* Copy the ROI of size width x height at (x, y) of the image 'f' of width 'imageWidth'. */
+  template<class T>
+  std::vector<T> crop(const std::vector<T> &f, int imageWidth, int x, int y, int width, int height)
+  {
+    std::vector<T> g;
+    for (int j = y; j < y + height; j++)
+      g.insert(g.end(), f.begin() + j * imageWidth + x, f.begin() + j * imageWidth + x + width);
+    return g;
+  }
+}
+
+SCENARIO("CTBuilder should build the component tree of a region of interest without cropping.") {
+  GIVEN("A random 8-bit image of size 60x50 and a ROI of size 20x15 at (7, 5).") {
+    int imageWidth = 60, imageHeight = 50, x = 7, y = 5, width = 20, height = 15;
+    auto f = randomImage<unsigned char>(imageWidth, imageHeight, 12, 9);
+    ImageView2D<unsigned char> image(f.data(), imageWidth, imageHeight);
+    auto g = crop(f, imageWidth, x, y, width, height);
+    auto cropMeta = std::make_shared<CTMetaImage2D>(width, height, 1);
+
+    for (int nthreads : {1, 2}) {
+      CTBuilder builder(nthreads);
+      WHEN("The trees of the ROI are built with " + std::to_string(nthreads) + " threads.") {
+        auto maxTree = builder.buildROI<GridAdjacency8>(image, x, y, width, height, CTBuilder::TreeType::MaxTree);
+        auto minTree = builder.buildCompactROI<GridAdjacency4>(image, x, y, width, height, CTBuilder::TreeType::MinTree);
+        THEN("They should be equal to the trees of the cropped image.") {
+          REQUIRE(sameTree(maxTree, builder.build(cropMeta, g, GridAdjacency8(width, height), 
+            CTBuilder::TreeType::MaxTree)));
+          REQUIRE(sameTree(minTree, builder.buildCompact(cropMeta, g, GridAdjacency4(width, height), 
+            CTBuilder::TreeType::MinTree)));
+        }
+        THEN("The meta-information should map the local element indices to the global ones.") {
+          auto meta = std::dynamic_pointer_cast<CTMetaImageROI2D>(maxTree.meta());
+          REQUIRE(meta);
+          REQUIRE(meta->width() == width);
+          REQUIRE(meta->height() == height);
+          for (size_t id = 0; id < maxTree.numberOfNodes(); id++) {
+            for (auto p : maxTree.nodeElementIndices(id)) {
+              auto gp = meta->globalIndex(p);
+              REQUIRE(f[gp] == maxTree.nodeLevel(id));
+              REQUIRE(meta->localIndex(gp) == p);
+            }
+          }
+          REQUIRE(meta->localIndex(0) == -1);
+          REQUIRE(meta->localIndex((y + height) * imageWidth + x) == -1);
+        }
+        THEN("The trees should give the global element indices of their nodes and the node of a global index.") {
+          for (size_t id = 0; id < minTree.numberOfNodes(); id++) {
+            auto global = minTree.nodeGlobalElementIndices(id);
+            REQUIRE(global.size() == minTree.nodeElementIndices(id).size());
+            for (auto gp : global) {
+              REQUIRE(f[gp] == minTree.nodeLevel(id));
+              REQUIRE(minTree.nodeByGlobalElement(gp) == static_cast<int>(id));
+            }
+          }
+          auto root = maxTree.nodeGlobalElementIndices(0);
+          REQUIRE(maxTree.nodeByGlobalElement(root.front()) == 0);
+          REQUIRE(maxTree.nodeByGlobalElement(0) == -1);
+          REQUIRE(minTree.nodeByGlobalElement(y * imageWidth + x + width) == -1);
+          REQUIRE(minTree.nodeByGlobalElement(-1) == -1);
+
+          auto tree = builder.build(cropMeta, g, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+          REQUIRE(tree.nodeByGlobalElement(5) == tree.nodeByElement(5));
+          REQUIRE(tree.nodeByGlobalElement(width * height) == -1);
+          REQUIRE(tree.nodeGlobalElementIndices(0).size() == tree.nodeElementIndices(0).size());
+        }
+      }
+    }
+  }
+  GIVEN("A ROI which is not inside the image.") {
+    std::vector<float> f(30 * 20, 0.0f);
+    ImageView2D<float> image(f.data(), 30, 20);
+    THEN("The builder should throw std::invalid_argument.") {
+      REQUIRE_THROWS_AS(CTBuilder().buildROI<GridAdjacency8>(image, 25, 0, 10, 5, CTBuilder::TreeType::MaxTree),
+        std::invalid_argument);
+      REQUIRE_THROWS_AS(CTMetaImageROI2D(30, 20, 0, -1, 5, 5), std::invalid_argument);
+    }
+  }
+}
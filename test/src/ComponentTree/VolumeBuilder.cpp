@@ -0,0 +1,69 @@
+#include "../../catch.hpp"
+#include "CTreeCompare.hpp"
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/AdjacencyRelation/GridAdjacency.hpp>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("Component tree builder should build component trees of volumes.") {
+  GIVEN("A volume of size (3,1,2) whose two bright voxels are one above the other.") {
+    // slice 0: 0 5 0, slice 1: 0 5 2 
+    std::vector<unsigned char> f = {0, 5, 0, 0, 5, 2};
+    auto meta = std::make_shared<CTMetaImage3D>(3, 1, 2, 1);
+    CTBuilder builder;
+
+    WHEN("The max-tree is built with 6-connectivity.") {
+      auto ct = builder.build(meta, f, AdjacencyByTranslating3D::createAdjacency6(3, 1, 2), 
+        CTBuilder::TreeType::MaxTree);
+      THEN("The two bright voxels should be in the same node.") {
+        REQUIRE(ct.numberOfNodes() == 3);
+        REQUIRE(ct.nodeByElement(1) == ct.nodeByElement(4));
+        REQUIRE(ct.nodeElementIndices(ct.nodeByElement(1)) == std::vector<int>({1, 4}));
+        REQUIRE(ct.nodeParent(ct.nodeByElement(1)) == ct.nodeByElement(5));
+      }
+    }
+  }
+  GIVEN("A random volume of depth 1.") {
+    int width = 23, height = 17;
+    auto f = randomImage<unsigned char>(width, height, 20, 12);
+    auto meta2D = std::make_shared<CTMetaImage2D>(width, height, 1);
+    auto meta3D = std::make_shared<CTMetaImage3D>(width, height, 1, 1);
+    CTBuilder builder;
+
+    WHEN("Its max-tree is built with 6 and 18-connectivity.") {
+      THEN("They should be equal to the max-trees of the image with 4 and 8-connectivity.") {
+        REQUIRE(sameTree(builder.build(meta3D, f, GridAdjacency6(width, height, 1), CTBuilder::TreeType::MaxTree),
+          builder.build(meta2D, f, GridAdjacency4(width, height), CTBuilder::TreeType::MaxTree)));
+        REQUIRE(sameTree(builder.build(meta3D, f, GridAdjacency18(width, height, 1), CTBuilder::TreeType::MaxTree),
+          builder.build(meta2D, f, GridAdjacency8(width, height), CTBuilder::TreeType::MaxTree)));
+      }
+    }
+  }
+  GIVEN("A random 8-bit volume of size (13,11,9).") {
+    int width = 13, height = 11, depth = 9;
+    auto f = randomImage<unsigned char>(width * height, depth, 40, 13);
+    auto meta = std::make_shared<CTMetaImage3D>(width, height, depth, 1);
+    CTBuilder unionFind;
+
+    WHEN("Its max-tree and min-tree are built by each algorithm, sequentially and in parallel.") {
+      THEN("They should be equal to the ones built by the sequential union-find.") {
+        for (auto algorithm : {CTBuilder::Algorithm::UnionFind, CTBuilder::Algorithm::UnionByRank, 
+                               CTBuilder::Algorithm::HierarchicalQueue}) {
+          for (int nthreads : {1, 4}) {
+            CTBuilder builder(algorithm, nthreads);
+            for (auto type : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+              auto expected = unionFind.build(meta, f, AdjacencyByTranslating3D::createAdjacency26(width, height, depth), type);
+              REQUIRE(sameTree(builder.build(meta, f, GridAdjacency26(width, height, depth), type), expected));
+              REQUIRE(sameTree(builder.build(meta, f, 
+                AdjacencyByTranslating3D::createAdjacency26(width, height, depth), type), expected));
+              REQUIRE(sameTree(builder.build(meta, f, GridAdjacency6(width, height, depth), type),
+                unionFind.build(meta, f, AdjacencyByTranslating3D::createAdjacency6(width, height, depth), type)));
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#include "../../catch.hpp"
+#include <pomar/Core/Parallel.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace pomar;
+
+SCENARIO("parallelFor should run every task in the threads of a reused pool.") {
+  GIVEN("The shared thread pool") {
+    WHEN("parallelFor is called several times with 4 tasks") {
+      std::vector<int> runs(4, 0);
+      for (int i = 0; i < 10; i++)
+        parallelFor(4, [&](int t) { runs[t]++; });
+      auto nworkers = ThreadPool::shared().numberOfWorkers();
+      parallelFor(4, [&](int t) { runs[t]++; });
+      THEN("Each task should run once per call and the pool should not grow") {
+        REQUIRE(runs == std::vector<int>(4, 11));
+        REQUIRE(nworkers >= 3);
+        REQUIRE(ThreadPool::shared().numberOfWorkers() == nworkers);
+      }
+    }
+    WHEN("The tasks call parallelFor") {
+      std::atomic<int> count(0);
+      parallelFor(3, [&](int) { parallelFor(5, [&](int) { count++; }); });
+      THEN("All the nested tasks should run") {
+        REQUIRE(count.load() == 15);
+      }
+    }
+    WHEN("A task throws an exception") {
+      THEN("parallelFor should rethrow it after the other tasks have finished") {
+        std::atomic<int> count(0);
+        REQUIRE_THROWS_AS(parallelFor(6, [&](int t) { 
+          count++; 
+          if (t == 2) throw std::runtime_error("task failed"); 
+        }), std::runtime_error);
+        REQUIRE(count.load() == 6);
+      }
+    }
+  }
+}
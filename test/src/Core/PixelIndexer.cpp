@@ -130,4 +130,40 @@ SCENARIO("Each sub-class of Pixel Indexer should compute a pixel index correctly
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("Each sub-class of Voxel Indexer should compute a voxel index correctly") {
+  GIVEN("VoxelIndexerNearestBorder and VoxelIndexerDefaultValue instances for a volume of size (4,3,2)") {
+    std::unique_ptr<VoxelIndexer> nearest{new VoxelIndexerNearestBorder{4,3,2}};
+    std::unique_ptr<VoxelIndexer> defaultValue{new VoxelIndexerDefaultValue{4,3,2}};
+    WHEN("index method is called with the point (1,2,1)") {
+      THEN("It should return 21") {
+        REQUIRE(nearest->index(IPoint3D(1,2,1)) == 21);
+        REQUIRE(defaultValue->index(1,2,1) == 21);
+      }
+    }
+    WHEN("index method is called with the point (5,-1,3)") {
+      THEN("It should return 15 (nearest border) and -1 (default value)") {
+        REQUIRE(nearest->index(5,-1,3) == 15);
+        REQUIRE(defaultValue->index(5,-1,3) == -1);
+      }
+    }
+    WHEN("voxel method is called with the index 21") {
+      THEN("It should return the point (1,2,1)") {
+        REQUIRE(nearest->voxel(21) == IPoint3D(1,2,1));
+      }
+    }
+  }
+}
+
+SCENARIO("Pixel indexers should compute the pixel of an index of a non-square image") {
+  GIVEN("PixelIndexerNearestBorder and PixelIndexerDefaultValue instances for an image of size (4,2)") {
+    std::unique_ptr<PixelIndexer> nearestBorder{new PixelIndexerNearestBorder{4,2}};
+    std::unique_ptr<PixelIndexer> defaultValue{new PixelIndexerDefaultValue{4,2}};
+    WHEN("pixel method is called with value 6") {
+      THEN("It should return the point 2,1") { 
+        REQUIRE(nearestBorder->pixel(6) == IPoint2D(2,1)); 
+        REQUIRE(defaultValue->pixel(6) == IPoint2D(2,1));
+      }
+    }
+  }
+}
@@ -1,6 +1,10 @@
 #include "../../catch.hpp"
 #include <pomar/Core/Sort.hpp>
 
+#include <random>
+#include <string>
+#include <algorithm>
+
 using namespace pomar;
 
 SCENARIO("Function isLowSizeType should indicates whether a type has low size or not.") {
@@ -58,4 +62,122 @@ SCENARIO("Counting sort should sort indexing.") {
       }
     }
   }
-}
\ No newline at end of file
+}
+SCENARIO("Radix sort should sort indexing.") {
+  GIVEN("An int vector with negative values (2,-5,3,0,2,-3,0,3).") {
+    std::vector<int> v = {2,-5,3,0,2,-3,0,3};
+    WHEN("increasingRadixSortIndex is called using v.") {
+      auto idx = increasingRadixSortIndex(v);
+      THEN("It should return (1,5,3,6,0,4,2,7).") {
+        REQUIRE(idx == std::vector<int>({1,5,3,6,0,4,2,7}));
+      }
+    }
+    WHEN("decreasingRadixSortIndex is called using v.") {
+      auto idx = decreasingRadixSortIndex(v);
+      THEN("It should return (2,7,0,4,3,6,5,1).") {
+        REQUIRE(idx == std::vector<int>({2,7,0,4,3,6,5,1}));
+      }
+    }
+  }
+  GIVEN("A float vector (0.5,-2.25,-0.0,1e10,0.0,-1e-10,0.5).") {
+    std::vector<float> v = {0.5f,-2.25f,-0.0f,1e10f,0.0f,-1e-10f,0.5f};
+    WHEN("increasingRadixSortIndex is called using v.") {
+      auto idx = increasingRadixSortIndex(v);
+      THEN("It should return (1,5,2,4,0,6,3).") {
+        REQUIRE(idx == std::vector<int>({1,5,2,4,0,6,3}));
+      }
+    }
+    WHEN("decreasingRadixSortIndex is called using v.") {
+      auto idx = decreasingRadixSortIndex(v);
+      THEN("It should return (3,0,6,2,4,5,1).") {
+        REQUIRE(idx == std::vector<int>({3,0,6,2,4,5,1}));
+      }
+    }
+  }
+  GIVEN("Random vectors of unsigned short, long long and double.") {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::vector<unsigned short> vus(5000); std::vector<long long> vll(5000); std::vector<double> vd(5000);
+    for (size_t i = 0; i < vus.size(); i++) {
+      auto r = dist(gen);
+      vus[i] = static_cast<unsigned short>(r * 60); vll[i] = r * 1000003LL; vd[i] = r / 7.0;
+    }
+    WHEN("They are sorted by increasingSortIndex and decreasingSortIndex.") {
+      THEN("The result should be the same of STLsortIndex (stable).") {
+        REQUIRE(increasingSortIndex(vus) == STLsortIndex<unsigned short>(vus, std::less<unsigned short>()));
+        REQUIRE(decreasingSortIndex(vus) == STLsortIndex<unsigned short>(vus, std::greater<unsigned short>()));
+        REQUIRE(increasingSortIndex(vll) == STLsortIndex<long long>(vll, std::less<long long>()));
+        REQUIRE(decreasingSortIndex(vll) == STLsortIndex<long long>(vll, std::greater<long long>()));
+        REQUIRE(increasingSortIndex(vd) == STLsortIndex<double>(vd, std::less<double>()));
+        REQUIRE(decreasingSortIndex(vd) == STLsortIndex<double>(vd, std::greater<double>()));
+      }
+    }
+  }
+}
+
+SCENARIO("Parallel counting and radix sorts should return the same indices as the sequential ones.") {
+  GIVEN("Random vectors of unsigned char, unsigned short, int and float with 300000 elements.") {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> dist(-40000, 40000);
+    const int n = 300000;
+    std::vector<unsigned char> vuc(n); std::vector<unsigned short> vus(n); 
+    std::vector<int> vi(n); std::vector<float> vf(n);
+    for (int i = 0; i < n; i++) {
+      auto r = dist(gen);
+      vuc[i] = static_cast<unsigned char>(r); vus[i] = static_cast<unsigned short>(r); 
+      vi[i] = r * 3; vf[i] = r / 3.0f;
+    }
+    for (int nthreads : {1, 2, 3, 4, 8}) {
+      WHEN("They are sorted using " + std::to_string(nthreads) + " threads.") {
+        THEN("The result should be the same of the sequential sort.") {
+          REQUIRE(increasingSortIndex(vuc, nthreads) == increasingSortIndex(vuc));
+          REQUIRE(decreasingSortIndex(vuc, nthreads) == decreasingSortIndex(vuc));
+          REQUIRE(increasingSortIndex(vus, nthreads) == increasingSortIndex(vus));
+          REQUIRE(decreasingSortIndex(vus, nthreads) == decreasingSortIndex(vus));
+          REQUIRE(increasingSortIndex(vi, nthreads) == increasingSortIndex(vi));
+          REQUIRE(decreasingSortIndex(vi, nthreads) == decreasingSortIndex(vi));
+          REQUIRE(increasingSortIndex(vf, nthreads) == increasingSortIndex(vf));
+          REQUIRE(decreasingSortIndex(vf, nthreads) == decreasingSortIndex(vf));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Index sorts should return the same order for 16 and 64-bit indices.") {
+  GIVEN("Random vectors of unsigned char, int and double.") {
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(-500, 500);
+    const int n = 20000;
+    std::vector<unsigned char> vuc(n); std::vector<int> vi(n); std::vector<double> vd(n);
+    for (int i = 0; i < n; i++) {
+      auto r = dist(gen);
+      vuc[i] = static_cast<unsigned char>(r); vi[i] = r; vd[i] = r / 3.0;
+    }
+    WHEN("They are sorted using short and long long indices.") {
+      THEN("The indices should be the same as the int ones.") {
+        auto equal = [](const std::vector<int> &expected, const std::vector<long long> &idx) {
+          return std::equal(expected.begin(), expected.end(), idx.begin());
+        };
+        REQUIRE(equal(increasingSortIndex(vuc), increasingSortIndex<unsigned char, long long>(vuc)));
+        REQUIRE(equal(decreasingSortIndex(vi), decreasingSortIndex<int, long long>(vi)));
+        REQUIRE(equal(increasingSortIndex(vd), increasingSortIndex<double, long long>(vd)));
+        REQUIRE(equal(increasingSortIndex(vi, 4), increasingSortIndex<int, long long>(vi, 4)));
+        auto sidx = decreasingSortIndex<unsigned char, short>(vuc);
+        REQUIRE(std::equal(sidx.begin(), sidx.end(), decreasingSortIndex(vuc).begin()));
+      }
+    }
+  }
+}
+
+SCENARIO("SortAlgorithm should resolve the sorting algorithm at compile time.") {
+  GIVEN("The default sort tag and explicit sort tags.") {
+    THEN("The default tag should resolve to SortStrategy and the explicit tags to themselves.") {
+      REQUIRE((std::is_same<SortAlgorithm<DefaultSortTag, unsigned short>::type, CountingSortTag>::value));
+      REQUIRE((std::is_same<SortAlgorithm<DefaultSortTag, int>::type, RadixSortTag>::value));
+      REQUIRE((std::is_same<SortAlgorithm<DefaultSortTag, float>::type, RadixSortTag>::value));
+      REQUIRE((std::is_same<SortAlgorithm<RadixSortTag, unsigned char>::type, RadixSortTag>::value));
+      REQUIRE((std::is_same<SortAlgorithm<ComparisonSortTag, double>::type, ComparisonSortTag>::value));
+    }
+  }
+}
@@ -0,0 +1,110 @@
+#include "../../catch.hpp"
+#include "../ComponentTree/CTreeCompare.hpp"
+#include <pomar/AdjacencyRelation/AdjacencyByTranslating.hpp>
+#include <pomar/Attribute/AttributeComputerBasic.hpp>
+#include <pomar/ComponentTree/CTBuilder.hpp>
+#include <pomar/ComponentTree/CompactCTree.hpp>
+#include <pomar/Filter/AttributeFilter.hpp>
+#include <algorithm>
+#include <memory>
+
+using namespace pomar;
+
+SCENARIO("AttributeFilter should apply the direct min max and subtractive decision rules.") {
+  GIVEN("The max-tree of the 7x1 image (0 2 1 2 0 3 0) and a criterion which removes the node at level 1 only") {
+    std::vector<unsigned char> f = { 0, 2, 1, 2, 0, 3, 0 };
+    CTBuilder builder;
+    auto ct = builder.build(std::make_shared<CTMetaImage2D>(7, 1, 1), f,
+      AdjacencyByTranslating2D::createAdjacency4(7, 1), CTBuilder::TreeType::MaxTree);
+    auto keep = [&ct](int id) { return ct.nodeLevel(id) != 1; };
+
+    WHEN("the image is filtered with the direct rule") {
+      auto out = AttributeFilter<unsigned char>(FilterRule::Direct).filter(ct, keep);
+      THEN("the pixels of the removed node get the level of the root") {
+        REQUIRE(out == std::vector<unsigned char>{0, 2, 0, 2, 0, 3, 0});
+      }
+    }
+    WHEN("the image is filtered with the min rule") {
+      auto out = AttributeFilter<unsigned char>(FilterRule::Min).filter(ct, keep);
+      THEN("the descendants of the removed node are removed too") {
+        REQUIRE(out == std::vector<unsigned char>{0, 0, 0, 0, 0, 3, 0});
+      }
+    }
+    WHEN("the image is filtered with the max rule") {
+      auto out = AttributeFilter<unsigned char>(FilterRule::Max).filter(ct, keep);
+      THEN("the node is kept because its descendants are kept") {
+        REQUIRE(out == f);
+      }
+    }
+    WHEN("the image is filtered with the subtractive rule") {
+      auto out = AttributeFilter<unsigned char>(FilterRule::Subtractive).filter(ct, keep);
+      THEN("the kept descendants are lowered by the contrast of the removed node") {
+        REQUIRE(out == std::vector<unsigned char>{0, 1, 0, 1, 0, 3, 0});
+      }
+    }
+    WHEN("the root does not satisfy the criterion") {
+      auto out = AttributeFilter<unsigned char>(FilterRule::Min).filter(ct, [](int) { return false; });
+      THEN("the root is kept and the image is flat") {
+        REQUIRE(out == std::vector<unsigned char>(7, 0));
+      }
+    }
+  }
+}
+
+SCENARIO("AttributeFilter should compute area openings and closings.") {
+  GIVEN("A random 12x10 image") {
+    const int width = 12, height = 10;
+    auto f = randomImage<unsigned char>(width, height, 7, 5);
+
+    for (auto treeType : {CTBuilder::TreeType::MaxTree, CTBuilder::TreeType::MinTree}) {
+      CTBuilder builder;
+      auto ct = builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+        AdjacencyByTranslating2D::createAdjacency8(width, height), treeType);
+      CompactCTree<unsigned char> cct(ct);
+      auto attrs = AreaAttributeComputer<unsigned char>().compute(ct);
+      auto area = attrs[attrs.attrIndex(AttrType::AREA)];
+
+      WHEN("the area filter with threshold 4 is computed with each rule") {
+        THEN("the direct, min and max rules give the area opening (closing)") {
+          // The area opening is the union (supremum) of the components whose area is at least 4.
+          std::vector<unsigned char> expected(f.size(), ct.nodeLevel(0));
+          for (std::size_t id = 0; id < ct.numberOfNodes(); ++id) {
+            if (area[id] < 4) continue;
+            for (auto p : ct.reconstructNode(id))
+              expected[p] = treeType == CTBuilder::TreeType::MaxTree ? std::max(expected[p], ct.nodeLevel(id)) : 
+                std::min(expected[p], ct.nodeLevel(id));
+          }
+          for (auto rule : {FilterRule::Direct, FilterRule::Min, FilterRule::Max, FilterRule::Subtractive}) {
+            auto out = AttributeFilter<unsigned char>(rule).filter(ct, area, 4);
+            REQUIRE(out == expected);
+            REQUIRE(AttributeFilter<unsigned char, CompactCTree<unsigned char>>(rule).filter(cct, area, 4) == out);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("AttributeFilter should write the filtered image into a caller buffer.") {
+  GIVEN("The max-tree of a random 40x30 image and its area") {
+    const int width = 40, height = 30;
+    auto f = randomImage<unsigned char>(width, height, 31, 13);
+    CTBuilder builder;
+    auto ct = builder.build(std::make_shared<CTMetaImage2D>(width, height, 1), f,
+      AdjacencyByTranslating2D::createAdjacency8(width, height), CTBuilder::TreeType::MaxTree);
+    auto attrs = AreaAttributeComputer<unsigned char>().compute(ct);
+    auto area = attrs[attrs.attrIndex(AttrType::AREA)];
+
+    WHEN("the area opening is written into a buffer with 1 and 3 threads") {
+      AttributeFilter<unsigned char> filter;
+      auto expected = filter.filter(ct, area, 10);
+      THEN("the buffer should be the filtered image") {
+        for (int nthreads : {1, 3}) {
+          std::vector<unsigned char> out(f.size(), 0);
+          filter.filter(ct, area, 10, out.data(), nthreads);
+          REQUIRE(out == expected);
+        }
+      }
+    }
+  }
+}
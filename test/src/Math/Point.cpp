@@ -69,3 +69,34 @@ SCENARIO("2D points arithmetics should be correctly") {
     }
   }
 }
+
+SCENARIO("3D points arithmetics should be correctly") {
+  GIVEN("The points p = (3,4,-1) and q = (-2,5,6)") {
+    IPoint3D p(3, 4, -1), q(-2, 5, 6);
+
+    WHEN("p == p and p == q are performed") {
+      THEN("they should be true and false") {
+        REQUIRE(p == p);
+        REQUIRE(!(p == q));
+      }
+    }
+    WHEN("r = p + q and r = p - q are performed") {
+      THEN("r should be equal to (1,9,5) and (5,-1,-7)") {
+        REQUIRE(p + q == IPoint3D(1,9,5));
+        REQUIRE(p - q == IPoint3D(5,-1,-7));
+      }
+    }
+    WHEN("p += q is performed") {
+      p += q;
+      THEN("p should be equal to (1,9,5)") {
+        REQUIRE(p == IPoint3D(1,9,5));
+      }
+    }
+    WHEN("r = p * 2 and r = p / 2 are performed") {
+      THEN("r should be equal to (6,8,-2) and (1,2,0)") {
+        REQUIRE(p * 2 == IPoint3D(6,8,-2));
+        REQUIRE(p / 2 == IPoint3D(1,2,0));
+      }
+    }
+  }
+}